@@ -0,0 +1,1543 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+// A minimal OpenXR runtime for benchmarking the tutorial without a headset.
+// The OpenXR loader finds it through XR_RUNTIME_JSON. It supports XR_KHR_vulkan_enable only: swapchain images are plain VkImages
+// on the application's device, so with lavapipe it renders entirely on the CPU. Nothing is composited or displayed.
+// The head and hands follow a scripted path that sweeps through the Chapter 5 blocks, and the grab and select inputs are
+// pressed on a fixed schedule, so that every run renders and interacts with the same scene.
+// After XR_MOCK_RUNTIME_FRAME_COUNT frames the runtime ends the session, and the application exits as it would if the user
+// had quit, writing its frame timings.
+//
+// Settings, from environment variables:
+//   XR_MOCK_RUNTIME_FRAME_COUNT    Frames to run before the session is ended. 0 runs forever. Default: 1000.
+//   XR_MOCK_RUNTIME_WIDTH/HEIGHT   Recommended size of each view. Default: 1024 x 1024.
+//   XR_MOCK_RUNTIME_REFRESH_RATE   Display refresh rate in Hz. Default: 90.
+//   XR_MOCK_RUNTIME_THROTTLE       If 1, xrWaitFrame() blocks until the next display refresh, as a real runtime would.
+//                                  By default frames run as fast as the application can render them.
+//   XR_MOCK_RUNTIME_VULKAN_DEVICE  Part of the name of the VkPhysicalDevice to use, e.g. "llvmpipe". Default: the first one.
+//
+// Only one instance and one session are supported, and like the tutorial, all calls are expected from one thread.
+
+#include <vulkan/vulkan.h>
+
+#define XR_NO_PROTOTYPES
+#define XR_USE_GRAPHICS_API_VULKAN
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+#include <openxr/openxr_reflection.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#define MOCK_RUNTIME_EXPORT extern "C" __declspec(dllexport)
+#else
+#define MOCK_RUNTIME_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+// Loader-runtime negotiation, from the OpenXR loader specification.
+// The OpenXR-SDK release used by the tutorial doesn't ship these in a public header yet.
+enum XrLoaderInterfaceStructs {
+    XR_LOADER_INTERFACE_STRUCT_UNINTIALIZED = 0,
+    XR_LOADER_INTERFACE_STRUCT_LOADER_INFO,
+    XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST,
+    XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST,
+    XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO,
+    XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO,
+};
+#define XR_LOADER_INFO_STRUCT_VERSION 1
+#define XR_RUNTIME_INFO_STRUCT_VERSION 1
+#define XR_CURRENT_LOADER_RUNTIME_VERSION 1
+
+struct XrNegotiateLoaderInfo {
+    XrLoaderInterfaceStructs structType;
+    uint32_t structVersion;
+    size_t structSize;
+    uint32_t minInterfaceVersion;
+    uint32_t maxInterfaceVersion;
+    XrVersion minApiVersion;
+    XrVersion maxApiVersion;
+};
+
+struct XrNegotiateRuntimeRequest {
+    XrLoaderInterfaceStructs structType;
+    uint32_t structVersion;
+    size_t structSize;
+    uint32_t runtimeInterfaceVersion;
+    XrVersion runtimeApiVersion;
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr;
+};
+
+#define MOCK_VULKAN_CHECK(x, y)                                                                                  \
+    {                                                                                                            \
+        VkResult vulkanResult = (x);                                                                             \
+        if (vulkanResult != VK_SUCCESS) {                                                                        \
+            std::cout << "ERROR: MOCK RUNTIME: " << int(vulkanResult) << "(" << #x << ") " << y << std::endl;     \
+            return XR_ERROR_RUNTIME_FAILURE;                                                                     \
+        }                                                                                                        \
+    }
+
+namespace {
+
+const XrSystemId systemId = 1;
+const XrViewConfigurationType viewConfiguration = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+const uint32_t viewCount = 2;
+const uint32_t swapchainImageCount = 3;
+const float interpupillaryDistance = 0.063f;
+const char *preferredInteractionProfile = "/interaction_profiles/oculus/touch_controller";
+
+const int64_t colorSwapchainFormats[] = {VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_UNORM};
+const int64_t depthSwapchainFormats[] = {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM};
+
+const char *const instanceExtensions[] = {
+    XR_KHR_VULKAN_ENABLE_EXTENSION_NAME,
+    XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME,
+    XR_EXT_DEBUG_UTILS_EXTENSION_NAME,
+    XR_EXT_HAND_TRACKING_EXTENSION_NAME,
+    XR_EXT_HAND_INTERACTION_EXTENSION_NAME};
+
+struct Settings {
+    uint64_t frameCount = 1000;
+    uint32_t width = 1024;
+    uint32_t height = 1024;
+    uint32_t refreshRate = 90;
+    bool throttle = false;
+    std::string vulkanDevice;
+};
+
+struct Space {
+    bool isActionSpace;
+    XrReferenceSpaceType referenceSpaceType;
+    XrPath subactionPath;
+    XrPosef poseInSpace;
+};
+
+struct Action {
+    XrActionType type;
+};
+
+struct Swapchain {
+    bool depth;
+    std::vector<VkImage> images;
+    std::vector<VkDeviceMemory> memories;
+    uint32_t nextImage;
+};
+
+// The scripted state of one hand's inputs, updated by xrSyncActions().
+struct HandInput {
+    float grab;
+    XrBool32 select;
+    XrBool32 grabChanged;
+    XrBool32 selectChanged;
+};
+
+struct Runtime {
+    Settings settings;
+    uint64_t nextHandle = 1;
+
+    uint64_t instance = 0;
+    std::deque<XrEventDataBuffer> events;
+    // XrPath n is paths[n - 1].
+    std::vector<std::string> paths;
+    std::unordered_map<std::string, XrPath> pathIds;
+    std::vector<XrPath> suggestedInteractionProfiles;
+    std::unordered_map<uint64_t, Action> actions;
+    std::vector<uint64_t> actionSets;
+    std::vector<uint64_t> debugUtilsMessengers;
+
+    uint64_t session = 0;
+    XrSessionState sessionState = XR_SESSION_STATE_UNKNOWN;
+    bool sessionRunning = false;
+    bool actionSetsAttached = false;
+    XrPath interactionProfile = XR_NULL_PATH;
+    XrGraphicsBindingVulkanKHR graphicsBinding = {XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR};
+    std::unordered_map<uint64_t, Space> spaces;
+    std::unordered_map<uint64_t, Swapchain> swapchains;
+    std::unordered_map<uint64_t, XrHandEXT> handTrackers;
+
+    // Frame loop.
+    bool frameWaited = false;
+    bool frameBegun = false;
+    uint64_t frameCount = 0;
+    XrTime startTime = 0;
+    XrTime predictedDisplayTime = 0;
+    std::chrono::steady_clock::time_point firstFrameBegin;
+    std::chrono::steady_clock::time_point lastFrameEnd;
+
+    HandInput handInputs[2] = {};
+    XrTime inputChangeTime[2] = {};
+};
+Runtime runtime;
+
+template <typename T>
+T ToHandle(uint64_t id) {
+    return (T)(id);
+}
+template <typename T>
+uint64_t FromHandle(T handle) {
+    return (uint64_t)(handle);
+}
+
+XrTime Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t GetEnvironmentUInt(const char *name, uint64_t defaultValue) {
+    const char *value = std::getenv(name);
+    return value && *value ? std::strtoull(value, nullptr, 10) : defaultValue;
+}
+
+XrDuration GetDisplayPeriod() {
+    return 1000000000 / std::max<XrDuration>(runtime.settings.refreshRate, 1);
+}
+
+template <typename T>
+XrResult Enumerate(const T *values, uint32_t count, uint32_t capacityInput, uint32_t *countOutput, T *output) {
+    if (!countOutput) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    *countOutput = count;
+    if (capacityInput == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacityInput < count) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        output[i] = values[i];
+    }
+    return XR_SUCCESS;
+}
+
+// Strings are enumerated as chars, including the null terminator.
+XrResult EnumerateString(const std::string &value, uint32_t capacityInput, uint32_t *countOutput, char *buffer) {
+    return Enumerate(value.c_str(), static_cast<uint32_t>(value.size() + 1), capacityInput, countOutput, buffer);
+}
+
+void PushEvent(const XrEventDataBuffer &event) {
+    runtime.events.push_back(event);
+}
+
+void SetSessionState(XrSessionState state) {
+    runtime.sessionState = state;
+    XrEventDataBuffer event = {XR_TYPE_EVENT_DATA_BUFFER};
+    XrEventDataSessionStateChanged *sessionStateChanged = reinterpret_cast<XrEventDataSessionStateChanged *>(&event);
+    *sessionStateChanged = {XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED};
+    sessionStateChanged->session = ToHandle<XrSession>(runtime.session);
+    sessionStateChanged->state = state;
+    sessionStateChanged->time = Now();
+    PushEvent(event);
+}
+
+void PushInteractionProfileChanged() {
+    XrEventDataBuffer event = {XR_TYPE_EVENT_DATA_BUFFER};
+    XrEventDataInteractionProfileChanged *interactionProfileChanged = reinterpret_cast<XrEventDataInteractionProfileChanged *>(&event);
+    *interactionProfileChanged = {XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED};
+    interactionProfileChanged->session = ToHandle<XrSession>(runtime.session);
+    PushEvent(event);
+}
+
+// Walks to the end of the session: FOCUSED -> VISIBLE -> SYNCHRONIZED -> STOPPING.
+void RequestSessionEnd() {
+    if (runtime.sessionState == XR_SESSION_STATE_FOCUSED) {
+        SetSessionState(XR_SESSION_STATE_VISIBLE);
+    }
+    if (runtime.sessionState == XR_SESSION_STATE_VISIBLE) {
+        SetSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    }
+    if (runtime.sessionState == XR_SESSION_STATE_SYNCHRONIZED) {
+        SetSessionState(XR_SESSION_STATE_STOPPING);
+    }
+}
+
+XrPath FindPath(const char *pathString) {
+    auto it = runtime.pathIds.find(pathString);
+    return it != runtime.pathIds.end() ? it->second : XR_NULL_PATH;
+}
+
+XrPath GetPath(const std::string &pathString) {
+    auto it = runtime.pathIds.find(pathString);
+    if (it != runtime.pathIds.end()) {
+        return it->second;
+    }
+    runtime.paths.push_back(pathString);
+    const XrPath path = static_cast<XrPath>(runtime.paths.size());
+    runtime.pathIds[pathString] = path;
+    return path;
+}
+
+// 0 for the left hand, 1 for the right hand, and -1 for any other subaction path.
+int GetHand(XrPath subactionPath) {
+    if (subactionPath != XR_NULL_PATH && subactionPath == FindPath("/user/hand/left")) {
+        return 0;
+    }
+    if (subactionPath != XR_NULL_PATH && subactionPath == FindPath("/user/hand/right")) {
+        return 1;
+    }
+    return -1;
+}
+
+bool IsSessionFocused() {
+    return runtime.sessionState == XR_SESSION_STATE_FOCUSED;
+}
+
+// Pose math: a pose maps from its own space to its parent's.
+XrQuaternionf Multiply(const XrQuaternionf &a, const XrQuaternionf &b) {
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+XrVector3f Rotate(const XrQuaternionf &q, const XrVector3f &v) {
+    const XrQuaternionf p = Multiply(Multiply(q, {v.x, v.y, v.z, 0.0f}), {-q.x, -q.y, -q.z, q.w});
+    return {p.x, p.y, p.z};
+}
+
+XrPosef Compose(const XrPosef &parent, const XrPosef &child) {
+    const XrVector3f position = Rotate(parent.orientation, child.position);
+    return {Multiply(parent.orientation, child.orientation), {parent.position.x + position.x, parent.position.y + position.y, parent.position.z + position.z}};
+}
+
+XrPosef Invert(const XrPosef &pose) {
+    const XrQuaternionf orientation = {-pose.orientation.x, -pose.orientation.y, -pose.orientation.z, pose.orientation.w};
+    const XrVector3f position = Rotate(orientation, pose.position);
+    return {orientation, {-position.x, -position.y, -position.z}};
+}
+
+XrQuaternionf AxisAngle(const XrVector3f &axis, float angle) {
+    const float s = std::sin(angle * 0.5f);
+    return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+}
+
+// Seconds since the session began, on the scripted timeline.
+double GetScriptTime(XrTime time) {
+    return static_cast<double>(time - runtime.startTime) * 1e-9;
+}
+
+// The scripted head pose in LOCAL space: a slow sway around the origin.
+XrPosef GetHeadPose(XrTime time) {
+    const double t = GetScriptTime(time);
+    XrPosef pose;
+    pose.orientation = AxisAngle({0.0f, 1.0f, 0.0f}, 0.15f * float(std::sin(0.3 * t)));
+    pose.position = {0.02f * float(std::sin(0.5 * t)), 0.01f * float(std::sin(0.7 * t)), 0.0f};
+    return pose;
+}
+
+// The scripted palm pose in LOCAL space. Each hand sweeps through the 80cm cube of blocks in front of the viewer,
+// which Chapter 5 centers at (0, -0.2, -0.7).
+XrPosef GetHandPose(int hand, XrTime time) {
+    const double t = GetScriptTime(time);
+    const double side = hand == 0 ? -1.0 : 1.0;
+    XrPosef pose;
+    pose.orientation = AxisAngle({1.0f, 0.0f, 0.0f}, 0.3f * float(std::sin(0.8 * t + hand)));
+    pose.position.x = float(0.15 * side + 0.2 * std::sin(0.6 * t + hand * 1.57));
+    pose.position.y = float(-0.2 + 0.25 * std::sin(0.9 * t + hand));
+    pose.position.z = float(-0.7 + 0.25 * std::sin(0.4 * t + hand * 0.5));
+    return pose;
+}
+
+// Grab is held for 1.5s of every 3s, and select clicked every 2s, with the right hand a little behind the left.
+HandInput GetHandInput(int hand, XrTime time) {
+    const double t = GetScriptTime(time);
+    HandInput input = {};
+    input.grab = std::fmod(t + 0.75 * hand, 3.0) < 1.5 ? 1.0f : 0.0f;
+    input.select = std::fmod(t + 0.4 * hand, 2.0) < 0.2 ? XR_TRUE : XR_FALSE;
+    return input;
+}
+
+// The pose of a space in LOCAL space.
+XrPosef GetSpacePose(const Space &space, XrTime time) {
+    XrPosef origin = {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}};
+    if (space.isActionSpace) {
+        const int hand = GetHand(space.subactionPath);
+        origin = GetHandPose(hand < 0 ? 1 : hand, time);
+    } else if (space.referenceSpaceType == XR_REFERENCE_SPACE_TYPE_VIEW) {
+        origin = GetHeadPose(time);
+    } else if (space.referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE) {
+        // The floor, 1.5m below the viewer's starting position.
+        origin.position.y = -1.5f;
+    }
+    return Compose(origin, space.poseInSpace);
+}
+
+// The hand joints relative to the palm: the wrist behind it and five fingers of straight joints in front of it.
+void GetHandJointOffset(int hand, uint32_t joint, XrVector3f &position, float &radius) {
+    const float side = hand == 0 ? -1.0f : 1.0f;
+    if (joint == XR_HAND_JOINT_PALM_EXT) {
+        position = {0.0f, 0.0f, 0.0f};
+        radius = 0.02f;
+        return;
+    }
+    if (joint == XR_HAND_JOINT_WRIST_EXT) {
+        position = {0.0f, 0.0f, 0.07f};
+        radius = 0.02f;
+        return;
+    }
+    // The thumb has four joints and the other fingers have five.
+    const uint32_t finger = joint < XR_HAND_JOINT_INDEX_METACARPAL_EXT ? 0 : 1 + (joint - XR_HAND_JOINT_INDEX_METACARPAL_EXT) / 5;
+    const uint32_t bone = finger == 0 ? joint - XR_HAND_JOINT_THUMB_METACARPAL_EXT : (joint - XR_HAND_JOINT_INDEX_METACARPAL_EXT) % 5;
+    const float fingerX[5] = {0.045f, 0.025f, 0.005f, -0.015f, -0.035f};
+    position = {side * fingerX[finger], 0.0f, 0.04f - 0.025f * float(bone)};
+    radius = 0.01f - 0.001f * float(bone);
+}
+
+bool IsFormatSupported(int64_t format, bool &depth) {
+    for (int64_t colorFormat : colorSwapchainFormats) {
+        if (format == colorFormat) {
+            depth = false;
+            return true;
+        }
+    }
+    for (int64_t depthFormat : depthSwapchainFormats) {
+        if (format == depthFormat) {
+            depth = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DestroySwapchainImages(Swapchain &swapchain) {
+    VkDevice device = runtime.graphicsBinding.device;
+    for (VkImage image : swapchain.images) {
+        vkDestroyImage(device, image, nullptr);
+    }
+    for (VkDeviceMemory memory : swapchain.memories) {
+        vkFreeMemory(device, memory, nullptr);
+    }
+    swapchain.images.clear();
+    swapchain.memories.clear();
+}
+
+// XR_KHR_vulkan_enable requires the images to be in the attachment layout when they are acquired. Nothing here changes
+// their layout afterwards, so they are transitioned once when they are created.
+XrResult TransitionSwapchainImages(const Swapchain &swapchain) {
+    VkDevice device = runtime.graphicsBinding.device;
+    VkQueue queue = VK_NULL_HANDLE;
+    vkGetDeviceQueue(device, runtime.graphicsBinding.queueFamilyIndex, runtime.graphicsBinding.queueIndex, &queue);
+
+    VkCommandPoolCreateInfo commandPoolCI = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    commandPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    commandPoolCI.queueFamilyIndex = runtime.graphicsBinding.queueFamilyIndex;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    MOCK_VULKAN_CHECK(vkCreateCommandPool(device, &commandPoolCI, nullptr, &commandPool), "Failed to create CommandPool.");
+
+    VkCommandBufferAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocateInfo.commandPool = commandPool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = 1;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkResult result = vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer);
+
+    if (result == VK_SUCCESS) {
+        VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        for (VkImage image : swapchain.images) {
+            VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = swapchain.depth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = swapchain.depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange = {VkImageAspectFlags(swapchain.depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+        vkEndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+        if (result == VK_SUCCESS) {
+            result = vkQueueWaitIdle(queue);
+        }
+    }
+    vkDestroyCommandPool(device, commandPool, nullptr);
+    MOCK_VULKAN_CHECK(result, "Failed to transition Swapchain Images.");
+    return XR_SUCCESS;
+}
+
+XrResult CreateSwapchainImages(const XrSwapchainCreateInfo &createInfo, Swapchain &swapchain) {
+    VkDevice device = runtime.graphicsBinding.device;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(runtime.graphicsBinding.physicalDevice, &memoryProperties);
+
+    VkImageCreateInfo imageCI = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    imageCI.flags = createInfo.faceCount == 6 ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+    imageCI.imageType = VK_IMAGE_TYPE_2D;
+    imageCI.format = static_cast<VkFormat>(createInfo.format);
+    imageCI.extent = {createInfo.width, createInfo.height, 1};
+    imageCI.mipLevels = std::max(createInfo.mipCount, 1u);
+    imageCI.arrayLayers = std::max(createInfo.arraySize, 1u) * std::max(createInfo.faceCount, 1u);
+    imageCI.samples = static_cast<VkSampleCountFlagBits>(std::max(createInfo.sampleCount, 1u));
+    imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // Clears are transfers, so they are always allowed.
+    imageCI.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageCI.usage |= swapchain.depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (createInfo.usageFlags & XR_SWAPCHAIN_USAGE_SAMPLED_BIT) {
+        imageCI.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    }
+    if (createInfo.usageFlags & XR_SWAPCHAIN_USAGE_UNORDERED_ACCESS_BIT) {
+        imageCI.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+    imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    for (uint32_t i = 0; i < swapchainImageCount; i++) {
+        VkImage image = VK_NULL_HANDLE;
+        MOCK_VULKAN_CHECK(vkCreateImage(device, &imageCI, nullptr, &image), "Failed to create Swapchain Image.");
+        swapchain.images.push_back(image);
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(device, image, &memoryRequirements);
+        uint32_t memoryTypeIndex = VK_MAX_MEMORY_TYPES;
+        for (uint32_t j = 0; j < memoryProperties.memoryTypeCount; j++) {
+            if ((memoryRequirements.memoryTypeBits & (1u << j)) == 0) {
+                continue;
+            }
+            if (memoryTypeIndex == VK_MAX_MEMORY_TYPES || (memoryProperties.memoryTypes[j].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0) {
+                memoryTypeIndex = j;
+            }
+            if ((memoryProperties.memoryTypes[j].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0) {
+                break;
+            }
+        }
+        VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocateInfo.allocationSize = memoryRequirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        MOCK_VULKAN_CHECK(vkAllocateMemory(device, &allocateInfo, nullptr, &memory), "Failed to allocate Swapchain Image memory.");
+        swapchain.memories.push_back(memory);
+        MOCK_VULKAN_CHECK(vkBindImageMemory(device, image, memory, 0), "Failed to bind Swapchain Image memory.");
+    }
+    return TransitionSwapchainImages(swapchain);
+}
+
+#define MOCK_CHECK_INSTANCE(handle)                                        \
+    if (runtime.instance == 0 || FromHandle(handle) != runtime.instance) { \
+        return XR_ERROR_HANDLE_INVALID;                                    \
+    }
+#define MOCK_CHECK_SYSTEM(id)           \
+    if ((id) != systemId) {             \
+        return XR_ERROR_SYSTEM_INVALID; \
+    }
+#define MOCK_CHECK_SESSION(handle)                                       \
+    if (runtime.session == 0 || FromHandle(handle) != runtime.session) { \
+        return XR_ERROR_HANDLE_INVALID;                                  \
+    }
+
+// Instance
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateInstanceExtensionProperties(const char *layerName, uint32_t propertyCapacityInput, uint32_t *propertyCountOutput, XrExtensionProperties *properties) {
+    if (layerName != nullptr) {
+        return XR_ERROR_API_LAYER_NOT_PRESENT;
+    }
+    std::vector<XrExtensionProperties> extensionProperties;
+    for (const char *extension : instanceExtensions) {
+        XrExtensionProperties extensionProperty = {XR_TYPE_EXTENSION_PROPERTIES};
+        strncpy(extensionProperty.extensionName, extension, XR_MAX_EXTENSION_NAME_SIZE - 1);
+        extensionProperty.extensionVersion = 1;
+        extensionProperties.push_back(extensionProperty);
+    }
+    return Enumerate(extensionProperties.data(), static_cast<uint32_t>(extensionProperties.size()), propertyCapacityInput, propertyCountOutput, properties);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateInstance(const XrInstanceCreateInfo *createInfo, XrInstance *instance) {
+    if (runtime.instance != 0) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+    for (uint32_t i = 0; i < createInfo->enabledExtensionCount; i++) {
+        bool found = false;
+        for (const char *extension : instanceExtensions) {
+            found |= strcmp(createInfo->enabledExtensionNames[i], extension) == 0;
+        }
+        if (!found) {
+            return XR_ERROR_EXTENSION_NOT_PRESENT;
+        }
+    }
+
+    Settings &settings = runtime.settings;
+    settings.frameCount = GetEnvironmentUInt("XR_MOCK_RUNTIME_FRAME_COUNT", settings.frameCount);
+    settings.width = static_cast<uint32_t>(GetEnvironmentUInt("XR_MOCK_RUNTIME_WIDTH", settings.width));
+    settings.height = static_cast<uint32_t>(GetEnvironmentUInt("XR_MOCK_RUNTIME_HEIGHT", settings.height));
+    settings.refreshRate = static_cast<uint32_t>(GetEnvironmentUInt("XR_MOCK_RUNTIME_REFRESH_RATE", settings.refreshRate));
+    settings.throttle = GetEnvironmentUInt("XR_MOCK_RUNTIME_THROTTLE", 0) != 0;
+    const char *vulkanDevice = std::getenv("XR_MOCK_RUNTIME_VULKAN_DEVICE");
+    settings.vulkanDevice = vulkanDevice ? vulkanDevice : "";
+
+    runtime.instance = runtime.nextHandle++;
+    *instance = ToHandle<XrInstance>(runtime.instance);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyInstance(XrInstance instance) {
+    MOCK_CHECK_INSTANCE(instance);
+    runtime = Runtime();
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProperties(XrInstance instance, XrInstanceProperties *instanceProperties) {
+    MOCK_CHECK_INSTANCE(instance);
+    instanceProperties->runtimeVersion = XR_MAKE_VERSION(1, 0, 0);
+    strncpy(instanceProperties->runtimeName, "OpenXR Tutorial Mock Runtime", XR_MAX_RUNTIME_NAME_SIZE - 1);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockPollEvent(XrInstance instance, XrEventDataBuffer *eventData) {
+    MOCK_CHECK_INSTANCE(instance);
+    if (runtime.events.empty()) {
+        return XR_EVENT_UNAVAILABLE;
+    }
+    *eventData = runtime.events.front();
+    runtime.events.pop_front();
+    return XR_SUCCESS;
+}
+
+template <typename T>
+struct EnumName {
+    T value;
+    const char *name;
+};
+#define MOCK_ENUM_NAME(name, value) {name, #name},
+const EnumName<XrResult> resultNames[] = {XR_LIST_ENUM_XrResult(MOCK_ENUM_NAME)};
+const EnumName<XrStructureType> structureTypeNames[] = {XR_LIST_ENUM_XrStructureType(MOCK_ENUM_NAME)};
+#undef MOCK_ENUM_NAME
+
+XRAPI_ATTR XrResult XRAPI_CALL MockResultToString(XrInstance instance, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE]) {
+    MOCK_CHECK_INSTANCE(instance);
+    for (const EnumName<XrResult> &resultName : resultNames) {
+        if (resultName.value == value) {
+            strncpy(buffer, resultName.name, XR_MAX_RESULT_STRING_SIZE - 1);
+            buffer[XR_MAX_RESULT_STRING_SIZE - 1] = '\0';
+            return XR_SUCCESS;
+        }
+    }
+    snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "XR_%s_%d", XR_SUCCEEDED(value) ? "UNKNOWN_SUCCESS" : "UNKNOWN_FAILURE", int(value));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockStructureTypeToString(XrInstance instance, XrStructureType value, char buffer[XR_MAX_STRUCTURE_NAME_SIZE]) {
+    MOCK_CHECK_INSTANCE(instance);
+    for (const EnumName<XrStructureType> &structureTypeName : structureTypeNames) {
+        if (structureTypeName.value == value) {
+            strncpy(buffer, structureTypeName.name, XR_MAX_STRUCTURE_NAME_SIZE - 1);
+            buffer[XR_MAX_STRUCTURE_NAME_SIZE - 1] = '\0';
+            return XR_SUCCESS;
+        }
+    }
+    snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "XR_UNKNOWN_STRUCTURE_TYPE_%d", int(value));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockStringToPath(XrInstance instance, const char *pathString, XrPath *path) {
+    MOCK_CHECK_INSTANCE(instance);
+    if (!pathString || pathString[0] != '/' || strlen(pathString) >= XR_MAX_PATH_LENGTH) {
+        return XR_ERROR_PATH_FORMAT_INVALID;
+    }
+    *path = GetPath(pathString);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer) {
+    MOCK_CHECK_INSTANCE(instance);
+    if (path == XR_NULL_PATH || path > runtime.paths.size()) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    return EnumerateString(runtime.paths[path - 1], bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+// System
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetSystem(XrInstance instance, const XrSystemGetInfo *getInfo, XrSystemId *id) {
+    MOCK_CHECK_INSTANCE(instance);
+    if (getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY) {
+        return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+    }
+    *id = systemId;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetSystemProperties(XrInstance instance, XrSystemId id, XrSystemProperties *properties) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    properties->systemId = systemId;
+    properties->vendorId = 0;
+    strncpy(properties->systemName, "OpenXR Tutorial Mock HMD", XR_MAX_SYSTEM_NAME_SIZE - 1);
+    properties->graphicsProperties.maxSwapchainImageWidth = 4096;
+    properties->graphicsProperties.maxSwapchainImageHeight = 4096;
+    properties->graphicsProperties.maxLayerCount = XR_MIN_COMPOSITION_LAYERS_SUPPORTED;
+    properties->trackingProperties.orientationTracking = XR_TRUE;
+    properties->trackingProperties.positionTracking = XR_TRUE;
+    for (XrBaseOutStructure *next = reinterpret_cast<XrBaseOutStructure *>(properties->next); next; next = next->next) {
+        if (next->type == XR_TYPE_SYSTEM_HAND_TRACKING_PROPERTIES_EXT) {
+            reinterpret_cast<XrSystemHandTrackingPropertiesEXT *>(next)->supportsHandTracking = XR_TRUE;
+        }
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateViewConfigurations(XrInstance instance, XrSystemId id, uint32_t viewConfigurationTypeCapacityInput, uint32_t *viewConfigurationTypeCountOutput, XrViewConfigurationType *viewConfigurationTypes) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    return Enumerate(&viewConfiguration, 1, viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetViewConfigurationProperties(XrInstance instance, XrSystemId id, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties *configurationProperties) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    if (viewConfigurationType != viewConfiguration) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    configurationProperties->viewConfigurationType = viewConfiguration;
+    configurationProperties->fovMutable = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateViewConfigurationViews(XrInstance instance, XrSystemId id, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t *viewCountOutput, XrViewConfigurationView *views) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    if (viewConfigurationType != viewConfiguration) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    XrViewConfigurationView view = {XR_TYPE_VIEW_CONFIGURATION_VIEW};
+    view.recommendedImageRectWidth = runtime.settings.width;
+    view.maxImageRectWidth = 4096;
+    view.recommendedImageRectHeight = runtime.settings.height;
+    view.maxImageRectHeight = 4096;
+    view.recommendedSwapchainSampleCount = 1;
+    view.maxSwapchainSampleCount = 4;
+    const XrViewConfigurationView configurationViews[viewCount] = {view, view};
+    return Enumerate(configurationViews, viewCount, viewCapacityInput, viewCountOutput, views);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateEnvironmentBlendModes(XrInstance instance, XrSystemId id, XrViewConfigurationType viewConfigurationType, uint32_t environmentBlendModeCapacityInput, uint32_t *environmentBlendModeCountOutput, XrEnvironmentBlendMode *environmentBlendModes) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    if (viewConfigurationType != viewConfiguration) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    const XrEnvironmentBlendMode environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+    return Enumerate(&environmentBlendMode, 1, environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes);
+}
+
+// XR_KHR_vulkan_enable
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanInstanceExtensionsKHR(XrInstance instance, XrSystemId id, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    // Nothing is shared with another process or device, so no extensions are needed.
+    return EnumerateString("", bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanDeviceExtensionsKHR(XrInstance instance, XrSystemId id, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    return EnumerateString("", bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsRequirementsKHR(XrInstance instance, XrSystemId id, XrGraphicsRequirementsVulkanKHR *graphicsRequirements) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION(1, 0, 0);
+    graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION(1, 3, 0);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsDeviceKHR(XrInstance instance, XrSystemId id, VkInstance vkInstance, VkPhysicalDevice *vkPhysicalDevice) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(id);
+    uint32_t physicalDeviceCount = 0;
+    MOCK_VULKAN_CHECK(vkEnumeratePhysicalDevices(vkInstance, &physicalDeviceCount, nullptr), "Failed to enumerate PhysicalDevices.");
+    std::vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
+    MOCK_VULKAN_CHECK(vkEnumeratePhysicalDevices(vkInstance, &physicalDeviceCount, physicalDevices.data()), "Failed to enumerate PhysicalDevices.");
+    if (physicalDevices.empty()) {
+        std::cout << "ERROR: MOCK RUNTIME: No Vulkan PhysicalDevices found." << std::endl;
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+
+    *vkPhysicalDevice = physicalDevices[0];
+    for (VkPhysicalDevice physicalDevice : physicalDevices) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        if (!runtime.settings.vulkanDevice.empty() && strstr(properties.deviceName, runtime.settings.vulkanDevice.c_str())) {
+            *vkPhysicalDevice = physicalDevice;
+            break;
+        }
+    }
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(*vkPhysicalDevice, &properties);
+    std::cout << "Mock runtime: rendering on " << properties.deviceName << std::endl;
+    return XR_SUCCESS;
+}
+
+// Session
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo, XrSession *session) {
+    MOCK_CHECK_INSTANCE(instance);
+    MOCK_CHECK_SYSTEM(createInfo->systemId);
+    if (runtime.session != 0) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+    const XrGraphicsBindingVulkanKHR *graphicsBinding = nullptr;
+    for (const XrBaseInStructure *next = reinterpret_cast<const XrBaseInStructure *>(createInfo->next); next; next = next->next) {
+        if (next->type == XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR) {
+            graphicsBinding = reinterpret_cast<const XrGraphicsBindingVulkanKHR *>(next);
+        }
+    }
+    if (!graphicsBinding || graphicsBinding->device == VK_NULL_HANDLE) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+    runtime.graphicsBinding = *graphicsBinding;
+    runtime.graphicsBinding.next = nullptr;
+
+    runtime.session = runtime.nextHandle++;
+    *session = ToHandle<XrSession>(runtime.session);
+    SetSessionState(XR_SESSION_STATE_IDLE);
+    SetSessionState(XR_SESSION_STATE_READY);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroySession(XrSession session) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.swapchains.empty()) {
+        vkDeviceWaitIdle(runtime.graphicsBinding.device);
+        for (auto &swapchain : runtime.swapchains) {
+            DestroySwapchainImages(swapchain.second);
+        }
+    }
+    runtime.swapchains.clear();
+    runtime.spaces.clear();
+    runtime.handTrackers.clear();
+    runtime.session = 0;
+    runtime.sessionState = XR_SESSION_STATE_UNKNOWN;
+    runtime.sessionRunning = false;
+    runtime.actionSetsAttached = false;
+    runtime.interactionProfile = XR_NULL_PATH;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockBeginSession(XrSession session, const XrSessionBeginInfo *beginInfo) {
+    MOCK_CHECK_SESSION(session);
+    if (beginInfo->primaryViewConfigurationType != viewConfiguration) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    if (runtime.sessionRunning) {
+        return XR_ERROR_SESSION_RUNNING;
+    }
+    if (runtime.sessionState != XR_SESSION_STATE_READY) {
+        return XR_ERROR_SESSION_NOT_READY;
+    }
+    runtime.sessionRunning = true;
+    runtime.frameCount = 0;
+    runtime.startTime = Now();
+    runtime.predictedDisplayTime = runtime.startTime;
+    SetSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    SetSessionState(XR_SESSION_STATE_VISIBLE);
+    SetSessionState(XR_SESSION_STATE_FOCUSED);
+    if (runtime.actionSetsAttached) {
+        PushInteractionProfileChanged();
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEndSession(XrSession session) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.sessionRunning) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (runtime.sessionState != XR_SESSION_STATE_STOPPING) {
+        return XR_ERROR_SESSION_NOT_STOPPING;
+    }
+    runtime.sessionRunning = false;
+    runtime.frameWaited = false;
+    runtime.frameBegun = false;
+
+    if (runtime.frameCount > 0) {
+        const double seconds = std::chrono::duration<double>(runtime.lastFrameEnd - runtime.firstFrameBegin).count();
+        std::cout << "Mock runtime: " << runtime.frameCount << " frames in " << seconds << " s, "
+                  << (seconds > 0.0 ? double(runtime.frameCount) / seconds : 0.0) << " frames per second." << std::endl;
+    }
+
+    SetSessionState(XR_SESSION_STATE_IDLE);
+    SetSessionState(XR_SESSION_STATE_EXITING);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockRequestExitSession(XrSession session) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.sessionRunning) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    RequestSessionEnd();
+    return XR_SUCCESS;
+}
+
+// Spaces
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateReferenceSpaces(XrSession session, uint32_t spaceCapacityInput, uint32_t *spaceCountOutput, XrReferenceSpaceType *spaces) {
+    MOCK_CHECK_SESSION(session);
+    const XrReferenceSpaceType referenceSpaceTypes[] = {XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL, XR_REFERENCE_SPACE_TYPE_STAGE};
+    return Enumerate(referenceSpaceTypes, 3, spaceCapacityInput, spaceCountOutput, spaces);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo *createInfo, XrSpace *space) {
+    MOCK_CHECK_SESSION(session);
+    if (createInfo->referenceSpaceType != XR_REFERENCE_SPACE_TYPE_VIEW && createInfo->referenceSpaceType != XR_REFERENCE_SPACE_TYPE_LOCAL && createInfo->referenceSpaceType != XR_REFERENCE_SPACE_TYPE_STAGE) {
+        return XR_ERROR_REFERENCE_SPACE_UNSUPPORTED;
+    }
+    const uint64_t id = runtime.nextHandle++;
+    runtime.spaces[id] = {false, createInfo->referenceSpaceType, XR_NULL_PATH, createInfo->poseInReferenceSpace};
+    *space = ToHandle<XrSpace>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetReferenceSpaceBoundsRect(XrSession session, XrReferenceSpaceType referenceSpaceType, XrExtent2Df *bounds) {
+    MOCK_CHECK_SESSION(session);
+    *bounds = {0.0f, 0.0f};
+    return XR_SPACE_BOUNDS_UNAVAILABLE;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo *createInfo, XrSpace *space) {
+    MOCK_CHECK_SESSION(session);
+    auto action = runtime.actions.find(FromHandle(createInfo->action));
+    if (action == runtime.actions.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (action->second.type != XR_ACTION_TYPE_POSE_INPUT) {
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
+    }
+    const uint64_t id = runtime.nextHandle++;
+    runtime.spaces[id] = {true, XR_REFERENCE_SPACE_TYPE_MAX_ENUM, createInfo->subactionPath, createInfo->poseInActionSpace};
+    *space = ToHandle<XrSpace>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation *location) {
+    auto it = runtime.spaces.find(FromHandle(space));
+    auto baseIt = runtime.spaces.find(FromHandle(baseSpace));
+    if (it == runtime.spaces.end() || baseIt == runtime.spaces.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (time <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    // Action spaces are only tracked while their actions are active.
+    if ((it->second.isActionSpace || baseIt->second.isActionSpace) && !(runtime.actionSetsAttached && IsSessionFocused())) {
+        location->locationFlags = 0;
+        return XR_SUCCESS;
+    }
+    location->pose = Compose(Invert(GetSpacePose(baseIt->second, time)), GetSpacePose(it->second, time));
+    location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroySpace(XrSpace space) {
+    return runtime.spaces.erase(FromHandle(space)) ? XR_SUCCESS : XR_ERROR_HANDLE_INVALID;
+}
+
+// Swapchains
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput, uint32_t *formatCountOutput, int64_t *formats) {
+    MOCK_CHECK_SESSION(session);
+    std::vector<int64_t> swapchainFormats(std::begin(colorSwapchainFormats), std::end(colorSwapchainFormats));
+    swapchainFormats.insert(swapchainFormats.end(), std::begin(depthSwapchainFormats), std::end(depthSwapchainFormats));
+    return Enumerate(swapchainFormats.data(), static_cast<uint32_t>(swapchainFormats.size()), formatCapacityInput, formatCountOutput, formats);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateSwapchain(XrSession session, const XrSwapchainCreateInfo *createInfo, XrSwapchain *swapchain) {
+    MOCK_CHECK_SESSION(session);
+    Swapchain newSwapchain = {};
+    if (!IsFormatSupported(createInfo->format, newSwapchain.depth)) {
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+    if (createInfo->width == 0 || createInfo->height == 0 || createInfo->width > 4096 || createInfo->height > 4096) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const XrResult result = CreateSwapchainImages(*createInfo, newSwapchain);
+    if (XR_FAILED(result)) {
+        DestroySwapchainImages(newSwapchain);
+        return result;
+    }
+    const uint64_t id = runtime.nextHandle++;
+    runtime.swapchains[id] = newSwapchain;
+    *swapchain = ToHandle<XrSwapchain>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroySwapchain(XrSwapchain swapchain) {
+    auto it = runtime.swapchains.find(FromHandle(swapchain));
+    if (it == runtime.swapchains.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    // The application may still have rendering in flight to the images.
+    vkDeviceWaitIdle(runtime.graphicsBinding.device);
+    DestroySwapchainImages(it->second);
+    runtime.swapchains.erase(it);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t *imageCountOutput, XrSwapchainImageBaseHeader *images) {
+    auto it = runtime.swapchains.find(FromHandle(swapchain));
+    if (it == runtime.swapchains.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    const std::vector<VkImage> &swapchainImages = it->second.images;
+    *imageCountOutput = static_cast<uint32_t>(swapchainImages.size());
+    if (imageCapacityInput == 0) {
+        return XR_SUCCESS;
+    }
+    if (imageCapacityInput < swapchainImages.size()) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    if (images[0].type != XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    XrSwapchainImageVulkanKHR *vulkanImages = reinterpret_cast<XrSwapchainImageVulkanKHR *>(images);
+    for (size_t i = 0; i < swapchainImages.size(); i++) {
+        vulkanImages[i].image = swapchainImages[i];
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo *acquireInfo, uint32_t *index) {
+    auto it = runtime.swapchains.find(FromHandle(swapchain));
+    if (it == runtime.swapchains.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    *index = it->second.nextImage;
+    it->second.nextImage = (it->second.nextImage + 1) % swapchainImageCount;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo *waitInfo) {
+    // Nothing reads the images, so they are always ready to be rendered to.
+    return runtime.swapchains.count(FromHandle(swapchain)) ? XR_SUCCESS : XR_ERROR_HANDLE_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo *releaseInfo) {
+    return runtime.swapchains.count(FromHandle(swapchain)) ? XR_SUCCESS : XR_ERROR_HANDLE_INVALID;
+}
+
+// Frames
+
+XRAPI_ATTR XrResult XRAPI_CALL MockWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo, XrFrameState *frameState) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.sessionRunning) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    const XrDuration displayPeriod = GetDisplayPeriod();
+    if (runtime.settings.throttle) {
+        // Block until the next refresh, and predict that the frame is displayed at the one after.
+        const XrTime now = Now();
+        const XrTime nextRefresh = runtime.startTime + ((now - runtime.startTime) / displayPeriod + 1) * displayPeriod;
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nextRefresh - now));
+        runtime.predictedDisplayTime = std::max(nextRefresh + displayPeriod, runtime.predictedDisplayTime + displayPeriod);
+    } else {
+        // Unthrottled, the display times are on a fixed timeline, so that every run sees the same poses and inputs.
+        runtime.predictedDisplayTime += displayPeriod;
+    }
+    runtime.frameWaited = true;
+    frameState->predictedDisplayTime = runtime.predictedDisplayTime;
+    frameState->predictedDisplayPeriod = displayPeriod;
+    frameState->shouldRender = runtime.sessionState == XR_SESSION_STATE_VISIBLE || runtime.sessionState == XR_SESSION_STATE_FOCUSED;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockBeginFrame(XrSession session, const XrFrameBeginInfo *frameBeginInfo) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.sessionRunning) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (!runtime.frameWaited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    const XrResult result = runtime.frameBegun ? XR_FRAME_DISCARDED : XR_SUCCESS;
+    if (runtime.frameCount == 0 && !runtime.frameBegun) {
+        runtime.firstFrameBegin = std::chrono::steady_clock::now();
+    }
+    runtime.frameWaited = false;
+    runtime.frameBegun = true;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEndFrame(XrSession session, const XrFrameEndInfo *frameEndInfo) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.sessionRunning) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (!runtime.frameBegun) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    if (frameEndInfo->environmentBlendMode != XR_ENVIRONMENT_BLEND_MODE_OPAQUE) {
+        return XR_ERROR_ENVIRONMENT_BLEND_MODE_UNSUPPORTED;
+    }
+    if (frameEndInfo->layerCount > XR_MIN_COMPOSITION_LAYERS_SUPPORTED) {
+        return XR_ERROR_LAYER_LIMIT_EXCEEDED;
+    }
+    runtime.frameBegun = false;
+    runtime.frameCount++;
+    runtime.lastFrameEnd = std::chrono::steady_clock::now();
+
+    if (runtime.settings.frameCount != 0 && runtime.frameCount == runtime.settings.frameCount) {
+        RequestSessionEnd();
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockLocateViews(XrSession session, const XrViewLocateInfo *viewLocateInfo, XrViewState *viewState, uint32_t viewCapacityInput, uint32_t *viewCountOutput, XrView *views) {
+    MOCK_CHECK_SESSION(session);
+    if (viewLocateInfo->viewConfigurationType != viewConfiguration) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    auto baseIt = runtime.spaces.find(FromHandle(viewLocateInfo->space));
+    if (baseIt == runtime.spaces.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    *viewCountOutput = viewCount;
+    if (viewCapacityInput == 0) {
+        return XR_SUCCESS;
+    }
+    if (viewCapacityInput < viewCount) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    const XrPosef headPose = Compose(Invert(GetSpacePose(baseIt->second, viewLocateInfo->displayTime)), GetHeadPose(viewLocateInfo->displayTime));
+    for (uint32_t i = 0; i < viewCount; i++) {
+        const float eyeOffset = (i == 0 ? -0.5f : 0.5f) * interpupillaryDistance;
+        views[i].pose = Compose(headPose, {{0.0f, 0.0f, 0.0f, 1.0f}, {eyeOffset, 0.0f, 0.0f}});
+        views[i].fov = {-0.785398f, 0.785398f, 0.785398f, -0.785398f};
+    }
+    viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT | XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+    return XR_SUCCESS;
+}
+
+// Actions
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateActionSet(XrInstance instance, const XrActionSetCreateInfo *createInfo, XrActionSet *actionSet) {
+    MOCK_CHECK_INSTANCE(instance);
+    const uint64_t id = runtime.nextHandle++;
+    runtime.actionSets.push_back(id);
+    *actionSet = ToHandle<XrActionSet>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyActionSet(XrActionSet actionSet) {
+    auto it = std::find(runtime.actionSets.begin(), runtime.actionSets.end(), FromHandle(actionSet));
+    if (it == runtime.actionSets.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    runtime.actionSets.erase(it);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateAction(XrActionSet actionSet, const XrActionCreateInfo *createInfo, XrAction *action) {
+    if (std::find(runtime.actionSets.begin(), runtime.actionSets.end(), FromHandle(actionSet)) == runtime.actionSets.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (runtime.actionSetsAttached) {
+        return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    }
+    const uint64_t id = runtime.nextHandle++;
+    runtime.actions[id] = {createInfo->actionType};
+    *action = ToHandle<XrAction>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyAction(XrAction action) {
+    return runtime.actions.erase(FromHandle(action)) ? XR_SUCCESS : XR_ERROR_HANDLE_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSuggestInteractionProfileBindings(XrInstance instance, const XrInteractionProfileSuggestedBinding *suggestedBindings) {
+    MOCK_CHECK_INSTANCE(instance);
+    if (runtime.actionSetsAttached) {
+        return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    }
+    // Every action is driven by the script whatever it is bound to, so only the profiles are recorded.
+    if (std::find(runtime.suggestedInteractionProfiles.begin(), runtime.suggestedInteractionProfiles.end(), suggestedBindings->interactionProfile) == runtime.suggestedInteractionProfiles.end()) {
+        runtime.suggestedInteractionProfiles.push_back(suggestedBindings->interactionProfile);
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo *attachInfo) {
+    MOCK_CHECK_SESSION(session);
+    if (runtime.actionSetsAttached) {
+        return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    }
+    runtime.actionSetsAttached = true;
+    const XrPath preferred = FindPath(preferredInteractionProfile);
+    if (preferred != XR_NULL_PATH && std::find(runtime.suggestedInteractionProfiles.begin(), runtime.suggestedInteractionProfiles.end(), preferred) != runtime.suggestedInteractionProfiles.end()) {
+        runtime.interactionProfile = preferred;
+    } else if (!runtime.suggestedInteractionProfiles.empty()) {
+        runtime.interactionProfile = runtime.suggestedInteractionProfiles[0];
+    }
+    if (IsSessionFocused()) {
+        PushInteractionProfileChanged();
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetCurrentInteractionProfile(XrSession session, XrPath topLevelUserPath, XrInteractionProfileState *interactionProfile) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.actionSetsAttached) {
+        return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    }
+    interactionProfile->interactionProfile = GetHand(topLevelUserPath) >= 0 ? runtime.interactionProfile : XR_NULL_PATH;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo) {
+    MOCK_CHECK_SESSION(session);
+    if (!runtime.actionSetsAttached) {
+        return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    }
+    if (!IsSessionFocused()) {
+        return XR_SESSION_NOT_FOCUSED;
+    }
+    for (int hand = 0; hand < 2; hand++) {
+        HandInput &input = runtime.handInputs[hand];
+        HandInput next = GetHandInput(hand, runtime.predictedDisplayTime);
+        next.grabChanged = next.grab != input.grab;
+        next.selectChanged = next.select != input.select;
+        if (next.grabChanged || next.selectChanged) {
+            runtime.inputChangeTime[hand] = runtime.predictedDisplayTime;
+        }
+        input = next;
+    }
+    return XR_SUCCESS;
+}
+
+// Looks up the action and the hand its state is for. A null subaction path combines both hands, as the right hand.
+XrResult GetActionState(const XrActionStateGetInfo *getInfo, XrActionType type, int &hand) {
+    if (!runtime.actionSetsAttached) {
+        return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    }
+    auto it = runtime.actions.find(FromHandle(getInfo->action));
+    if (it == runtime.actions.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (it->second.type != type) {
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
+    }
+    hand = GetHand(getInfo->subactionPath);
+    if (getInfo->subactionPath != XR_NULL_PATH && hand < 0) {
+        return XR_ERROR_PATH_UNSUPPORTED;
+    }
+    if (hand < 0) {
+        hand = 1;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateBoolean(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateBoolean *state) {
+    MOCK_CHECK_SESSION(session);
+    int hand = 0;
+    const XrResult result = GetActionState(getInfo, XR_ACTION_TYPE_BOOLEAN_INPUT, hand);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    const HandInput &input = runtime.handInputs[hand];
+    state->isActive = IsSessionFocused();
+    state->currentState = state->isActive ? input.select : XR_FALSE;
+    state->changedSinceLastSync = state->isActive ? input.selectChanged : XR_FALSE;
+    state->lastChangeTime = runtime.inputChangeTime[hand];
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateFloat(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateFloat *state) {
+    MOCK_CHECK_SESSION(session);
+    int hand = 0;
+    const XrResult result = GetActionState(getInfo, XR_ACTION_TYPE_FLOAT_INPUT, hand);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    const HandInput &input = runtime.handInputs[hand];
+    state->isActive = IsSessionFocused();
+    state->currentState = state->isActive ? input.grab : 0.0f;
+    state->changedSinceLastSync = state->isActive ? input.grabChanged : XR_FALSE;
+    state->lastChangeTime = runtime.inputChangeTime[hand];
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateVector2f(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateVector2f *state) {
+    MOCK_CHECK_SESSION(session);
+    int hand = 0;
+    const XrResult result = GetActionState(getInfo, XR_ACTION_TYPE_VECTOR2F_INPUT, hand);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    state->isActive = IsSessionFocused();
+    state->currentState = {0.0f, 0.0f};
+    state->changedSinceLastSync = XR_FALSE;
+    state->lastChangeTime = 0;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStatePose(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStatePose *state) {
+    MOCK_CHECK_SESSION(session);
+    int hand = 0;
+    const XrResult result = GetActionState(getInfo, XR_ACTION_TYPE_POSE_INPUT, hand);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    state->isActive = IsSessionFocused();
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateBoundSourcesForAction(XrSession session, const XrBoundSourcesForActionEnumerateInfo *enumerateInfo, uint32_t sourceCapacityInput, uint32_t *sourceCountOutput, XrPath *sources) {
+    MOCK_CHECK_SESSION(session);
+    return Enumerate<XrPath>(nullptr, 0, sourceCapacityInput, sourceCountOutput, sources);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInputSourceLocalizedName(XrSession session, const XrInputSourceLocalizedNameGetInfo *getInfo, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer) {
+    MOCK_CHECK_SESSION(session);
+    if (getInfo->sourcePath == XR_NULL_PATH || getInfo->sourcePath > runtime.paths.size()) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    return EnumerateString(runtime.paths[getInfo->sourcePath - 1], bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockApplyHapticFeedback(XrSession session, const XrHapticActionInfo *hapticActionInfo, const XrHapticBaseHeader *hapticFeedback) {
+    MOCK_CHECK_SESSION(session);
+    return runtime.actionSetsAttached ? XR_SUCCESS : XR_ERROR_ACTIONSET_NOT_ATTACHED;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockStopHapticFeedback(XrSession session, const XrHapticActionInfo *hapticActionInfo) {
+    MOCK_CHECK_SESSION(session);
+    return runtime.actionSetsAttached ? XR_SUCCESS : XR_ERROR_ACTIONSET_NOT_ATTACHED;
+}
+
+// XR_EXT_debug_utils. Nothing is reported, so the messengers are only handles.
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateDebugUtilsMessengerEXT(XrInstance instance, const XrDebugUtilsMessengerCreateInfoEXT *createInfo, XrDebugUtilsMessengerEXT *messenger) {
+    MOCK_CHECK_INSTANCE(instance);
+    const uint64_t id = runtime.nextHandle++;
+    runtime.debugUtilsMessengers.push_back(id);
+    *messenger = ToHandle<XrDebugUtilsMessengerEXT>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyDebugUtilsMessengerEXT(XrDebugUtilsMessengerEXT messenger) {
+    auto it = std::find(runtime.debugUtilsMessengers.begin(), runtime.debugUtilsMessengers.end(), FromHandle(messenger));
+    if (it == runtime.debugUtilsMessengers.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    runtime.debugUtilsMessengers.erase(it);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSubmitDebugUtilsMessageEXT(XrInstance instance, XrDebugUtilsMessageSeverityFlagsEXT messageSeverity, XrDebugUtilsMessageTypeFlagsEXT messageTypes, const XrDebugUtilsMessengerCallbackDataEXT *callbackData) {
+    MOCK_CHECK_INSTANCE(instance);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSetDebugUtilsObjectNameEXT(XrInstance instance, const XrDebugUtilsObjectNameInfoEXT *nameInfo) {
+    MOCK_CHECK_INSTANCE(instance);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSessionBeginDebugUtilsLabelRegionEXT(XrSession session, const XrDebugUtilsLabelEXT *labelInfo) {
+    MOCK_CHECK_SESSION(session);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSessionEndDebugUtilsLabelRegionEXT(XrSession session) {
+    MOCK_CHECK_SESSION(session);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSessionInsertDebugUtilsLabelEXT(XrSession session, const XrDebugUtilsLabelEXT *labelInfo) {
+    MOCK_CHECK_SESSION(session);
+    return XR_SUCCESS;
+}
+
+// XR_EXT_hand_tracking
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateHandTrackerEXT(XrSession session, const XrHandTrackerCreateInfoEXT *createInfo, XrHandTrackerEXT *handTracker) {
+    MOCK_CHECK_SESSION(session);
+    if (createInfo->handJointSet != XR_HAND_JOINT_SET_DEFAULT_EXT) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const uint64_t id = runtime.nextHandle++;
+    runtime.handTrackers[id] = createInfo->hand;
+    *handTracker = ToHandle<XrHandTrackerEXT>(id);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyHandTrackerEXT(XrHandTrackerEXT handTracker) {
+    return runtime.handTrackers.erase(FromHandle(handTracker)) ? XR_SUCCESS : XR_ERROR_HANDLE_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockLocateHandJointsEXT(XrHandTrackerEXT handTracker, const XrHandJointsLocateInfoEXT *locateInfo, XrHandJointLocationsEXT *locations) {
+    auto it = runtime.handTrackers.find(FromHandle(handTracker));
+    auto baseIt = runtime.spaces.find(FromHandle(locateInfo->baseSpace));
+    if (it == runtime.handTrackers.end() || baseIt == runtime.spaces.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (locations->jointCount != XR_HAND_JOINT_COUNT_EXT) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    locations->isActive = IsSessionFocused();
+    if (!locations->isActive) {
+        for (uint32_t i = 0; i < locations->jointCount; i++) {
+            locations->jointLocations[i].locationFlags = 0;
+        }
+        return XR_SUCCESS;
+    }
+
+    const int hand = it->second == XR_HAND_LEFT_EXT ? 0 : 1;
+    const XrPosef palmPose = Compose(Invert(GetSpacePose(baseIt->second, locateInfo->time)), GetHandPose(hand, locateInfo->time));
+    for (uint32_t i = 0; i < locations->jointCount; i++) {
+        XrHandJointLocationEXT &jointLocation = locations->jointLocations[i];
+        XrPosef jointPose = {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}};
+        GetHandJointOffset(hand, i, jointPose.position, jointLocation.radius);
+        jointLocation.pose = Compose(palmPose, jointPose);
+        jointLocation.locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProcAddr(XrInstance instance, const char *name, PFN_xrVoidFunction *function);
+
+struct Function {
+    const char *name;
+    PFN_xrVoidFunction function;
+};
+// The static_cast checks each function against its PFN_ type.
+#define MOCK_FUNCTION(name) {"xr" #name, reinterpret_cast<PFN_xrVoidFunction>(static_cast<PFN_xr##name>(Mock##name))}
+
+// Functions that may be looked up before there is an instance.
+const Function globalFunctions[] = {
+    MOCK_FUNCTION(GetInstanceProcAddr),
+    MOCK_FUNCTION(EnumerateInstanceExtensionProperties),
+    MOCK_FUNCTION(CreateInstance),
+};
+
+const Function instanceFunctions[] = {
+    MOCK_FUNCTION(DestroyInstance),
+    MOCK_FUNCTION(GetInstanceProperties),
+    MOCK_FUNCTION(PollEvent),
+    MOCK_FUNCTION(ResultToString),
+    MOCK_FUNCTION(StructureTypeToString),
+    MOCK_FUNCTION(StringToPath),
+    MOCK_FUNCTION(PathToString),
+    MOCK_FUNCTION(GetSystem),
+    MOCK_FUNCTION(GetSystemProperties),
+    MOCK_FUNCTION(EnumerateViewConfigurations),
+    MOCK_FUNCTION(GetViewConfigurationProperties),
+    MOCK_FUNCTION(EnumerateViewConfigurationViews),
+    MOCK_FUNCTION(EnumerateEnvironmentBlendModes),
+    MOCK_FUNCTION(CreateSession),
+    MOCK_FUNCTION(DestroySession),
+    MOCK_FUNCTION(BeginSession),
+    MOCK_FUNCTION(EndSession),
+    MOCK_FUNCTION(RequestExitSession),
+    MOCK_FUNCTION(EnumerateReferenceSpaces),
+    MOCK_FUNCTION(CreateReferenceSpace),
+    MOCK_FUNCTION(GetReferenceSpaceBoundsRect),
+    MOCK_FUNCTION(CreateActionSpace),
+    MOCK_FUNCTION(LocateSpace),
+    MOCK_FUNCTION(DestroySpace),
+    MOCK_FUNCTION(EnumerateSwapchainFormats),
+    MOCK_FUNCTION(CreateSwapchain),
+    MOCK_FUNCTION(DestroySwapchain),
+    MOCK_FUNCTION(EnumerateSwapchainImages),
+    MOCK_FUNCTION(AcquireSwapchainImage),
+    MOCK_FUNCTION(WaitSwapchainImage),
+    MOCK_FUNCTION(ReleaseSwapchainImage),
+    MOCK_FUNCTION(WaitFrame),
+    MOCK_FUNCTION(BeginFrame),
+    MOCK_FUNCTION(EndFrame),
+    MOCK_FUNCTION(LocateViews),
+    MOCK_FUNCTION(CreateActionSet),
+    MOCK_FUNCTION(DestroyActionSet),
+    MOCK_FUNCTION(CreateAction),
+    MOCK_FUNCTION(DestroyAction),
+    MOCK_FUNCTION(SuggestInteractionProfileBindings),
+    MOCK_FUNCTION(AttachSessionActionSets),
+    MOCK_FUNCTION(GetCurrentInteractionProfile),
+    MOCK_FUNCTION(SyncActions),
+    MOCK_FUNCTION(GetActionStateBoolean),
+    MOCK_FUNCTION(GetActionStateFloat),
+    MOCK_FUNCTION(GetActionStateVector2f),
+    MOCK_FUNCTION(GetActionStatePose),
+    MOCK_FUNCTION(EnumerateBoundSourcesForAction),
+    MOCK_FUNCTION(GetInputSourceLocalizedName),
+    MOCK_FUNCTION(ApplyHapticFeedback),
+    MOCK_FUNCTION(StopHapticFeedback),
+    MOCK_FUNCTION(GetVulkanInstanceExtensionsKHR),
+    MOCK_FUNCTION(GetVulkanDeviceExtensionsKHR),
+    MOCK_FUNCTION(GetVulkanGraphicsRequirementsKHR),
+    MOCK_FUNCTION(GetVulkanGraphicsDeviceKHR),
+    MOCK_FUNCTION(CreateDebugUtilsMessengerEXT),
+    MOCK_FUNCTION(DestroyDebugUtilsMessengerEXT),
+    MOCK_FUNCTION(SubmitDebugUtilsMessageEXT),
+    MOCK_FUNCTION(SetDebugUtilsObjectNameEXT),
+    MOCK_FUNCTION(SessionBeginDebugUtilsLabelRegionEXT),
+    MOCK_FUNCTION(SessionEndDebugUtilsLabelRegionEXT),
+    MOCK_FUNCTION(SessionInsertDebugUtilsLabelEXT),
+    MOCK_FUNCTION(CreateHandTrackerEXT),
+    MOCK_FUNCTION(DestroyHandTrackerEXT),
+    MOCK_FUNCTION(LocateHandJointsEXT),
+};
+#undef MOCK_FUNCTION
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProcAddr(XrInstance instance, const char *name, PFN_xrVoidFunction *function) {
+    *function = nullptr;
+    for (const Function &globalFunction : globalFunctions) {
+        if (strcmp(name, globalFunction.name) == 0) {
+            *function = globalFunction.function;
+            return XR_SUCCESS;
+        }
+    }
+    if (instance == XR_NULL_HANDLE) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    MOCK_CHECK_INSTANCE(instance);
+    for (const Function &instanceFunction : instanceFunctions) {
+        if (strcmp(name, instanceFunction.name) == 0) {
+            *function = instanceFunction.function;
+            return XR_SUCCESS;
+        }
+    }
+    return XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+}  // namespace
+
+MOCK_RUNTIME_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(const XrNegotiateLoaderInfo *loaderInfo, XrNegotiateRuntimeRequest *runtimeRequest) {
+    if (!loaderInfo || !runtimeRequest ||
+        loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO || loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo) ||
+        runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST || runtimeRequest->structVersion != XR_RUNTIME_INFO_STRUCT_VERSION || runtimeRequest->structSize != sizeof(XrNegotiateRuntimeRequest)) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION || loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_MAKE_VERSION(1, 0, 0)) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+    runtimeRequest->getInstanceProcAddr = MockGetInstanceProcAddr;
+    return XR_SUCCESS;
+}
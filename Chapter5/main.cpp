@@ -5,6 +5,8 @@
 // OpenXR Tutorial for Khronos Group
 
 #include <DebugOutput.h>
+#include <FileView.h>
+#include <FrameTiming.h>
 // XR_DOCS_TAG_BEGIN_include_GraphicsAPI_D3D11
 #include <GraphicsAPI_D3D11.h>
 // XR_DOCS_TAG_END_include_GraphicsAPI_D3D11
@@ -20,6 +22,8 @@
 // XR_DOCS_TAG_BEGIN_include_GraphicsAPI_Vulkan
 #include <GraphicsAPI_Vulkan.h>
 // XR_DOCS_TAG_END_include_GraphicsAPI_Vulkan
+#include <JobSystem.h>
+#include <MeshFile.h>
 // XR_DOCS_TAG_BEGIN_include_OpenXRDebugUtils
 #include <OpenXRDebugUtils.h>
 // XR_DOCS_TAG_END_include_OpenXRDebugUtils
@@ -49,6 +53,8 @@ XrVector3f operator*(XrVector3f a, float b) {
 static std::uniform_real_distribution<float> pseudorandom_distribution(0, 1.f);
 static std::mt19937 pseudo_random_generator;
 // XR_DOCS_TAG_END_include_algorithm_random
+// For std::getenv() and std::strtoul() in ParseBlockGridSize().
+#include <cstdlib>
 
 #define XR_DOCS_CHAPTER_VERSION XR_DOCS_CHAPTER_5_2
 
@@ -67,6 +73,60 @@ public:
     }
     ~OpenXRTutorial() = default;
 
+    // Stress mode: sets the dimensions of the grid of blocks, instead of the default 4x4x4, from the --blocks=XxYxZ argument
+    // or the XR_TUTORIAL_BLOCKS environment variable. A single number N is an NxNxN grid, so --blocks=100 creates a million blocks.
+    void ParseBlockGridSize(int argc, char **argv) {
+        const char *value = std::getenv("XR_TUTORIAL_BLOCKS");
+        const std::string option = "--blocks";
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg == option && i + 1 < argc) {
+                value = argv[++i];
+            } else if (arg.compare(0, option.size() + 1, option + "=") == 0) {
+                value = argv[i] + option.size() + 1;
+            }
+        }
+        if (!value || *value == '\0') {
+            return;
+        }
+
+        // Read up to three numbers separated by 'x'.
+        size_t size[3] = {0, 0, 0};
+        size_t dimensionCount = 0;
+        bool valid = false;
+        const char *text = value;
+        while (dimensionCount < 3) {
+            char *end = nullptr;
+            size[dimensionCount++] = std::strtoul(text, &end, 10);
+            if (end == text || (*end != 'x' && *end != '\0')) {
+                break;
+            }
+            if (*end == '\0') {
+                valid = dimensionCount == 1 || dimensionCount == 3;
+                break;
+            }
+            text = end + 1;
+        }
+        if (dimensionCount == 1) {
+            size[1] = size[2] = size[0];
+        }
+        for (size_t dimension : size) {
+            valid &= dimension > 0 && dimension <= m_maxStressBlockGridSize;
+        }
+        // Multiplied in 64 bits, so that the count of a large grid can't wrap around within a 32-bit size_t and pass the check.
+        const uint64_t blockCount64 = static_cast<uint64_t>(size[0]) * size[1] * size[2];
+        if (!valid || blockCount64 > m_maxStressBlockCount) {
+            XR_TUT_LOG_ERROR("Invalid block grid size: " << value << ". Expected N or XxYxZ, with at most " << m_maxStressBlockCount << " blocks.");
+            return;
+        }
+        const size_t blockCount = static_cast<size_t>(blockCount64);
+        for (int i = 0; i < 3; i++) {
+            m_blockGridSize[i] = static_cast<uint32_t>(size[i]);
+        }
+        m_maxBlockCount = std::max(m_maxBlockCount, blockCount);
+        XR_TUT_LOG("Stress mode: " << size[0] << "x" << size[1] << "x" << size[2] << " grid of " << blockCount << " blocks.");
+    }
+
     void Run() {
         CreateInstance();
         CreateDebugMessenger();
@@ -122,6 +182,7 @@ public:
                 RenderFrame();
             }
         }
+        WriteFrameTiming();
 #endif
 
 #if XR_DOCS_CHAPTER_VERSION >= XR_DOCS_CHAPTER_3_1
@@ -569,16 +630,29 @@ private:
     }
 
     // XR_DOCS_TAG_BEGIN_CreateResources1
+    // Per-pass constants. A pass draws one view with viewProj[0], or, with multiview, every view, as the vertex shader selects
+    // viewProj by view index. Two matches the num_views of the multiview vertex shaders.
     struct CameraConstants {
-        XrMatrix4x4f viewProj;
-        XrMatrix4x4f modelViewProj;
+        XrMatrix4x4f viewProj[2];
+    };
+    CameraConstants cameraConstants;
+    // Per-instance values for a cuboid, read in the vertex shader by instance index.
+    struct CuboidInstance {
         XrMatrix4x4f model;
         XrVector4f color;
-        XrVector4f pad1;
-        XrVector4f pad2;
-        XrVector4f pad3;
     };
-    CameraConstants cameraConstants;
+    // Matches MeshConstants in VertexShader_Instanced.
+    struct MeshConstants {
+        XrVector4f positionScale;
+    };
+    // Geometry for our cuboids, in the vertex format of MeshFile.h.
+    struct CuboidMesh {
+        void *vertexBuffer = nullptr;
+        void *indexBuffer = nullptr;
+        // A uniform buffer holding the mesh's MeshConstants.
+        void *constantsBuffer = nullptr;
+        uint32_t indexCount = 0;
+    };
     XrVector4f normals[6] = {
         {1.00f, 0.00f, 0.00f, 0},
         {-1.00f, 0.00f, 0.00f, 0},
@@ -588,6 +662,70 @@ private:
         {0.00f, 0.0f, -1.00f, 0}};
     // XR_DOCS_TAG_END_CreateResources1
 
+    // Where to write files that outlive the process, such as the pipeline cache and the frame timings.
+    std::string GetDataFilePath(const std::string &fileName) {
+#if defined(__ANDROID__)
+        // The APK's assets are read-only, so the files go in the app's private storage.
+        return std::string(androidApp->activity->internalDataPath) + "/" + fileName;
+#else
+        return fileName;
+#endif
+    }
+
+    // Logs the frame timing percentiles and dumps the recorded frames, so that missed frames can be looked at after a session.
+    void WriteFrameTiming() {
+        XR_TUT_LOG(m_frameTiming.GetSummaryString());
+        m_frameTiming.WriteCSV(GetDataFilePath("FrameTiming.csv"));
+        m_frameTiming.WriteJSON(GetDataFilePath("FrameTiming.json"));
+    }
+
+    // positionScale scales the mesh's quantized positions, in [-1, 1], to fit in the 1x1x1 meter cube.
+    CuboidMesh CreateCuboidMesh(const MeshVertex *vertices, size_t verticesSize, const void *indices, size_t indexStride, size_t indicesSize, const XrVector3f &positionScale) {
+        CuboidMesh mesh;
+        // CreateBuffer() only reads the data, which may be in a read-only FileView.
+        mesh.vertexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::VERTEX, sizeof(MeshVertex), verticesSize, const_cast<MeshVertex *>(vertices)});
+        mesh.indexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDEX, indexStride, indicesSize, const_cast<void *>(indices)});
+        MeshConstants meshConstants = {{positionScale.x, positionScale.y, positionScale.z, 0.0f}};
+        mesh.constantsBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(MeshConstants), &meshConstants});
+        mesh.indexCount = static_cast<uint32_t>(indicesSize / indexStride);
+        return mesh;
+    }
+
+    void DestroyCuboidMesh(CuboidMesh &mesh) {
+        if (!mesh.vertexBuffer) {
+            return;
+        }
+        m_graphicsAPI->DestroyBuffer(mesh.constantsBuffer);
+        m_graphicsAPI->DestroyBuffer(mesh.indexBuffer);
+        m_graphicsAPI->DestroyBuffer(mesh.vertexBuffer);
+        mesh = {};
+    }
+
+    // Loads the .xrmesh file named by the XR_TUTORIAL_MESH environment variable, as written by MeshConverter, to draw the
+    // scene's cuboids with instead of the cube. The file is mapped and its buffers are created straight from the mapping.
+    void LoadSceneMesh() {
+        const std::string filepath = GetEnv("XR_TUTORIAL_MESH");
+        if (filepath.empty()) {
+            return;
+        }
+        const MeshFile meshFile{FileView(filepath)};
+        if (!meshFile.IsValid()) {
+            XR_TUT_LOG_ERROR("Failed to load mesh " << filepath << ". Drawing cubes instead.");
+            return;
+        }
+        const MeshFileHeader &header = meshFile.GetHeader();
+        const float maxHalfExtent = std::max(header.halfExtent[0], std::max(header.halfExtent[1], header.halfExtent[2]));
+        if (header.indexCount == 0 || maxHalfExtent <= 0.0f) {
+            XR_TUT_LOG_ERROR("Mesh " << filepath << " is empty. Drawing cubes instead.");
+            return;
+        }
+
+        // Centered in the cuboid, and scaled uniformly so that its longest side fills it, so that the cuboid's bounds still cull it.
+        const XrVector3f positionScale = {header.halfExtent[0] / (2.0f * maxHalfExtent), header.halfExtent[1] / (2.0f * maxHalfExtent), header.halfExtent[2] / (2.0f * maxHalfExtent)};
+        m_sceneMesh = CreateCuboidMesh(meshFile.GetVertices(), meshFile.GetVerticesSize(), meshFile.GetIndices(), header.indexStride, meshFile.GetIndicesSize(), positionScale);
+        XR_TUT_LOG("Loaded mesh " << filepath << ": " << header.vertexCount << " vertices, " << header.indexCount / 3 << " triangles.");
+    }
+
     void CreateResources() {
         // XR_DOCS_TAG_BEGIN_CreateResources1_1
         // Vertices for a 1x1x1 meter cube. (Left/Right, Top/Bottom, Front/Back)
@@ -621,78 +759,122 @@ private:
             30, 31, 32, 33, 34, 35,  // +Z
         };
 
-        m_vertexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::VERTEX, sizeof(float) * 4, sizeof(cubeVertices), &cubeVertices});
-
-        m_indexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDEX, sizeof(uint32_t), sizeof(cubeIndices), &cubeIndices});
+        // Quantized into the vertex format of the meshes in MeshFile.h, so that the cube and a loaded mesh share a pipeline.
+        // The normal of each face is in normals[].
+        const float cubeCenter[3] = {0.0f, 0.0f, 0.0f};
+        const float cubeHalfExtent[3] = {0.5f, 0.5f, 0.5f};
+        MeshVertex cubeMeshVertices[36];
+        for (size_t i = 0; i < 36; i++) {
+            const float position[3] = {cubeVertices[i].x, cubeVertices[i].y, cubeVertices[i].z};
+            const float normal[3] = {normals[i / 6].x, normals[i / 6].y, normals[i / 6].z};
+            cubeMeshVertices[i] = EncodeMeshVertex(position, normal, cubeCenter, cubeHalfExtent);
+        }
+        m_cubeMesh = CreateCuboidMesh(cubeMeshVertices, sizeof(cubeMeshVertices), cubeIndices, sizeof(uint32_t), sizeof(cubeIndices), {0.5f, 0.5f, 0.5f});
+        LoadSceneMesh();
 
         // XR_DOCS_TAG_BEGIN_Update_numberOfCuboids
-        size_t numberOfCuboids = 64 + 2 + 2;
+        size_t numberOfCuboids = m_maxBlockCount + 2 + 2;
         // XR_DOCS_TAG_END_Update_numberOfCuboids
         // XR_DOCS_TAG_BEGIN_AddHandCuboids
         numberOfCuboids += XR_HAND_JOINT_COUNT_EXT * 2;
         // XR_DOCS_TAG_END_AddHandCuboids
-        m_uniformBuffer_Camera = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(CameraConstants) * numberOfCuboids, nullptr});
-        m_uniformBuffer_Normals = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(normals), &normals});
+        // The camera and instance constants are allocated each frame with AllocateTransientUniform(), so this is only a hint.
+        m_cuboidInstances.reserve(numberOfCuboids);
+        for (std::vector<float> &transform : m_cuboidTransforms) {
+            transform.reserve(numberOfCuboids);
+        }
         // XR_DOCS_TAG_END_CreateResources1_1
 
         // XR_DOCS_TAG_BEGIN_CreateResources2_OpenGL
         if (m_apiType == OPENGL) {
-            std::string vertexSource = ReadTextFile("VertexShader.glsl");
-            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.data(), vertexSource.size()});
+            FileView vertexSource(m_multiview ? "VertexShader_Instanced_GL_MV.glsl" : "VertexShader_Instanced.glsl");
+            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.GetData(), vertexSource.GetSize()});
 
-            std::string fragmentSource = ReadTextFile("PixelShader.glsl");
-            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.data(), fragmentSource.size()});
+            FileView fragmentSource("PixelShader.glsl");
+            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.GetData(), fragmentSource.GetSize()});
         }
         // XR_DOCS_TAG_END_CreateResources2_OpenGL
         // XR_DOCS_TAG_BEGIN_CreateResources2_VulkanWindowsLinux
         if (m_apiType == VULKAN) {
-            std::vector<char> vertexSource = ReadBinaryFile("VertexShader.spv");
-            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.data(), vertexSource.size()});
+            FileView vertexSource(m_multiview ? "VertexShader_Instanced_VK_MV.spv" : "VertexShader_Instanced.spv");
+            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.GetData(), vertexSource.GetSize()});
 
-            std::vector<char> fragmentSource = ReadBinaryFile("PixelShader.spv");
-            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.data(), fragmentSource.size()});
+            FileView fragmentSource("PixelShader.spv");
+            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.GetData(), fragmentSource.GetSize()});
         }
         // XR_DOCS_TAG_END_CreateResources2_VulkanWindowsLinux
 #if defined(__ANDROID__)
         // XR_DOCS_TAG_BEGIN_CreateResources2_VulkanAndroid
         if (m_apiType == VULKAN) {
-            std::vector<char> vertexSource = ReadBinaryFile("shaders/VertexShader.spv", androidApp->activity->assetManager);
-            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.data(), vertexSource.size()});
-            std::vector<char> fragmentSource = ReadBinaryFile("shaders/PixelShader.spv", androidApp->activity->assetManager);
-            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.data(), fragmentSource.size()});
+            FileView vertexSource(m_multiview ? "shaders/VertexShader_Instanced_VK_MV.spv" : "shaders/VertexShader_Instanced.spv", androidApp->activity->assetManager);
+            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.GetData(), vertexSource.GetSize()});
+            FileView fragmentSource("shaders/PixelShader.spv", androidApp->activity->assetManager);
+            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.GetData(), fragmentSource.GetSize()});
         }
         // XR_DOCS_TAG_END_CreateResources2_VulkanAndroid
         // XR_DOCS_TAG_BEGIN_CreateResources2_OpenGLES
         if (m_apiType == OPENGL_ES) {
-            std::string vertexSource = ReadTextFile("shaders/VertexShader_GLES.glsl", androidApp->activity->assetManager);
-            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.data(), vertexSource.size()});
-            std::string fragmentSource = ReadTextFile("shaders/PixelShader_GLES.glsl", androidApp->activity->assetManager);
-            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.data(), fragmentSource.size()});
+            FileView vertexSource("shaders/VertexShader_Instanced_GLES.glsl", androidApp->activity->assetManager);
+            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.GetData(), vertexSource.GetSize()});
+            FileView fragmentSource("shaders/PixelShader_GLES.glsl", androidApp->activity->assetManager);
+            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.GetData(), fragmentSource.GetSize()});
         }
         // XR_DOCS_TAG_END_CreateResources2_OpenGLES
 #endif
         // XR_DOCS_TAG_BEGIN_CreateResources2_D3D
         if (m_apiType == D3D11) {
-            std::vector<char> vertexSource = ReadBinaryFile("VertexShader_5_0.cso");
-            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.data(), vertexSource.size()});
+            FileView vertexSource("VertexShader_Instanced_5_0.cso");
+            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.GetData(), vertexSource.GetSize()});
 
-            std::vector<char> fragmentSource = ReadBinaryFile("PixelShader_5_0.cso");
-            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.data(), fragmentSource.size()});
+            FileView fragmentSource("PixelShader_5_0.cso");
+            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.GetData(), fragmentSource.GetSize()});
         }
         if (m_apiType == D3D12) {
-            std::vector<char> vertexSource = ReadBinaryFile("VertexShader_5_1.cso");
-            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.data(), vertexSource.size()});
+            FileView vertexSource("VertexShader_Instanced_5_1.cso");
+            m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.GetData(), vertexSource.GetSize()});
 
-            std::vector<char> fragmentSource = ReadBinaryFile("PixelShader_5_1.cso");
-            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.data(), fragmentSource.size()});
+            FileView fragmentSource("PixelShader_5_1.cso");
+            m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource.GetData(), fragmentSource.GetSize()});
         }
         // XR_DOCS_TAG_END_CreateResources2_D3D
 
+        // An unlit, flat-coloured pixel shader for the placeholder pipeline, drawn while the main pipeline is built.
+        std::string placeholderFragmentFilename;
+        switch (m_apiType) {
+        case D3D11:
+            placeholderFragmentFilename = "PixelShader_Flat_5_0.cso";
+            break;
+        case D3D12:
+            placeholderFragmentFilename = "PixelShader_Flat_5_1.cso";
+            break;
+        case OPENGL:
+            placeholderFragmentFilename = "PixelShader_Flat.glsl";
+            break;
+        case OPENGL_ES:
+            placeholderFragmentFilename = "PixelShader_Flat_GLES.glsl";
+            break;
+        case VULKAN:
+            placeholderFragmentFilename = "PixelShader_Flat.spv";
+            break;
+        default:
+            break;
+        }
+#if defined(__ANDROID__)
+        FileView placeholderFragmentSource("shaders/" + placeholderFragmentFilename, androidApp->activity->assetManager);
+#else
+        FileView placeholderFragmentSource(placeholderFragmentFilename);
+#endif
+        m_placeholderFragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, placeholderFragmentSource.GetData(), placeholderFragmentSource.GetSize()});
+
+        // Reuse the pipelines compiled in the last run, if any. Saved again in DestroyResources().
+        m_graphicsAPI->LoadPipelineCache(GetDataFilePath("PipelineCache.bin"));
+
         // XR_DOCS_TAG_BEGIN_CreateResources3
         GraphicsAPI::PipelineCreateInfo pipelineCI;
         pipelineCI.shaders = {m_vertexShader, m_fragmentShader};
-        pipelineCI.vertexInputState.attributes = {{0, 0, GraphicsAPI::VertexType::VEC4, 0, "TEXCOORD"}};
-        pipelineCI.vertexInputState.bindings = {{0, 0, 4 * sizeof(float)}};
+        pipelineCI.vertexInputState.attributes = {{0, 0, GraphicsAPI::VertexType::VEC4_SNORM16, offsetof(MeshVertex, position), "TEXCOORD"},
+                                                  {1, 0, GraphicsAPI::VertexType::VEC4_SNORM8, offsetof(MeshVertex, normal), "TEXCOORD"}};
+        pipelineCI.vertexInputState.bindings = {{0, 0, sizeof(MeshVertex)}};
         pipelineCI.inputAssemblyState = {GraphicsAPI::PrimitiveTopology::TRIANGLE_LIST, false};
         pipelineCI.rasterisationState = {false, false, GraphicsAPI::PolygonMode::FILL, GraphicsAPI::CullMode::BACK, GraphicsAPI::FrontFace::COUNTER_CLOCKWISE, false, 0.0f, 0.0f, 0.0f, 1.0f};
         pipelineCI.multisampleState = {1, false, 1.0f, 0xFFFFFFFF, false, false};
@@ -700,45 +882,75 @@ private:
         pipelineCI.colorBlendState = {false, GraphicsAPI::LogicOp::NO_OP, {{true, GraphicsAPI::BlendFactor::SRC_ALPHA, GraphicsAPI::BlendFactor::ONE_MINUS_SRC_ALPHA, GraphicsAPI::BlendOp::ADD, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD, (GraphicsAPI::ColorComponentBit)15}}, {0.0f, 0.0f, 0.0f, 0.0f}};
         pipelineCI.colorFormats = {m_colorSwapchainInfos[0].swapchainFormat};
         pipelineCI.depthFormat = m_depthSwapchainInfos[0].swapchainFormat;
+        // With multiview, each draw covers every layer of the array swapchain images, one per view.
+        pipelineCI.viewMask = m_multiview ? (1u << m_viewConfigurationViews.size()) - 1 : 0;
+        // The layout is in the order the descriptors are set in DrawCuboids(), as D3D12 assigns root parameters by order.
         pipelineCI.layout = {{0, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX},
                              {1, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX},
+                             {3, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX},
                              {2, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}};
-        m_pipeline = m_graphicsAPI->CreatePipeline(pipelineCI);
+        // The placeholder differs only in its fragment shader, which is trivial, so it is built here without much of a stall.
+        GraphicsAPI::PipelineCreateInfo placeholderPipelineCI = pipelineCI;
+        placeholderPipelineCI.shaders = {m_vertexShader, m_placeholderFragmentShader};
+        m_placeholderPipeline = m_graphicsAPI->CreatePipeline(placeholderPipelineCI);
+        // Built in the background while the blocks are set up and the first frames are drawn with the placeholder, rather than stalling here.
+        m_asyncPipeline = m_graphicsAPI->CreatePipelineAsync(pipelineCI, m_placeholderPipeline);
+        m_pipelineBuildStart = std::chrono::steady_clock::now();
         // XR_DOCS_TAG_END_CreateResources3
 
+        const auto setupStart = std::chrono::steady_clock::now();
+        m_blocks.reserve(m_maxBlockCount);
+        m_blockGrid.reserve(m_maxBlockCount);
         // XR_DOCS_TAG_BEGIN_Setup_Blocks
-        // Create sixty-four cubic blocks, 20cm wide, evenly distributed,
+        // Create a grid of cubic blocks, sixty-four by default, 20cm wide, evenly distributed,
         // and randomly colored.
         float scale = 0.2f;
-        // Center the blocks a little way from the origin.
+        // Center the blocks a little way from the origin. Larger grids grow upwards, sideways and away from the viewer.
         XrVector3f center = {0.0f, -0.2f, -0.7f};
-        for (int i = 0; i < 4; i++) {
-            float x = scale * (float(i) - 1.5f) + center.x;
-            for (int j = 0; j < 4; j++) {
+        for (uint32_t i = 0; i < m_blockGridSize[0]; i++) {
+            float x = scale * (float(i) - 0.5f * float(m_blockGridSize[0] - 1)) + center.x;
+            for (uint32_t j = 0; j < m_blockGridSize[1]; j++) {
                 float y = scale * (float(j) - 1.5f) + center.y;
-                for (int k = 0; k < 4; k++) {
+                for (uint32_t k = 0; k < m_blockGridSize[2]; k++) {
                     float angleRad = 0;
-                    float z = scale * (float(k) - 1.5f) + center.z;
+                    float z = scale * (float(k) - float(m_blockGridSize[2] - 1) + 1.5f) + center.z;
                     XrQuaternionf q;
                     XrVector3f axis = {0.0f, 0.707f, 0.707f};
                     XrQuaternionf_CreateFromAxisAngle(&q, &axis, angleRad);
                     XrVector3f color = {pseudorandom_distribution(pseudo_random_generator), pseudorandom_distribution(pseudo_random_generator), pseudorandom_distribution(pseudo_random_generator)};
                     m_blocks.push_back({{q, {x, y, z}}, {0.095f, 0.095f, 0.095f}, color});
+                    InsertBlockInGrid(int(m_blocks.size()) - 1);
                 }
             }
         }
         // XR_DOCS_TAG_END_Setup_Blocks
+        XR_TUT_LOG("Created " << m_blocks.size() << " blocks in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count() << " ms.");
+
+        // Run the per-frame work on one thread per core, including this one. XR_TUTORIAL_THREADS overrides the count, and 1 runs
+        // everything on this thread.
+        size_t threadCount = 0;
+        if (const char *threads = std::getenv("XR_TUTORIAL_THREADS")) {
+            threadCount = std::max<size_t>(std::strtoul(threads, nullptr, 10), 1);
+        }
+        m_jobSystem.reset(new JobSystem(threadCount));
+        CreateInteractionGraph();
+        XR_TUT_LOG("Running frame jobs on " << m_jobSystem->GetThreadCount() << " threads" << (m_graphicsAPI->SupportsCommandLists() ? ", and recording large scenes in parallel." : "."));
     }
     void DestroyResources() {
+        m_jobSystem.reset();
+
         // XR_DOCS_TAG_BEGIN_DestroyResources
-        m_graphicsAPI->DestroyPipeline(m_pipeline);
+        // Waits for the pipeline if it is still being built, so that it is in the saved pipeline cache.
+        m_graphicsAPI->DestroyAsyncPipeline(m_asyncPipeline);
+        m_graphicsAPI->DestroyPipeline(m_placeholderPipeline);
+        m_pipeline = nullptr;
+        m_graphicsAPI->DestroyShader(m_placeholderFragmentShader);
         m_graphicsAPI->DestroyShader(m_fragmentShader);
         m_graphicsAPI->DestroyShader(m_vertexShader);
-        m_graphicsAPI->DestroyBuffer(m_uniformBuffer_Camera);
-        m_graphicsAPI->DestroyBuffer(m_uniformBuffer_Normals);
-        m_graphicsAPI->DestroyBuffer(m_indexBuffer);
-        m_graphicsAPI->DestroyBuffer(m_vertexBuffer);
+        DestroyCuboidMesh(m_sceneMesh);
+        DestroyCuboidMesh(m_cubeMesh);
         // XR_DOCS_TAG_END_DestroyResources
+        m_graphicsAPI->SavePipelineCache(GetDataFilePath("PipelineCache.bin"));
     }
 
     void PollEvents() {
@@ -927,31 +1139,96 @@ private:
         pos.z = float(z) / 10.f;
         return pos;
     }
+    // The key of the 10cm cell of m_blockGrid that contains a position, using the same rounding as FixPosition().
+    static uint64_t GetBlockGridKey(int x, int y, int z) {
+        // 21 bits per axis covers +/-100km.
+        const uint64_t mask = (uint64_t(1) << 21) - 1;
+        return (uint64_t(x) & mask) << 42 | (uint64_t(y) & mask) << 21 | (uint64_t(z) & mask);
+    }
+    static uint64_t GetBlockGridKey(const XrVector3f &pos) {
+        return GetBlockGridKey(int(std::nearbyint(pos.x * 10.f)), int(std::nearbyint(pos.y * 10.f)), int(std::nearbyint(pos.z * 10.f)));
+    }
+    void InsertBlockInGrid(int block) {
+        m_blockGrid[GetBlockGridKey(m_blocks[block].pose.position)].push_back(block);
+    }
+    void RemoveBlockFromGrid(int block) {
+        auto it = m_blockGrid.find(GetBlockGridKey(m_blocks[block].pose.position));
+        if (it == m_blockGrid.end()) {
+            return;
+        }
+        std::vector<int> &cell = it->second;
+        cell.erase(std::remove(cell.begin(), cell.end(), block), cell.end());
+        if (cell.empty()) {
+            m_blockGrid.erase(it);
+        }
+    }
+    // Returns the index of the nearest block within 10cm of the position, or -1.
+    int FindNearBlock(const XrVector3f &pos) {
+        // A block less than 10cm away on every axis is at most one cell away, so only the 27 surrounding cells are searched.
+        const int cx = int(std::nearbyint(pos.x * 10.f));
+        const int cy = int(std::nearbyint(pos.y * 10.f));
+        const int cz = int(std::nearbyint(pos.z * 10.f));
+        int nearBlock = -1;
+        float nearest = 1.0f;
+        for (int x = cx - 1; x <= cx + 1; x++) {
+            for (int y = cy - 1; y <= cy + 1; y++) {
+                for (int z = cz - 1; z <= cz + 1; z++) {
+                    auto it = m_blockGrid.find(GetBlockGridKey(x, y, z));
+                    if (it == m_blockGrid.end()) {
+                        continue;
+                    }
+                    for (int j : it->second) {
+                        // How far is it from the hand to this block?
+                        XrVector3f diff = m_blocks[j].pose.position - pos;
+                        float distance = std::max(fabs(diff.x), std::max(fabs(diff.y), fabs(diff.z)));
+                        // Ties go to the lowest index, as they would when scanning m_blocks in order.
+                        if (distance < 0.1f && (distance < nearest || (distance == nearest && j < nearBlock))) {
+                            nearBlock = j;
+                            nearest = distance;
+                        }
+                    }
+                }
+            }
+        }
+        return nearBlock;
+    }
+    // Builds m_interactionGraph: the searches for the block near each hand run in parallel, and then ApplyBlockInteraction().
+    void CreateInteractionGraph() {
+        m_interactionGraph.Clear();
+        const JobSystem::TaskGraph::TaskId findNearBlocks[2] = {
+            m_interactionGraph.AddTask([this]() { FindNearBlockForHand(0); }),
+            m_interactionGraph.AddTask([this]() { FindNearBlockForHand(1); })};
+        m_interactionGraph.AddTask([this]() { ApplyBlockInteraction(); }, {findNearBlocks[0], findNearBlocks[1]});
+    }
+    void FindNearBlockForHand(int i) {
+        m_foundNearBlock[i] = -1;
+        // Only if not currently holding a block, and the pose was detected this frame:
+        if (m_grabbedBlock[i] == -1 && m_handPoseState[i].isActive) {
+            m_foundNearBlock[i] = FindNearBlock(m_handPose[i].position);
+        }
+    }
     // Handle the interaction between the user's hands, the grab action, and the 3D blocks.
     void BlockInteraction() {
+        m_jobSystem->Run(m_interactionGraph);
+    }
+    void ApplyBlockInteraction() {
+        // Whether a block has entered or left m_blockGrid since m_foundNearBlock was searched for.
+        bool blockGridChanged = false;
         // For each hand:
         for (int i = 0; i < 2; i++) {
-            float nearest = 1.0f;
             // If not currently holding a block:
             if (m_grabbedBlock[i] == -1) {
-                m_nearBlock[i] = -1;
-                // Only if the pose was detected this frame:
-                if (m_handPoseState[i].isActive) {
-                    // For each block:
-                    for (int j = 0; j < m_blocks.size(); j++) {
-                        auto block = m_blocks[j];
-                        // How far is it from the hand to this block?
-                        XrVector3f diff = block.pose.position - m_handPose[i].position;
-                        float distance = std::max(fabs(diff.x), std::max(fabs(diff.y), fabs(diff.z)));
-                        if (distance < 0.1f && distance < nearest) {
-                            m_nearBlock[i] = j;
-                            nearest = distance;
-                        }
-                    }
+                m_nearBlock[i] = m_foundNearBlock[i];
+                // Search again if the other hand grabbed or released a block, as the searches ran together before either did.
+                if (blockGridChanged && m_handPoseState[i].isActive) {
+                    m_nearBlock[i] = FindNearBlock(m_handPose[i].position);
                 }
                 if (m_nearBlock[i] != -1) {
                     if (m_grabState[i].isActive && m_grabState[i].currentState > 0.5f) {
                         m_grabbedBlock[i] = m_nearBlock[i];
+                        // A held block follows the hand, so it leaves the grid until it is released.
+                        RemoveBlockFromGrid(m_grabbedBlock[i]);
+                        blockGridChanged = true;
                         m_buzz[i] = 1.0f;
                     } else if (m_changeColorState[i].isActive == XR_TRUE && m_changeColorState[i].currentState == XR_FALSE && m_changeColorState[i].changedSinceLastSync == XR_TRUE) {
                         auto &thisBlock = m_blocks[m_nearBlock[i]];
@@ -965,6 +1242,8 @@ private:
                     m_blocks[m_grabbedBlock[i]].pose.position = m_handPose[i].position;
                 if (!m_grabState[i].isActive || m_grabState[i].currentState < 0.5f) {
                     m_blocks[m_grabbedBlock[i]].pose.position = FixPosition(m_blocks[m_grabbedBlock[i]].pose.position);
+                    InsertBlockInGrid(m_grabbedBlock[i]);
+                    blockGridChanged = true;
                     m_grabbedBlock[i] = -1;
                     m_buzz[i] = 0.2f;
                 }
@@ -1003,14 +1282,20 @@ private:
         }
         // XR_DOCS_TAG_END_EnumerateSwapchainFormats
 
+        // With multiview, both views are drawn in one pass to the layers of a single array swapchain.
+        m_multiview = ShouldUseMultiview();
+        const size_t swapchainCount = m_multiview ? 1 : m_viewConfigurationViews.size();
+        const uint32_t swapchainArraySize = m_multiview ? static_cast<uint32_t>(m_viewConfigurationViews.size()) : 1;
+        XR_TUT_LOG("Rendering " << m_viewConfigurationViews.size() << " views " << (m_multiview ? "in one pass with multiview." : "in one pass per view."));
+
         // XR_DOCS_TAG_BEGIN_ResizeSwapchainInfos
         //Resize the SwapchainInfo to match the number of view in the View Configuration.
-        m_colorSwapchainInfos.resize(m_viewConfigurationViews.size());
-        m_depthSwapchainInfos.resize(m_viewConfigurationViews.size());
+        m_colorSwapchainInfos.resize(swapchainCount);
+        m_depthSwapchainInfos.resize(swapchainCount);
         // XR_DOCS_TAG_END_ResizeSwapchainInfos
 
-        // Per view, create a color and depth swapchain, and their associated image views.
-        for (size_t i = 0; i < m_viewConfigurationViews.size(); i++) {
+        // Per view, or once for all views with multiview, create a color and depth swapchain, and their associated image views.
+        for (size_t i = 0; i < swapchainCount; i++) {
             // XR_DOCS_TAG_BEGIN_CreateSwapchains
             SwapchainInfo &colorSwapchainInfo = m_colorSwapchainInfos[i];
             SwapchainInfo &depthSwapchainInfo = m_depthSwapchainInfos[i];
@@ -1025,7 +1310,7 @@ private:
             swapchainCI.width = m_viewConfigurationViews[i].recommendedImageRectWidth;
             swapchainCI.height = m_viewConfigurationViews[i].recommendedImageRectHeight;
             swapchainCI.faceCount = 1;
-            swapchainCI.arraySize = 1;
+            swapchainCI.arraySize = swapchainArraySize;
             swapchainCI.mipCount = 1;
             OPENXR_CHECK(xrCreateSwapchain(m_session, &swapchainCI, &colorSwapchainInfo.swapchain), "Failed to create Color Swapchain");
             colorSwapchainInfo.swapchainFormat = swapchainCI.format;  // Save the swapchain format for later use.
@@ -1038,7 +1323,7 @@ private:
             swapchainCI.width = m_viewConfigurationViews[i].recommendedImageRectWidth;
             swapchainCI.height = m_viewConfigurationViews[i].recommendedImageRectHeight;
             swapchainCI.faceCount = 1;
-            swapchainCI.arraySize = 1;
+            swapchainCI.arraySize = swapchainArraySize;
             swapchainCI.mipCount = 1;
             OPENXR_CHECK(xrCreateSwapchain(m_session, &swapchainCI, &depthSwapchainInfo.swapchain), "Failed to create Depth Swapchain");
             depthSwapchainInfo.swapchainFormat = swapchainCI.format;  // Save the swapchain format for later use.
@@ -1063,36 +1348,53 @@ private:
                 GraphicsAPI::ImageViewCreateInfo imageViewCI;
                 imageViewCI.image = m_graphicsAPI->GetSwapchainImage(colorSwapchainInfo.swapchain, j);
                 imageViewCI.type = GraphicsAPI::ImageViewCreateInfo::Type::RTV;
-                imageViewCI.view = GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D;
+                imageViewCI.view = m_multiview ? GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D_ARRAY : GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D;
                 imageViewCI.format = colorSwapchainInfo.swapchainFormat;
                 imageViewCI.aspect = GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT;
                 imageViewCI.baseMipLevel = 0;
                 imageViewCI.levelCount = 1;
                 imageViewCI.baseArrayLayer = 0;
-                imageViewCI.layerCount = 1;
+                imageViewCI.layerCount = swapchainArraySize;
                 colorSwapchainInfo.imageViews.push_back(m_graphicsAPI->CreateImageView(imageViewCI));
             }
             for (uint32_t j = 0; j < depthSwapchainImageCount; j++) {
                 GraphicsAPI::ImageViewCreateInfo imageViewCI;
                 imageViewCI.image = m_graphicsAPI->GetSwapchainImage(depthSwapchainInfo.swapchain, j);
                 imageViewCI.type = GraphicsAPI::ImageViewCreateInfo::Type::DSV;
-                imageViewCI.view = GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D;
+                imageViewCI.view = m_multiview ? GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D_ARRAY : GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D;
                 imageViewCI.format = depthSwapchainInfo.swapchainFormat;
                 imageViewCI.aspect = GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT;
                 imageViewCI.baseMipLevel = 0;
                 imageViewCI.levelCount = 1;
                 imageViewCI.baseArrayLayer = 0;
-                imageViewCI.layerCount = 1;
+                imageViewCI.layerCount = swapchainArraySize;
                 depthSwapchainInfo.imageViews.push_back(m_graphicsAPI->CreateImageView(imageViewCI));
             }
             // XR_DOCS_TAG_END_CreateImageViews
         }
     }
 
+    // Multiview needs the graphics API to support it, and the two views of a stereo view configuration, as in the multiview
+    // vertex shaders, to share a swapchain size. XR_TUTORIAL_MULTIVIEW=0 draws each view in its own pass instead.
+    bool ShouldUseMultiview() {
+        if (!m_graphicsAPI->SupportsMultiview() || m_viewConfigurationViews.size() != 2) {
+            return false;
+        }
+        for (const XrViewConfigurationView &viewConfigurationView : m_viewConfigurationViews) {
+            if (viewConfigurationView.recommendedImageRectWidth != m_viewConfigurationViews[0].recommendedImageRectWidth
+                || viewConfigurationView.recommendedImageRectHeight != m_viewConfigurationViews[0].recommendedImageRectHeight
+                || viewConfigurationView.recommendedSwapchainSampleCount != m_viewConfigurationViews[0].recommendedSwapchainSampleCount) {
+                return false;
+            }
+        }
+        const char *multiview = std::getenv("XR_TUTORIAL_MULTIVIEW");
+        return !multiview || std::string(multiview) != "0";
+    }
+
     void DestroySwapchains() {
         // XR_DOCS_TAG_BEGIN_DestroySwapchains
-        // Per view in the view configuration:
-        for (size_t i = 0; i < m_viewConfigurationViews.size(); i++) {
+        // Per swapchain, one per view in the view configuration, or one for all views with multiview:
+        for (size_t i = 0; i < m_colorSwapchainInfos.size(); i++) {
             SwapchainInfo &colorSwapchainInfo = m_colorSwapchainInfos[i];
             SwapchainInfo &depthSwapchainInfo = m_depthSwapchainInfos[i];
 
@@ -1116,30 +1418,194 @@ private:
     }
 
     // XR_DOCS_TAG_BEGIN_RenderCuboid1
-    size_t renderCuboidIndex = 0;
+    std::vector<CuboidInstance> m_cuboidInstances;
+    // The queued transforms as structure-of-arrays: translation x, y, z, rotation x, y, z, w and scale x, y, z.
+    std::vector<float> m_cuboidTransforms[10];
+    // The queued instances from this index onwards are the hand joints.
+    size_t m_handCuboidFirstInstance = 0;
     // XR_DOCS_TAG_END_RenderCuboid1
+    // Cuboid instances drawn and culled by CullCuboids(), summed over the views of the current frame.
+    struct CullStatistics {
+        size_t visible = 0;
+        size_t culled = 0;
+    };
+    // Scratch space for CullCuboids(), which leaves the instances for DrawCuboids() in visibleInstances.
+    // Each prepared pass has its own, and so does each command list recorded in parallel.
+    struct CuboidScratch {
+        std::vector<XrMatrix4x4f> modelViewProjs;
+        std::vector<CuboidInstance> visibleInstances;
+        CullStatistics cullStatistics;
+    };
+    std::vector<CuboidScratch> m_commandListCuboidScratch;
+    // The view-projections and culled cuboids of a render pass, which draws one view, or every view with multiview. All the
+    // passes are prepared at once by PreparePass().
+    struct PreparedPass {
+        CameraConstants cameraConstants;
+        uint32_t viewCount = 0;
+        CuboidScratch scene;
+        CuboidScratch hands;
+    };
+    std::vector<PreparedPass> m_preparedPasses;
+    std::vector<void *> m_commandLists;
     void RenderCuboid(XrPosef pose, XrVector3f scale, XrVector3f color) {
         // XR_DOCS_TAG_BEGIN_RenderCuboid2
-        XrMatrix4x4f_CreateTranslationRotationScale(&cameraConstants.model, &pose.position, &pose.orientation, &scale);
+        // Queue an instance of the cuboid. The queued instances are drawn for each view by DrawCuboids().
+        // The model matrix is filled in later for all the instances at once by UpdateCuboidModels().
+        SetCuboid(QueueCuboids(1), pose, scale, color);
+        // XR_DOCS_TAG_END_RenderCuboid2
+    }
+
+    // Queues count instances, to be filled in by SetCuboid(), and returns the index of the first. The instances can then be
+    // filled in from several threads at once.
+    size_t QueueCuboids(size_t count) {
+        const size_t firstInstance = m_cuboidInstances.size();
+        for (std::vector<float> &transform : m_cuboidTransforms) {
+            transform.resize(firstInstance + count);
+        }
+        m_cuboidInstances.resize(firstInstance + count);
+        return firstInstance;
+    }
+    void SetCuboid(size_t instance, const XrPosef &pose, const XrVector3f &scale, const XrVector3f &color) {
+        const float transform[10] = {pose.position.x, pose.position.y, pose.position.z, pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w, scale.x, scale.y, scale.z};
+        for (int i = 0; i < 10; i++) {
+            m_cuboidTransforms[i][instance] = transform[i];
+        }
+        m_cuboidInstances[instance].color = {color.x, color.y, color.z, 1.0};
+    }
+
+    // The transforms of the queued instances from firstInstance onwards.
+    XrTransformArraysf GetCuboidTransforms(size_t firstInstance = 0) const {
+        const std::vector<float> *t = m_cuboidTransforms;
+        return {{t[0].data() + firstInstance, t[1].data() + firstInstance, t[2].data() + firstInstance},
+                {t[3].data() + firstInstance, t[4].data() + firstInstance, t[5].data() + firstInstance, t[6].data() + firstInstance},
+                {t[7].data() + firstInstance, t[8].data() + firstInstance, t[9].data() + firstInstance}};
+    }
+
+    void UpdateCuboidModels() {
+        // Split across the threads in ranges that are large enough to keep the batch loop busy.
+        m_jobSystem->ParallelFor(m_cuboidInstances.size(), m_cuboidsPerJob, [this](size_t begin, size_t end) {
+            const XrTransformArraysf transforms = GetCuboidTransforms(begin);
+            // Written in place between the colors. The view-projection stays in CameraConstants, as the shader also needs the model matrix for the normals.
+            XrMatrix4x4f_CreateTranslationRotationScale_Batch(&m_cuboidInstances[begin].model, sizeof(CuboidInstance), &transforms, end - begin);
+        });
+    }
+
+    // Collects the queued instances in [firstInstance, endInstance) whose bounds intersect the frustum of any of the viewCount
+    // views into scratch.visibleInstances.
+    void CullCuboids(const XrMatrix4x4f *viewProjs, uint32_t viewCount, size_t firstInstance, size_t endInstance, CuboidScratch &scratch, CullStatistics &cullStatistics) {
+        std::vector<XrMatrix4x4f> &modelViewProjs = scratch.modelViewProjs;
+        std::vector<CuboidInstance> &visibleInstances = scratch.visibleInstances;
+        visibleInstances.clear();
+        const size_t instanceCount = endInstance > firstInstance ? endInstance - firstInstance : 0;
+        if (instanceCount == 0) {
+            return;
+        }
+        const XrTransformArraysf transforms = GetCuboidTransforms(firstInstance);
+        modelViewProjs.resize(instanceCount * viewCount);
+        XrMatrix4x4f_CreateModelViewProjection_Batch(modelViewProjs.data(), 0, viewProjs, viewCount, &transforms, instanceCount);
+
+        // The bounds of the 1x1x1 meter cube in vertexPositions.
+        const XrVector3f mins = {-0.5f, -0.5f, -0.5f};
+        const XrVector3f maxs = {+0.5f, +0.5f, +0.5f};
+        for (size_t i = 0; i < instanceCount; i++) {
+            for (uint32_t v = 0; v < viewCount; v++) {
+                if (!XrMatrix4x4f_CullBounds(&modelViewProjs[v * instanceCount + i], &mins, &maxs)) {
+                    visibleInstances.push_back(m_cuboidInstances[firstInstance + i]);
+                    break;
+                }
+            }
+        }
+        cullStatistics.visible += visibleInstances.size();
+        cullStatistics.culled += instanceCount - visibleInstances.size();
+    }
 
-        XrMatrix4x4f_Multiply(&cameraConstants.modelViewProj, &cameraConstants.viewProj, &cameraConstants.model);
-        cameraConstants.color = {color.x, color.y, color.z, 1.0};
-        size_t offsetCameraUB = sizeof(CameraConstants) * renderCuboidIndex;
+    void DrawCuboids(const std::vector<CuboidInstance> &visibleInstances, const CuboidMesh &mesh) {
+        const GraphicsAPI::TransientUniform camera = m_graphicsAPI->AllocateTransientUniform(sizeof(CameraConstants), &cameraConstants);
 
+        void *vertexBuffer = mesh.vertexBuffer;
         m_graphicsAPI->SetPipeline(m_pipeline);
+        m_graphicsAPI->SetVertexBuffers(&vertexBuffer, 1);
+        m_graphicsAPI->SetIndexBuffer(mesh.indexBuffer);
 
-        m_graphicsAPI->SetBufferData(m_uniformBuffer_Camera, offsetCameraUB, sizeof(CameraConstants), &cameraConstants);
-        m_graphicsAPI->SetDescriptor({0, m_uniformBuffer_Camera, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, offsetCameraUB, sizeof(CameraConstants)});
-        m_graphicsAPI->SetDescriptor({1, m_uniformBuffer_Normals, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, 0, sizeof(normals)});
+        // One instanced draw for each batch of instances that fits in the shader's instances[] array.
+        const size_t instanceCount = visibleInstances.size();
+        for (size_t firstInstance = 0; firstInstance < instanceCount; firstInstance += m_maxCuboidInstancesPerDraw) {
+            const size_t batchCount = std::min(instanceCount - firstInstance, m_maxCuboidInstancesPerDraw);
+            // The slice covers the whole instances[] array, as the shader's uniform block is that size, but only the batch is copied.
+            const GraphicsAPI::TransientUniform instances = m_graphicsAPI->AllocateTransientUniform(sizeof(CuboidInstance) * m_maxCuboidInstancesPerDraw, &visibleInstances[firstInstance], sizeof(CuboidInstance) * batchCount);
 
-        m_graphicsAPI->UpdateDescriptors();
+            m_graphicsAPI->SetDescriptor({0, camera.buffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, camera.offset, camera.size});
+            m_graphicsAPI->SetDescriptor({1, mesh.constantsBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, 0, sizeof(MeshConstants)});
+            m_graphicsAPI->SetDescriptor({3, instances.buffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, instances.offset, instances.size});
 
-        m_graphicsAPI->SetVertexBuffers(&m_vertexBuffer, 1);
-        m_graphicsAPI->SetIndexBuffer(m_indexBuffer);
-        m_graphicsAPI->DrawIndexed(36);
+            m_graphicsAPI->UpdateDescriptors();
 
-        renderCuboidIndex++;
-        // XR_DOCS_TAG_END_RenderCuboid2
+            m_graphicsAPI->DrawIndexed(mesh.indexCount, static_cast<uint32_t>(batchCount));
+        }
+    }
+
+    // Computes the view-projections of the pass's viewCount views, and culls the hand joints, and the rest of the scene if
+    // cullScene is set, into preparedPass. Each pass is prepared by its own job.
+    void PreparePass(const XrView *views, uint32_t viewCount, float nearZ, float farZ, bool cullScene, PreparedPass &preparedPass) {
+        preparedPass.viewCount = viewCount;
+        for (uint32_t v = 0; v < viewCount; v++) {
+            // Compute the view-projection transform.
+            // All matrices (including OpenXR's) are column-major, right-handed.
+            XrMatrix4x4f proj;
+            XrMatrix4x4f_CreateProjectionFov(&proj, m_apiType, views[v].fov, nearZ, farZ);
+            XrMatrix4x4f toView;
+            XrVector3f scale1m{1.0f, 1.0f, 1.0f};
+            XrMatrix4x4f_CreateTranslationRotationScale(&toView, &views[v].pose.position, &views[v].pose.orientation, &scale1m);
+            XrMatrix4x4f viewMatrix;
+            XrMatrix4x4f_InvertRigidBody(&viewMatrix, &toView);
+            XrMatrix4x4f_Multiply(&preparedPass.cameraConstants.viewProj[v], &proj, &viewMatrix);
+        }
+
+        const XrMatrix4x4f *viewProjs = preparedPass.cameraConstants.viewProj;
+        preparedPass.scene.cullStatistics = {};
+        preparedPass.hands.cullStatistics = {};
+        if (cullScene) {
+            CullCuboids(viewProjs, viewCount, 0, m_handCuboidFirstInstance, preparedPass.scene, preparedPass.scene.cullStatistics);
+        } else {
+            preparedPass.scene.visibleInstances.clear();
+        }
+        CullCuboids(viewProjs, viewCount, m_handCuboidFirstInstance, m_cuboidInstances.size(), preparedPass.hands, preparedPass.hands.cullStatistics);
+    }
+
+    // The number of command lists to split instanceCount cuboids across, or 0 to record them on the rendering thread, if the
+    // backend can't record command lists or there are too few cuboids to be worth splitting.
+    size_t GetCuboidCommandListCount(size_t instanceCount) const {
+        if (!m_graphicsAPI->SupportsCommandLists() || m_jobSystem->GetThreadCount() == 1 || instanceCount < 2 * m_minCuboidsPerCommandList) {
+            return 0;
+        }
+        return std::min(m_jobSystem->GetThreadCount(), instanceCount / m_minCuboidsPerCommandList);
+    }
+
+    // Culls and draws the queued instances in [firstInstance, endInstance) as chunkCount chunks, each recorded into a command
+    // list by one of m_jobSystem's threads, and then executes the command lists in order.
+    void CullAndDrawCuboidsInParallel(const XrMatrix4x4f *viewProjs, uint32_t viewCount, size_t firstInstance, size_t endInstance, size_t chunkCount) {
+        const size_t instanceCount = endInstance - firstInstance;
+        if (m_commandListCuboidScratch.size() < chunkCount) {
+            m_commandListCuboidScratch.resize(chunkCount);
+        }
+        m_commandLists.assign(chunkCount, nullptr);
+
+        // One chunk per job. The backend tracks the command list being recorded per thread, so a chunk must not run other
+        // jobs, by waiting on the JobSystem, between BeginCommandList() and EndCommandList().
+        m_jobSystem->ParallelFor(chunkCount, 1, [&](size_t chunk, size_t) {
+            CuboidScratch &scratch = m_commandListCuboidScratch[chunk];
+            scratch.cullStatistics = {};
+            m_commandLists[chunk] = m_graphicsAPI->BeginCommandList();
+            CullCuboids(viewProjs, viewCount, firstInstance + instanceCount * chunk / chunkCount, firstInstance + instanceCount * (chunk + 1) / chunkCount, scratch, scratch.cullStatistics);
+            DrawCuboids(scratch.visibleInstances, GetSceneMesh());
+            m_graphicsAPI->EndCommandList(m_commandLists[chunk]);
+        });
+        m_graphicsAPI->ExecuteCommandLists(m_commandLists.data(), chunkCount);
+
+        for (size_t i = 0; i < chunkCount; i++) {
+            m_cullStatistics.visible += m_commandListCuboidScratch[i].cullStatistics.visible;
+            m_cullStatistics.culled += m_commandListCuboidScratch[i].cullStatistics.culled;
+        }
     }
 
     void RenderFrame() {
@@ -1148,11 +1614,17 @@ private:
         // Get the XrFrameState for timing and rendering info.
         XrFrameState frameState{XR_TYPE_FRAME_STATE};
         XrFrameWaitInfo frameWaitInfo{XR_TYPE_FRAME_WAIT_INFO};
+        m_frameTiming.BeginFrame();
+        m_frameTiming.BeginStage(FrameTiming::Stage::WAIT_FRAME);
         OPENXR_CHECK(xrWaitFrame(m_session, &frameWaitInfo, &frameState), "Failed to wait for XR Frame.");
+        m_frameTiming.EndStage(FrameTiming::Stage::WAIT_FRAME);
+        m_frameTiming.SetDisplayTiming(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
 
         // Tell the OpenXR compositor that the application is beginning the frame.
         XrFrameBeginInfo frameBeginInfo{XR_TYPE_FRAME_BEGIN_INFO};
+        m_frameTiming.BeginStage(FrameTiming::Stage::BEGIN_FRAME);
         OPENXR_CHECK(xrBeginFrame(m_session, &frameBeginInfo), "Failed to begin the XR Frame.");
+        m_frameTiming.EndStage(FrameTiming::Stage::BEGIN_FRAME);
 
         // Variables for rendering and layer composition.
         bool rendered = false;
@@ -1165,13 +1637,19 @@ private:
 #if XR_DOCS_CHAPTER_VERSION >= XR_DOCS_CHAPTER_4_2
             // XR_DOCS_TAG_BEGIN_CallPollActions
             // poll actions here because they require a predicted display time, which we've only just obtained.
+            m_frameTiming.BeginStage(FrameTiming::Stage::POLL_ACTIONS);
             PollActions(frameState.predictedDisplayTime);
+            m_frameTiming.EndStage(FrameTiming::Stage::POLL_ACTIONS);
             // Handle the interaction between the user and the 3D blocks.
+            m_frameTiming.BeginStage(FrameTiming::Stage::BLOCK_INTERACTION);
             BlockInteraction();
+            m_frameTiming.EndStage(FrameTiming::Stage::BLOCK_INTERACTION);
             // XR_DOCS_TAG_END_CallPollActions
 #endif
             // Render the stereo image and associate one of swapchain images with the XrCompositionLayerProjection structure.
+            m_frameTiming.BeginStage(FrameTiming::Stage::RECORD_VIEWS);
             rendered = RenderLayer(renderLayerInfo);
+            m_frameTiming.EndStage(FrameTiming::Stage::RECORD_VIEWS);
             if (rendered) {
                 renderLayerInfo.layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader *>(&renderLayerInfo.layerProjection));
             }
@@ -1183,7 +1661,10 @@ private:
         frameEndInfo.environmentBlendMode = m_environmentBlendMode;
         frameEndInfo.layerCount = static_cast<uint32_t>(renderLayerInfo.layers.size());
         frameEndInfo.layers = renderLayerInfo.layers.data();
+        m_frameTiming.BeginStage(FrameTiming::Stage::END_FRAME);
         OPENXR_CHECK(xrEndFrame(m_session, &frameEndInfo), "Failed to end the XR Frame.");
+        m_frameTiming.EndStage(FrameTiming::Stage::END_FRAME);
+        m_frameTiming.EndFrame();
         // XR_DOCS_TAG_END_RenderFrame
 #endif
     }
@@ -1213,32 +1694,102 @@ private:
         // XR_DOCS_TAG_END_ResizeLeyerDepthInfos
 #endif
 
-        // Per view in the view configuration:
-        for (uint32_t i = 0; i < viewCount; i++) {
-            SwapchainInfo &colorSwapchainInfo = m_colorSwapchainInfos[i];
-            SwapchainInfo &depthSwapchainInfo = m_depthSwapchainInfos[i];
-
-            // Acquire and wait for an image from the swapchains.
-            // Get the image index of an image in the swapchains.
-            // The timeout is infinite.
-            uint32_t colorImageIndex = 0;
-            uint32_t depthImageIndex = 0;
-            XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
-            OPENXR_CHECK(xrAcquireSwapchainImage(colorSwapchainInfo.swapchain, &acquireInfo, &colorImageIndex), "Failed to acquire Image from the Color Swapchian");
-            OPENXR_CHECK(xrAcquireSwapchainImage(depthSwapchainInfo.swapchain, &acquireInfo, &depthImageIndex), "Failed to acquire Image from the Depth Swapchian");
+        // Queue the cuboids for this frame. The instances are shared by all views, so each view only needs its own view-projection.
+        m_frameTiming.BeginStage(FrameTiming::Stage::QUEUE_CUBOIDS);
+        // XR_DOCS_TAG_BEGIN_CallRenderCuboid
+        m_cuboidInstances.clear();
+        for (std::vector<float> &transform : m_cuboidTransforms) {
+            transform.clear();
+        }
+        // Draw a floor. Scale it by 2 in the X and Z, and 0.1 in the Y,
+        RenderCuboid({{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, -m_viewHeightM, 0.0f}}, {2.0f, 0.1f, 2.0f}, {0.4f, 0.5f, 0.5f});
+        // Draw a "table".
+        RenderCuboid({{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, -m_viewHeightM + 0.9f, -0.7f}}, {1.0f, 0.2f, 1.0f}, {0.6f, 0.6f, 0.4f});
+        // XR_DOCS_TAG_END_CallRenderCuboid
+
+        // XR_DOCS_TAG_BEGIN_CallRenderCuboid2
+        // Draw some blocks at the controller positions:
+        for (int j = 0; j < 2; j++) {
+            if (m_handPoseState[j].isActive) {
+                RenderCuboid(m_handPose[j], {0.02f, 0.04f, 0.10f}, {1.f, 1.f, 1.f});
+            }
+        }
+        // The blocks are queued together and filled in on all the threads.
+        const size_t firstBlockInstance = QueueCuboids(m_blocks.size());
+        m_jobSystem->ParallelFor(m_blocks.size(), m_cuboidsPerJob, [&](size_t begin, size_t end) {
+            for (int j = int(begin); j < int(end); j++) {
+                auto &thisBlock = m_blocks[j];
+                XrVector3f sc = thisBlock.scale;
+                if (j == m_nearBlock[0] || j == m_nearBlock[1])
+                    sc = thisBlock.scale * 1.05f;
+                SetCuboid(firstBlockInstance + j, thisBlock.pose, sc, thisBlock.color);
+            }
+        });
+        // XR_DOCS_TAG_END_CallRenderCuboid2
 
-            XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
-            waitInfo.timeout = XR_INFINITE_DURATION;
-            OPENXR_CHECK(xrWaitSwapchainImage(colorSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Color Swapchain");
-            OPENXR_CHECK(xrWaitSwapchainImage(depthSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Depth Swapchain");
+        // The hand joints are queued last, so that they can be drawn, and timed, separately from the rest of the scene.
+        m_handCuboidFirstInstance = m_cuboidInstances.size();
+        // XR_DOCS_TAG_BEGIN_RenderHands
+        if (handTrackingSystemProperties.supportsHandTracking) {
+            for (int j = 0; j < 2; j++) {
+                auto hand = m_hands[j];
+                XrVector3f hand_color = {1.f, 1.f, 0.f};
+                for (int k = 0; k < XR_HAND_JOINT_COUNT_EXT; k++) {
+                    XrVector3f sc = {1.5f, 1.5f, 2.5f};
+                    sc = sc * hand.m_jointLocations[k].radius;
+                    RenderCuboid(hand.m_jointLocations[k].pose, sc, hand_color);
+                }
+            }
+        }
+        // XR_DOCS_TAG_END_RenderHands
+
+        // Build the model matrices of all the queued cuboids in one pass.
+        UpdateCuboidModels();
+        m_frameTiming.EndStage(FrameTiming::Stage::QUEUE_CUBOIDS);
+        m_cullStatistics = {};
+
+        float nearZ = 0.05f;
+        float farZ = 100.0f;
+
+        // Each render pass draws one view, or, with multiview, every view to the layers of one swapchain. Multiview culls and
+        // draws the cuboids once for both eyes, rather than once per eye.
+        const uint32_t passCount = m_multiview ? 1 : viewCount;
+        const uint32_t viewsPerPass = m_multiview ? viewCount : 1;
+
+        // Prepare all the passes at once, one job each. A scene that is split into command lists is culled as it is recorded.
+        const size_t sceneCommandListCount = GetCuboidCommandListCount(m_handCuboidFirstInstance);
+        m_frameTiming.BeginStage(FrameTiming::Stage::CULL_CUBOIDS);
+        if (m_preparedPasses.size() < passCount) {
+            m_preparedPasses.resize(passCount);
+        }
+        m_jobSystem->ParallelFor(passCount, 1, [&](size_t begin, size_t) {
+            PreparePass(&views[begin * viewsPerPass], viewsPerPass, nearZ, farZ, sceneCommandListCount == 0, m_preparedPasses[begin]);
+        });
+        for (uint32_t i = 0; i < passCount; i++) {
+            for (const CuboidScratch *scratch : {&m_preparedPasses[i].scene, &m_preparedPasses[i].hands}) {
+                m_cullStatistics.visible += scratch->cullStatistics.visible;
+                m_cullStatistics.culled += scratch->cullStatistics.culled;
+            }
+        }
+        m_frameTiming.EndStage(FrameTiming::Stage::CULL_CUBOIDS);
+
+        // Draw with the placeholder pipeline until the background build has finished.
+        if (!m_pipelineReady) {
+            m_pipelineReady = m_graphicsAPI->IsAsyncPipelineReady(m_asyncPipeline);
+            m_pipeline = m_graphicsAPI->GetAsyncPipeline(m_asyncPipeline);
+            if (m_pipelineReady) {
+                XR_TUT_LOG("Pipeline ready " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_pipelineBuildStart).count() << " ms after it was requested.");
+            }
+        }
 
-            // Get the width and height and construct the viewport and scissors.
+        // Fill out the composition layer's views. With multiview, every view is a layer of its pass's swapchain images.
+        for (uint32_t i = 0; i < viewCount; i++) {
+            const uint32_t passIndex = i / viewsPerPass;
+            SwapchainInfo &colorSwapchainInfo = m_colorSwapchainInfos[passIndex];
+            SwapchainInfo &depthSwapchainInfo = m_depthSwapchainInfos[passIndex];
             const uint32_t &width = m_viewConfigurationViews[i].recommendedImageRectWidth;
             const uint32_t &height = m_viewConfigurationViews[i].recommendedImageRectHeight;
             GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
-            GraphicsAPI::Rect2D scissor = {{(int32_t)0, (int32_t)0}, {width, height}};
-            float nearZ = 0.05f;
-            float farZ = 100.0f;
 
             // Fill out the XrCompositionLayerProjectionView structure specifying the pose and fov from the view.
             // This also associates the swapchain image with this layer projection view.
@@ -1250,7 +1801,7 @@ private:
             renderLayerInfo.layerProjectionViews[i].subImage.imageRect.offset.y = 0;
             renderLayerInfo.layerProjectionViews[i].subImage.imageRect.extent.width = static_cast<int32_t>(width);
             renderLayerInfo.layerProjectionViews[i].subImage.imageRect.extent.height = static_cast<int32_t>(height);
-            renderLayerInfo.layerProjectionViews[i].subImage.imageArrayIndex = 0;  // Useful for multiview rendering.
+            renderLayerInfo.layerProjectionViews[i].subImage.imageArrayIndex = i % viewsPerPass;  // Useful for multiview rendering.
 #if XR_DOCS_CHAPTER_VERSION == XR_DOCS_CHAPTER_5_2
             // XR_DOCS_TAG_BEGIN_SetupLeyerDepthInfos
             renderLayerInfo.layerProjectionViews[i].next = &renderLayerInfo.layerDepthInfos[i];
@@ -1266,11 +1817,44 @@ private:
             renderLayerInfo.layerDepthInfos[i].nearZ = nearZ;
             renderLayerInfo.layerDepthInfos[i].farZ = farZ;
             // XR_DOCS_TAG_END_SetupLeyerDepthInfos
+            renderLayerInfo.layerDepthInfos[i].subImage.imageArrayIndex = i % viewsPerPass;
+#else
+            (void)depthSwapchainInfo;
+            (void)viewport;
 #endif
+        }
+
+        // Per render pass, one per view in the view configuration, or one for all views with multiview:
+        for (uint32_t i = 0; i < passCount; i++) {
+            m_frameTiming.BeginView(i);
+            SwapchainInfo &colorSwapchainInfo = m_colorSwapchainInfos[i];
+            SwapchainInfo &depthSwapchainInfo = m_depthSwapchainInfos[i];
+
+            // Acquire and wait for an image from the swapchains.
+            // Get the image index of an image in the swapchains.
+            // The timeout is infinite.
+            uint32_t colorImageIndex = 0;
+            uint32_t depthImageIndex = 0;
+            XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+            OPENXR_CHECK(xrAcquireSwapchainImage(colorSwapchainInfo.swapchain, &acquireInfo, &colorImageIndex), "Failed to acquire Image from the Color Swapchian");
+            OPENXR_CHECK(xrAcquireSwapchainImage(depthSwapchainInfo.swapchain, &acquireInfo, &depthImageIndex), "Failed to acquire Image from the Depth Swapchian");
+
+            XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+            waitInfo.timeout = XR_INFINITE_DURATION;
+            OPENXR_CHECK(xrWaitSwapchainImage(colorSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Color Swapchain");
+            OPENXR_CHECK(xrWaitSwapchainImage(depthSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Depth Swapchain");
+
+            // Get the width and height and construct the viewport and scissors.
+            const uint32_t &width = m_viewConfigurationViews[i].recommendedImageRectWidth;
+            const uint32_t &height = m_viewConfigurationViews[i].recommendedImageRectHeight;
+            GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
+            GraphicsAPI::Rect2D scissor = {{(int32_t)0, (int32_t)0}, {width, height}};
+
 
             // Rendering code to clear the color and depth image views.
             m_graphicsAPI->BeginRendering();
 
+            m_graphicsAPI->BeginTimestampScope("clear_view" + std::to_string(i));
             if (m_environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_OPAQUE) {
                 // VR mode use a background color.
                 m_graphicsAPI->ClearColor(colorSwapchainInfo.imageViews[colorImageIndex], 0.17f, 0.17f, 0.17f, 1.00f);
@@ -1279,70 +1863,51 @@ private:
                 m_graphicsAPI->ClearColor(colorSwapchainInfo.imageViews[colorImageIndex], 0.00f, 0.00f, 0.00f, 1.00f);
             }
             m_graphicsAPI->ClearDepth(depthSwapchainInfo.imageViews[depthImageIndex], 1.0f);
+            m_graphicsAPI->EndTimestampScope();
             // XR_DOCS_TAG_END_RenderLayer1
 
-            // XR_DOCS_TAG_BEGIN_SetupFrameRendering
-            m_graphicsAPI->SetRenderAttachments(&colorSwapchainInfo.imageViews[colorImageIndex], 1, depthSwapchainInfo.imageViews[depthImageIndex], width, height, m_pipeline);
-            m_graphicsAPI->SetViewports(&viewport, 1);
-            m_graphicsAPI->SetScissors(&scissor, 1);
-
-            // Compute the view-projection transform.
-            // All matrices (including OpenXR's) are column-major, right-handed.
-            XrMatrix4x4f proj;
-            XrMatrix4x4f_CreateProjectionFov(&proj, m_apiType, views[i].fov, nearZ, farZ);
-            XrMatrix4x4f toView;
-            XrVector3f scale1m{1.0f, 1.0f, 1.0f};
-            XrMatrix4x4f_CreateTranslationRotationScale(&toView, &views[i].pose.position, &views[i].pose.orientation, &scale1m);
-            XrMatrix4x4f view;
-            XrMatrix4x4f_InvertRigidBody(&view, &toView);
-            XrMatrix4x4f_Multiply(&cameraConstants.viewProj, &proj, &view);
-            // XR_DOCS_TAG_END_SetupFrameRendering
-
-            // XR_DOCS_TAG_BEGIN_CallRenderCuboid
-            renderCuboidIndex = 0;
-            // Draw a floor. Scale it by 2 in the X and Z, and 0.1 in the Y,
-            RenderCuboid({{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, -m_viewHeightM, 0.0f}}, {2.0f, 0.1f, 2.0f}, {0.4f, 0.5f, 0.5f});
-            // Draw a "table".
-            RenderCuboid({{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, -m_viewHeightM + 0.9f, -0.7f}}, {1.0f, 0.2f, 1.0f}, {0.6f, 0.6f, 0.4f});
-            // XR_DOCS_TAG_END_CallRenderCuboid
-
-            // XR_DOCS_TAG_BEGIN_CallRenderCuboid2
-            // Draw some blocks at the controller positions:
-            for (int j = 0; j < 2; j++) {
-                if (m_handPoseState[j].isActive) {
-                    RenderCuboid(m_handPose[j], {0.02f, 0.04f, 0.10f}, {1.f, 1.f, 1.f});
-                }
-            }
-            for (int j = 0; j < m_blocks.size(); j++) {
-                auto &thisBlock = m_blocks[j];
-                XrVector3f sc = thisBlock.scale;
-                if (j == m_nearBlock[0] || j == m_nearBlock[1])
-                    sc = thisBlock.scale * 1.05f;
-                RenderCuboid(thisBlock.pose, sc, thisBlock.color);
-            }
-            // XR_DOCS_TAG_END_CallRenderCuboid2
-
-            // XR_DOCS_TAG_BEGIN_RenderHands
-            if (handTrackingSystemProperties.supportsHandTracking) {
-                for (int j = 0; j < 2; j++) {
-                    auto hand = m_hands[j];
-                    XrVector3f hand_color = {1.f, 1.f, 0.f};
-                    for (int k = 0; k < XR_HAND_JOINT_COUNT_EXT; k++) {
-                        XrVector3f sc = {1.5f, 1.5f, 2.5f};
-                        sc = sc * hand.m_jointLocations[k].radius;
-                        RenderCuboid(hand.m_jointLocations[k].pose, sc, hand_color);
-                    }
+            // If neither pipeline could be created, the views are only cleared.
+            if (m_pipeline) {
+                // XR_DOCS_TAG_BEGIN_SetupFrameRendering
+                m_graphicsAPI->SetRenderAttachments(&colorSwapchainInfo.imageViews[colorImageIndex], 1, depthSwapchainInfo.imageViews[depthImageIndex], width, height, m_pipeline);
+                m_graphicsAPI->SetViewports(&viewport, 1);
+                m_graphicsAPI->SetScissors(&scissor, 1);
+
+                // The view-projection transforms were computed by PreparePass().
+                const PreparedPass &preparedPass = m_preparedPasses[i];
+                cameraConstants = preparedPass.cameraConstants;
+                // XR_DOCS_TAG_END_SetupFrameRendering
+
+                // Draw the queued cuboid instances that are inside the pass's frustums: first the scene, then the hand joints.
+                m_graphicsAPI->BeginTimestampScope("scene_view" + std::to_string(i));
+                m_frameTiming.BeginStage(FrameTiming::Stage::DRAW_CUBOIDS);
+                if (sceneCommandListCount > 0) {
+                    // The jobs cull and record their chunks together, so that time is all counted as drawing.
+                    CullAndDrawCuboidsInParallel(preparedPass.cameraConstants.viewProj, preparedPass.viewCount, 0, m_handCuboidFirstInstance, sceneCommandListCount);
+                } else {
+                    DrawCuboids(preparedPass.scene.visibleInstances, GetSceneMesh());
                 }
+                m_frameTiming.EndStage(FrameTiming::Stage::DRAW_CUBOIDS);
+                m_graphicsAPI->EndTimestampScope();
+
+                m_graphicsAPI->BeginTimestampScope("hands_view" + std::to_string(i));
+                m_frameTiming.BeginStage(FrameTiming::Stage::DRAW_CUBOIDS);
+                DrawCuboids(preparedPass.hands.visibleInstances, m_cubeMesh);
+                m_frameTiming.EndStage(FrameTiming::Stage::DRAW_CUBOIDS);
+                m_graphicsAPI->EndTimestampScope();
             }
-            // XR_DOCS_TAG_END_RenderHands
 
             // XR_DOCS_TAG_BEGIN_RenderLayer2
+            // The backends submit their command buffers in EndRendering().
+            m_frameTiming.BeginStage(FrameTiming::Stage::SUBMIT);
             m_graphicsAPI->EndRendering();
+            m_frameTiming.EndStage(FrameTiming::Stage::SUBMIT);
 
             // Give the swapchain image back to OpenXR, allowing the compositor to use the image.
             XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
             OPENXR_CHECK(xrReleaseSwapchainImage(colorSwapchainInfo.swapchain, &releaseInfo), "Failed to release Image back to the Color Swapchain");
             OPENXR_CHECK(xrReleaseSwapchainImage(depthSwapchainInfo.swapchain, &releaseInfo), "Failed to release Image back to the Depth Swapchain");
+            m_frameTiming.EndView(i);
         }
 
         // Fill out the XrCompositionLayerProjection structure for usage with xrEndFrame().
@@ -1351,6 +1916,21 @@ private:
         renderLayerInfo.layerProjection.viewCount = static_cast<uint32_t>(renderLayerInfo.layerProjectionViews.size());
         renderLayerInfo.layerProjection.views = renderLayerInfo.layerProjectionViews.data();
 
+        // Collect the GPU timings of earlier frames that have completed. These arrive a frame or more late and are never waited on.
+        for (const GraphicsAPI::TimestampResult &result : m_graphicsAPI->GetTimestampResults()) {
+            GpuTiming &gpuTiming = m_gpuTimings[result.name];
+            gpuTiming.totalMs += result.gpuMs;
+            gpuTiming.count++;
+        }
+
+        if (++m_cullStatisticsFrameCount % m_cullStatisticsLogInterval == 0) {
+            XR_TUT_LOG("Frustum culling: " << m_cullStatistics.visible << " cuboids drawn, " << m_cullStatistics.culled << " culled over " << viewCount << " views this frame.");
+            for (const auto &gpuTiming : m_gpuTimings) {
+                XR_TUT_LOG("GPU " << gpuTiming.first << ": " << gpuTiming.second.totalMs / static_cast<double>(gpuTiming.second.count) << " ms average over " << gpuTiming.second.count << " frames.");
+            }
+            m_gpuTimings.clear();
+        }
+
         return true;
         // XR_DOCS_TAG_END_RenderLayer2
     }
@@ -1469,6 +2049,8 @@ private:
     };
     std::vector<SwapchainInfo> m_colorSwapchainInfos = {};
     std::vector<SwapchainInfo> m_depthSwapchainInfos = {};
+    // Set by CreateSwapchains(): whether both views are drawn in one pass, to the layers of a single array swapchain.
+    bool m_multiview = false;
 
     std::vector<XrEnvironmentBlendMode> m_applicationEnvironmentBlendModes = {XR_ENVIRONMENT_BLEND_MODE_OPAQUE, XR_ENVIRONMENT_BLEND_MODE_ADDITIVE};
     std::vector<XrEnvironmentBlendMode> m_environmentBlendModes = {};
@@ -1487,22 +2069,49 @@ private:
 #endif
     };
 
+    // CPU timings of the most recent frames.
+    FrameTiming m_frameTiming;
+    // Runs the frame's interaction, cuboid transforms and view preparation, and records large scenes, on all the cores.
+    std::unique_ptr<JobSystem> m_jobSystem;
+    JobSystem::TaskGraph m_interactionGraph;
+    // GPU timings of each timestamp scope, summed since they were last logged.
+    struct GpuTiming {
+        double totalMs = 0.0;
+        uint64_t count = 0;
+    };
+    std::map<std::string, GpuTiming> m_gpuTimings;
+
     // In STAGE space, viewHeightM should be 0. In LOCAL space, it should be offset downwards, below the viewer's initial position.
     float m_viewHeightM = 1.5f;
 
-    // Vertex and index buffers: geometry for our cuboids.
-    void *m_vertexBuffer = nullptr;
-    void *m_indexBuffer = nullptr;
-    // Camera values constant buffer for the shaders.
-    void *m_uniformBuffer_Camera = nullptr;
-    // The normals are stored in a uniform buffer to simplify our vertex geometry.
-    void *m_uniformBuffer_Normals = nullptr;
-
-    // We use only two shaders in this app.
+    // Geometry for our cuboids. The hands are always drawn with the cube, and the scene's cuboids with m_sceneMesh if a mesh
+    // was loaded.
+    CuboidMesh m_cubeMesh;
+    CuboidMesh m_sceneMesh;
+    const CuboidMesh &GetSceneMesh() const { return m_sceneMesh.vertexBuffer ? m_sceneMesh : m_cubeMesh; }
+    // Must match the size of the instances[] array in VertexShader_Instanced. 128 * 80 bytes fits within the
+    // minimum guaranteed uniform buffer range (16KB) and is a multiple of 256 bytes.
+    const size_t m_maxCuboidInstancesPerDraw = 128;
+    CullStatistics m_cullStatistics;
+    // Scenes are only recorded into several command lists once each would get at least m_minCuboidsPerCommandList cuboids.
+    const size_t m_minCuboidsPerCommandList = 4096;
+    // The number of cuboids each job queues, transforms or culls when that work is split across m_jobSystem's threads.
+    const size_t m_cuboidsPerJob = 1024;
+    // The statistics are logged every m_cullStatisticsLogInterval frames.
+    uint64_t m_cullStatisticsFrameCount = 0;
+    const uint64_t m_cullStatisticsLogInterval = 300;
+
+    // We use only two shaders in this app, and a third for the placeholder pipeline.
     void *m_vertexShader = nullptr, *m_fragmentShader = nullptr;
+    void *m_placeholderFragmentShader = nullptr;
 
-    // The pipeline is a graphics-API specific state object.
+    // The pipeline is a graphics-API specific state object. It is built in the background from m_asyncPipeline, and is
+    // m_placeholderPipeline until it is ready, which draws the cuboids in flat, unlit colours.
+    void *m_asyncPipeline = nullptr;
+    void *m_placeholderPipeline = nullptr;
     void *m_pipeline = nullptr;
+    bool m_pipelineReady = false;
+    std::chrono::steady_clock::time_point m_pipelineBuildStart;
 
     // XR_DOCS_TAG_BEGIN_Objects
     // An instance of a 3d colored block.
@@ -1513,13 +2122,23 @@ private:
     };
     // The list of block instances.
     std::vector<Block> m_blocks;
-    // Don't let too many m_blocks get created.
-    const size_t m_maxBlockCount = 100;
+    // Don't let too many m_blocks get created. Raised by ParseBlockGridSize() for stress mode.
+    size_t m_maxBlockCount = 100;
     // Which block, if any, is being held by each of the user's hands or controllers.
     int m_grabbedBlock[2] = {-1, -1};
     // Which block, if any, is nearby to each hand or controller.
     int m_nearBlock[2] = {-1, -1};
+    // The indices of the blocks that are not being held, bucketed by their 10cm cell. See GetBlockGridKey().
+    std::unordered_map<uint64_t, std::vector<int>> m_blockGrid;
     // XR_DOCS_TAG_END_Objects
+    // The block near each hand found by FindNearBlockForHand(), before either hand grabbed or released a block this frame.
+    int m_foundNearBlock[2] = {-1, -1};
+    // The number of blocks along x, y and z created by CreateResources(). See ParseBlockGridSize().
+    uint32_t m_blockGridSize[3] = {4, 4, 4};
+    // Blocks are indexed with int, and 16 million of them take a few GB of CPU and GPU memory each frame.
+    const size_t m_maxStressBlockCount = size_t(1) << 24;
+    // Keeps the blocks well within the +/-100km that GetBlockGridKey() can address.
+    const size_t m_maxStressBlockGridSize = size_t(1) << 16;
 
     // XR_DOCS_TAG_BEGIN_Actions
     XrActionSet m_actionSet;
@@ -1556,17 +2175,18 @@ private:
     // XR_DOCS_TAG_END_HandTracking
 };
 
-void OpenXRTutorial_Main(GraphicsAPI_Type apiType) {
+void OpenXRTutorial_Main(GraphicsAPI_Type apiType, int argc = 0, char **argv = nullptr) {
     DebugOutput debugOutput;  // This redirects std::cerr and std::cout to the IDE's output or Android Studio's logcat.
     XR_TUT_LOG("OpenXR Tutorial Chapter 5");
 
     OpenXRTutorial app(apiType);
+    app.ParseBlockGridSize(argc, argv);
     app.Run();
 }
 
 #if defined(_WIN32) || (defined(__linux__) && !defined(__ANDROID__))
 int main(int argc, char **argv) {
-    OpenXRTutorial_Main(XR_TUTORIAL_GRAPHICS_API);
+    OpenXRTutorial_Main(XR_TUTORIAL_GRAPHICS_API, argc, argv);
 }
 /*
 // XR_DOCS_TAG_BEGIN_main_Windows_Linux_OPENGL
@@ -0,0 +1,216 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+// Platform headers
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__ANDROID__)
+#include <android/asset_manager.h>
+#endif
+
+// A read-only view of a whole file, mapped into memory rather than copied into a buffer. The data stays valid until the
+// FileView is destroyed, and can be passed straight to GraphicsAPI::CreateShader() and the like. On Android, assets are
+// read with AAsset_getBuffer(), which maps uncompressed assets and decompresses the others once.
+// The data is not null-terminated, so text must be read with GetSize(), not as a C string.
+class FileView {
+public:
+    FileView() = default;
+    explicit FileView(const std::string &filepath) {
+#if defined(_WIN32)
+        file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            std::cout << "Could not read file " << filepath.c_str() << ". File does not exist." << std::endl;
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        size = static_cast<size_t>(fileSize.QuadPart);
+        isOpen = true;
+        if (size == 0) {
+            return;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            data = reinterpret_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cout << "Could not read file " << filepath.c_str() << ". File does not exist." << std::endl;
+            return;
+        }
+        struct stat fileStat;
+        fstat(fd, &fileStat);
+        size = static_cast<size_t>(fileStat.st_size);
+        isOpen = true;
+        if (size == 0) {
+            return;
+        }
+        void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            data = reinterpret_cast<const char *>(address);
+        }
+#endif
+        if (!data) {
+            std::cout << "ERROR: FileView: Could not map file " << filepath.c_str() << "." << std::endl;
+            Close();
+        }
+    }
+#if defined(__ANDROID__)
+    FileView(const std::string &filepath, AAssetManager *assetManager) {
+        asset = AAssetManager_open(assetManager, filepath.c_str(), AASSET_MODE_BUFFER);
+        if (!asset) {
+            std::cout << "Could not read file " << filepath.c_str() << ". File does not exist." << std::endl;
+            return;
+        }
+        size = static_cast<size_t>(AAsset_getLength(asset));
+        data = reinterpret_cast<const char *>(AAsset_getBuffer(asset));
+        isOpen = true;
+        if (!data && size != 0) {
+            std::cout << "ERROR: FileView: Could not map file " << filepath.c_str() << "." << std::endl;
+            Close();
+        }
+    }
+#endif
+    ~FileView() {
+        Close();
+    }
+
+    FileView(const FileView &) = delete;
+    FileView &operator=(const FileView &) = delete;
+    FileView(FileView &&other) noexcept {
+        *this = std::move(other);
+    }
+    FileView &operator=(FileView &&other) noexcept {
+        if (this != &other) {
+            Close();
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+            std::swap(isOpen, other.isOpen);
+#if defined(_WIN32)
+            std::swap(file, other.file);
+            std::swap(mapping, other.mapping);
+#else
+            std::swap(fd, other.fd);
+#endif
+#if defined(__ANDROID__)
+            std::swap(asset, other.asset);
+#endif
+        }
+        return *this;
+    }
+
+    // False if the file could not be opened. An empty file is open, with no data.
+    bool IsOpen() const { return isOpen; }
+    const char *GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+    // Asks the OS to start reading the file into memory, and returns without waiting for it.
+    void Prefetch() const {
+        if (!data || size == 0) {
+            return;
+        }
+#if defined(_WIN32)
+#if _WIN32_WINNT >= 0x0602
+        WIN32_MEMORY_RANGE_ENTRY range = {const_cast<char *>(data), size};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#elif !defined(__ANDROID__)
+        madvise(const_cast<char *>(data), size, MADV_WILLNEED);
+#endif
+    }
+
+    // Reads every page of the file in, so that later accesses don't fault. Called on a loading thread by OpenAsync().
+    void Touch() const {
+        volatile char sink = 0;
+        for (size_t offset = 0; offset < size; offset += pageSize) {
+            sink ^= data[offset];
+        }
+        (void)sink;
+    }
+
+    // Maps the file and reads it in on another thread. The returned future's FileView is resident by the time it is ready,
+    // so large assets can be prefetched while the app does other work.
+    static std::future<FileView> OpenAsync(const std::string &filepath) {
+        return std::async(std::launch::async, [filepath]() {
+            FileView fileView(filepath);
+            fileView.Prefetch();
+            fileView.Touch();
+            return fileView;
+        });
+    }
+#if defined(__ANDROID__)
+    static std::future<FileView> OpenAsync(const std::string &filepath, AAssetManager *assetManager) {
+        return std::async(std::launch::async, [filepath, assetManager]() {
+            FileView fileView(filepath, assetManager);
+            fileView.Touch();
+            return fileView;
+        });
+    }
+#endif
+
+private:
+    void Close() {
+#if defined(__ANDROID__)
+        if (asset) {
+            AAsset_close(asset);
+            asset = nullptr;
+            data = nullptr;
+        }
+#endif
+#if defined(_WIN32)
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+            mapping = nullptr;
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (data) {
+            munmap(const_cast<char *>(data), size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+#endif
+        data = nullptr;
+        size = 0;
+        isOpen = false;
+    }
+
+    // Smallest page size of the supported platforms, so that Touch() reads every page.
+    static const size_t pageSize = 4096;
+
+    const char *data = nullptr;
+    size_t size = 0;
+    bool isOpen = false;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+#if defined(__ANDROID__)
+    AAsset *asset = nullptr;
+#endif
+};
@@ -0,0 +1,265 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <FrameTiming.h>
+
+#include <cmath>
+#include <iomanip>
+
+static const uint32_t stageCount = static_cast<uint32_t>(FrameTiming::Stage::COUNT);
+
+// Nearest-rank percentiles of values, which is sorted in place.
+static FrameTiming::Percentiles GetPercentiles(std::vector<double> &values) {
+    if (values.empty()) {
+        return {0.0, 0.0, 0.0};
+    }
+    std::sort(values.begin(), values.end());
+    auto Rank = [&values](double percentile) -> double {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+        return values[std::min(std::max<size_t>(rank, 1), values.size()) - 1];
+    };
+    return {Rank(50.0), Rank(95.0), Rank(99.0)};
+}
+
+const char *FrameTiming::GetStageName(Stage stage) {
+    switch (stage) {
+    case Stage::WAIT_FRAME:
+        return "wait_frame";
+    case Stage::BEGIN_FRAME:
+        return "begin_frame";
+    case Stage::POLL_ACTIONS:
+        return "poll_actions";
+    case Stage::BLOCK_INTERACTION:
+        return "block_interaction";
+    case Stage::RECORD_VIEWS:
+        return "record_views";
+    case Stage::QUEUE_CUBOIDS:
+        return "queue_cuboids";
+    case Stage::CULL_CUBOIDS:
+        return "cull_cuboids";
+    case Stage::DRAW_CUBOIDS:
+        return "draw_cuboids";
+    case Stage::SUBMIT:
+        return "submit";
+    case Stage::END_FRAME:
+        return "end_frame";
+    default:
+        return "unknown";
+    }
+}
+
+FrameTiming::FrameTiming(size_t capacity)
+    : slots(new Slot[std::max<size_t>(capacity, 1)]), capacity(std::max<size_t>(capacity, 1)) {
+}
+
+double FrameTiming::ToMs(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void FrameTiming::BeginFrame() {
+    const uint64_t frameIndex = writtenCount.load(std::memory_order_relaxed);
+    previousFrameStart = frameStart;
+    frameStart = Clock::now();
+
+    currentRecord = {};
+    currentRecord.frameIndex = frameIndex;
+    currentRecord.frameIntervalMs = frameIndex > 0 ? ToMs(frameStart - previousFrameStart) : 0.0;
+}
+
+void FrameTiming::BeginStage(Stage stage) {
+    stageStart[static_cast<uint32_t>(stage)] = Clock::now();
+}
+
+void FrameTiming::EndStage(Stage stage) {
+    const uint32_t index = static_cast<uint32_t>(stage);
+    currentRecord.stageMs[index] += ToMs(Clock::now() - stageStart[index]);
+}
+
+void FrameTiming::BeginView(uint32_t view) {
+    if (view < MAX_VIEWS) {
+        viewStart[view] = Clock::now();
+    }
+}
+
+void FrameTiming::EndView(uint32_t view) {
+    if (view < MAX_VIEWS) {
+        currentRecord.viewMs[view] += ToMs(Clock::now() - viewStart[view]);
+        currentRecord.viewCount = std::max(currentRecord.viewCount, view + 1);
+    }
+}
+
+void FrameTiming::SetDisplayTiming(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod) {
+    currentRecord.predictedDisplayTime = predictedDisplayTime;
+    currentRecord.predictedDisplayPeriod = predictedDisplayPeriod;
+    currentRecord.predictedDisplayTimeDelta = previousPredictedDisplayTime != 0 ? predictedDisplayTime - previousPredictedDisplayTime : 0;
+    previousPredictedDisplayTime = predictedDisplayTime;
+}
+
+void FrameTiming::EndFrame() {
+    currentRecord.frameMs = ToMs(Clock::now() - frameStart);
+
+    // Publish the record. Readers that see an odd or changed sequence discard their copy.
+    const uint64_t frameIndex = currentRecord.frameIndex;
+    Slot &slot = slots[frameIndex % capacity];
+    slot.sequence.store(2 * frameIndex + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = currentRecord;
+    slot.sequence.store(2 * (frameIndex + 1), std::memory_order_release);
+    writtenCount.store(frameIndex + 1, std::memory_order_release);
+}
+
+std::vector<FrameTiming::Record> FrameTiming::GetRecords() const {
+    const uint64_t written = writtenCount.load(std::memory_order_acquire);
+    const uint64_t first = written > capacity ? written - capacity : 0;
+
+    std::vector<Record> records;
+    records.reserve(static_cast<size_t>(written - first));
+    for (uint64_t frameIndex = first; frameIndex < written; frameIndex++) {
+        const Slot &slot = slots[frameIndex % capacity];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * (frameIndex + 1)) {
+            continue;  // Already overwritten by a newer frame.
+        }
+        Record record = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;  // Overwritten while it was being copied.
+        }
+        records.push_back(record);
+    }
+    return records;
+}
+
+FrameTiming::Summary FrameTiming::GetSummary() const {
+    const std::vector<Record> records = GetRecords();
+
+    Summary summary = {};
+    summary.frameCount = records.size();
+
+    std::vector<double> values;
+    values.reserve(records.size());
+    auto Summarize = [&](std::function<double(const Record &)> get) -> Percentiles {
+        values.clear();
+        for (const Record &record : records) {
+            values.push_back(get(record));
+        }
+        return GetPercentiles(values);
+    };
+
+    summary.frameIntervalMs = Summarize([](const Record &record) { return record.frameIntervalMs; });
+    summary.frameMs = Summarize([](const Record &record) { return record.frameMs; });
+    for (uint32_t i = 0; i < stageCount; i++) {
+        summary.stageMs[i] = Summarize([i](const Record &record) { return record.stageMs[i]; });
+    }
+    summary.predictedDisplayTimeDeltaMs = Summarize([](const Record &record) { return static_cast<double>(record.predictedDisplayTimeDelta) / 1e6; });
+
+    for (const Record &record : records) {
+        if (record.predictedDisplayPeriod > 0 && record.predictedDisplayTimeDelta * 2 > record.predictedDisplayPeriod * 3) {
+            summary.missedFrameCount++;
+        }
+    }
+    return summary;
+}
+
+std::string FrameTiming::GetSummaryString() const {
+    const Summary summary = GetSummary();
+
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(3);
+    auto Line = [&ostr](const char *name, const Percentiles &percentiles) {
+        ostr << "\n  " << std::left << std::setw(28) << name << std::right
+             << " p50 " << percentiles.p50 << " ms, p95 " << percentiles.p95 << " ms, p99 " << percentiles.p99 << " ms";
+    };
+    ostr << "Frame timing over " << summary.frameCount << " frames, " << summary.missedFrameCount << " missed:";
+    Line("frame_interval", summary.frameIntervalMs);
+    Line("frame", summary.frameMs);
+    for (uint32_t i = 0; i < stageCount; i++) {
+        Line(GetStageName(static_cast<Stage>(i)), summary.stageMs[i]);
+    }
+    Line("predicted_display_time_delta", summary.predictedDisplayTimeDeltaMs);
+    return ostr.str();
+}
+
+bool FrameTiming::WriteCSV(const std::string &filepath) const {
+    std::ofstream stream(filepath, std::ios::out | std::ios::trunc);
+    if (!stream.is_open()) {
+        std::cout << "ERROR: Could not write frame timing to: " << filepath << std::endl;
+        return false;
+    }
+
+    stream << "frame_index,frame_interval_ms,frame_ms";
+    for (uint32_t i = 0; i < stageCount; i++) {
+        stream << "," << GetStageName(static_cast<Stage>(i)) << "_ms";
+    }
+    for (uint32_t i = 0; i < MAX_VIEWS; i++) {
+        stream << ",view" << i << "_ms";
+    }
+    stream << ",predicted_display_time,predicted_display_period,predicted_display_time_delta\n";
+
+    stream << std::fixed << std::setprecision(4);
+    for (const Record &record : GetRecords()) {
+        stream << record.frameIndex << "," << record.frameIntervalMs << "," << record.frameMs;
+        for (uint32_t i = 0; i < stageCount; i++) {
+            stream << "," << record.stageMs[i];
+        }
+        for (uint32_t i = 0; i < MAX_VIEWS; i++) {
+            stream << ",";
+            if (i < record.viewCount) {
+                stream << record.viewMs[i];
+            }
+        }
+        stream << "," << record.predictedDisplayTime << "," << record.predictedDisplayPeriod << "," << record.predictedDisplayTimeDelta << "\n";
+    }
+    return stream.good();
+}
+
+bool FrameTiming::WriteJSON(const std::string &filepath) const {
+    std::ofstream stream(filepath, std::ios::out | std::ios::trunc);
+    if (!stream.is_open()) {
+        std::cout << "ERROR: Could not write frame timing to: " << filepath << std::endl;
+        return false;
+    }
+
+    const Summary summary = GetSummary();
+    stream << std::fixed << std::setprecision(4);
+    auto WritePercentiles = [&stream](const Percentiles &percentiles) {
+        stream << "{\"p50\": " << percentiles.p50 << ", \"p95\": " << percentiles.p95 << ", \"p99\": " << percentiles.p99 << "}";
+    };
+
+    stream << "{\n  \"summary\": {\n";
+    stream << "    \"frame_count\": " << summary.frameCount << ",\n";
+    stream << "    \"missed_frame_count\": " << summary.missedFrameCount << ",\n";
+    stream << "    \"frame_interval_ms\": ";
+    WritePercentiles(summary.frameIntervalMs);
+    stream << ",\n    \"frame_ms\": ";
+    WritePercentiles(summary.frameMs);
+    for (uint32_t i = 0; i < stageCount; i++) {
+        stream << ",\n    \"" << GetStageName(static_cast<Stage>(i)) << "_ms\": ";
+        WritePercentiles(summary.stageMs[i]);
+    }
+    stream << ",\n    \"predicted_display_time_delta_ms\": ";
+    WritePercentiles(summary.predictedDisplayTimeDeltaMs);
+    stream << "\n  },\n  \"frames\": [";
+
+    const std::vector<Record> records = GetRecords();
+    for (size_t r = 0; r < records.size(); r++) {
+        const Record &record = records[r];
+        stream << (r == 0 ? "\n" : ",\n") << "    {\"frame_index\": " << record.frameIndex
+               << ", \"frame_interval_ms\": " << record.frameIntervalMs << ", \"frame_ms\": " << record.frameMs;
+        for (uint32_t i = 0; i < stageCount; i++) {
+            stream << ", \"" << GetStageName(static_cast<Stage>(i)) << "_ms\": " << record.stageMs[i];
+        }
+        stream << ", \"view_ms\": [";
+        for (uint32_t i = 0; i < record.viewCount; i++) {
+            stream << (i == 0 ? "" : ", ") << record.viewMs[i];
+        }
+        stream << "], \"predicted_display_time\": " << record.predictedDisplayTime
+               << ", \"predicted_display_period\": " << record.predictedDisplayPeriod
+               << ", \"predicted_display_time_delta\": " << record.predictedDisplayTimeDelta << "}";
+    }
+    stream << "\n  ]\n}\n";
+    return stream.good();
+}
@@ -0,0 +1,109 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+#include <atomic>
+#include <chrono>
+
+#include <openxr/openxr.h>
+
+// Records CPU timings for each stage of a frame into a fixed size ring of the most recent frames.
+// One thread, the one calling RenderFrame(), writes the records. Any thread may read them with GetRecords() or GetSummary()
+// without locking, and records that are overwritten while they are being read are skipped.
+class FrameTiming {
+public:
+    enum class Stage : uint32_t {
+        WAIT_FRAME,
+        BEGIN_FRAME,
+        POLL_ACTIONS,
+        BLOCK_INTERACTION,
+        RECORD_VIEWS,
+        // Parts of RECORD_VIEWS, so that the cost of a large scene can be broken down.
+        QUEUE_CUBOIDS,
+        CULL_CUBOIDS,
+        DRAW_CUBOIDS,
+        SUBMIT,
+        END_FRAME,
+        COUNT
+    };
+    static const char *GetStageName(Stage stage);
+
+    enum : uint32_t {
+        MAX_VIEWS = 4
+    };
+
+    struct Record {
+        uint64_t frameIndex;
+        double frameIntervalMs;                          // CPU time since the previous frame started.
+        double frameMs;                                  // CPU time from BeginFrame() to EndFrame().
+        double stageMs[static_cast<uint32_t>(Stage::COUNT)];  // Summed over every BeginStage()/EndStage() pair in the frame.
+        uint32_t viewCount;
+        double viewMs[MAX_VIEWS];  // Recording of each view.
+        XrTime predictedDisplayTime;
+        XrDuration predictedDisplayPeriod;
+        XrDuration predictedDisplayTimeDelta;  // predictedDisplayTime minus the previous frame's, or 0 for the first frame.
+    };
+
+    struct Percentiles {
+        double p50;
+        double p95;
+        double p99;
+    };
+    struct Summary {
+        size_t frameCount;
+        // Frames whose predicted display time moved on by more than one and a half display periods.
+        size_t missedFrameCount;
+        Percentiles frameIntervalMs;
+        Percentiles frameMs;
+        Percentiles stageMs[static_cast<uint32_t>(Stage::COUNT)];
+        Percentiles predictedDisplayTimeDeltaMs;
+    };
+
+    explicit FrameTiming(size_t capacity = 1024);
+    ~FrameTiming() = default;
+
+    // Writer side, called in order from the rendering thread. The record is published to readers by EndFrame().
+    void BeginFrame();
+    void BeginStage(Stage stage);
+    void EndStage(Stage stage);
+    void BeginView(uint32_t view);
+    void EndView(uint32_t view);
+    void SetDisplayTiming(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod);
+    void EndFrame();
+
+    // Reader side. Returns the recorded frames that are still in the ring, oldest first.
+    std::vector<Record> GetRecords() const;
+    Summary GetSummary() const;
+    std::string GetSummaryString() const;
+
+    bool WriteCSV(const std::string &filepath) const;
+    bool WriteJSON(const std::string &filepath) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static double ToMs(Clock::duration duration);
+
+    // Each slot is guarded by a sequence number: odd while the writer is changing the record, and 2 * (frameIndex + 1) once
+    // the record of frameIndex is complete. A reader keeps a copy only if the sequence was the same before and after copying.
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        Record record;
+    };
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity = 0;
+    std::atomic<uint64_t> writtenCount{0};
+
+    // Only used by the writer.
+    Record currentRecord = {};
+    Clock::time_point frameStart;
+    Clock::time_point previousFrameStart;
+    Clock::time_point stageStart[static_cast<uint32_t>(Stage::COUNT)];
+    Clock::time_point viewStart[MAX_VIEWS];
+    XrTime previousPredictedDisplayTime = 0;
+};
@@ -79,3 +79,212 @@ int64_t GraphicsAPI::SelectDepthSwapchainFormat(const std::vector<int64_t> &form
     return *swapchainFormatIt;
 }
 // XR_DOCS_TAG_END_GraphicsAPI_SelectSwapchainFormats
+
+thread_local GraphicsAPI::RecordingState *GraphicsAPI::threadRecordingState = nullptr;
+
+GraphicsAPI::TransientUniform GraphicsAPI::AllocateTransientUniform(size_t size, const void *data, size_t dataSize) {
+    std::lock_guard<std::mutex> lock(transientUniformMutex);
+    if (transientUniformFrameIndex >= transientUniformFrames.size()) {
+        transientUniformFrames.resize(transientUniformFrameIndex + 1);
+    }
+    TransientUniformFrame &frame = transientUniformFrames[transientUniformFrameIndex];
+
+    // Keep every slice aligned, and large enough for APIs that bind whole alignment units.
+    if (transientUniformAlignment == 0) {
+        transientUniformAlignment = std::max<size_t>(GetUniformBufferOffsetAlignment(), 1);
+    }
+    const size_t alignedSize = Align<size_t>(size, transientUniformAlignment);
+
+    // Move on to the next page if this one is full, creating it if needed.
+    while (frame.pageIndex < frame.pages.size() && frame.pageOffset + alignedSize > frame.pages[frame.pageIndex].second) {
+        frame.pageIndex++;
+        frame.pageOffset = 0;
+        frame.pageWritten = false;
+    }
+    if (frame.pageIndex == frame.pages.size()) {
+        // Each new page is twice the size of the last, up to 256 times the first, so that large scenes need few buffers.
+        const size_t pageSize = std::max(transientUniformPageSize << std::min<size_t>(frame.pages.size(), 8), alignedSize);
+        frame.pages.push_back({CreateBuffer({BufferCreateInfo::Type::UNIFORM, 0, pageSize, nullptr, true}), pageSize});
+    }
+
+    TransientUniform transientUniform = {frame.pages[frame.pageIndex].first, frame.pageOffset, size};
+    frame.pageOffset += alignedSize;
+
+    if (data) {
+        SetTransientUniformData(transientUniform.buffer, transientUniform.offset, dataSize ? dataSize : size, data, !frame.pageWritten);
+        frame.pageWritten = true;
+    }
+    return transientUniform;
+}
+
+void GraphicsAPI::BeginTransientUniforms(size_t frameIndex) {
+    transientUniformFrameIndex = frameIndex;
+    if (transientUniformFrameIndex >= transientUniformFrames.size()) {
+        transientUniformFrames.resize(transientUniformFrameIndex + 1);
+    }
+    TransientUniformFrame &frame = transientUniformFrames[transientUniformFrameIndex];
+    frame.pageIndex = 0;
+    frame.pageOffset = 0;
+    frame.pageWritten = false;
+}
+
+void GraphicsAPI::DestroyTransientUniforms() {
+    for (TransientUniformFrame &frame : transientUniformFrames) {
+        for (auto &page : frame.pages) {
+            DestroyBuffer(page.first);
+        }
+    }
+    transientUniformFrames.clear();
+}
+
+bool GraphicsAPI::FilterSetPipeline(void *pipeline) {
+    BoundState &boundState = GetRecordingState().boundState;
+    StateBindStatistics &stateBindStatistics = GetRecordingState().stateBindStatistics;
+    if (boundState.pipelineBound && pipeline == boundState.pipeline) {
+        stateBindStatistics.pipeline.elided++;
+        return false;
+    }
+    boundState.pipelineBound = true;
+    boundState.pipeline = pipeline;
+    stateBindStatistics.pipeline.issued++;
+    return true;
+}
+
+bool GraphicsAPI::FilterSetVertexBuffers(void **vertexBuffers, size_t count) {
+    BoundState &boundState = GetRecordingState().boundState;
+    StateBindStatistics &stateBindStatistics = GetRecordingState().stateBindStatistics;
+    if (boundState.vertexBuffersBound && boundState.vertexBuffersPipeline == boundState.pipeline && boundState.vertexBuffers.size() == count
+        && std::equal(vertexBuffers, vertexBuffers + count, boundState.vertexBuffers.begin())) {
+        stateBindStatistics.vertexBuffers.elided++;
+        return false;
+    }
+    boundState.vertexBuffersBound = true;
+    boundState.vertexBuffersPipeline = boundState.pipeline;
+    boundState.vertexBuffers.assign(vertexBuffers, vertexBuffers + count);
+    stateBindStatistics.vertexBuffers.issued++;
+    return true;
+}
+
+bool GraphicsAPI::FilterSetIndexBuffer(void *indexBuffer) {
+    BoundState &boundState = GetRecordingState().boundState;
+    StateBindStatistics &stateBindStatistics = GetRecordingState().stateBindStatistics;
+    if (boundState.indexBufferBound && indexBuffer == boundState.indexBuffer) {
+        stateBindStatistics.indexBuffer.elided++;
+        return false;
+    }
+    boundState.indexBufferBound = true;
+    boundState.indexBuffer = indexBuffer;
+    stateBindStatistics.indexBuffer.issued++;
+    return true;
+}
+
+void GraphicsAPI::InvalidateBoundState() {
+    GetRecordingState().boundState.pipelineBound = false;
+    InvalidateBoundBuffers();
+}
+
+void GraphicsAPI::InvalidateBoundBuffers() {
+    BoundState &boundState = GetRecordingState().boundState;
+    boundState.vertexBuffersBound = false;
+    boundState.indexBufferBound = false;
+}
+
+void GraphicsAPI::AddStateBindStatistics(const StateBindStatistics &statistics) {
+    StateBindStatistics &stateBindStatistics = recordingState.stateBindStatistics;
+    stateBindStatistics.pipeline.issued += statistics.pipeline.issued;
+    stateBindStatistics.pipeline.elided += statistics.pipeline.elided;
+    stateBindStatistics.vertexBuffers.issued += statistics.vertexBuffers.issued;
+    stateBindStatistics.vertexBuffers.elided += statistics.vertexBuffers.elided;
+    stateBindStatistics.indexBuffer.issued += statistics.indexBuffer.issued;
+    stateBindStatistics.indexBuffer.elided += statistics.indexBuffer.elided;
+}
+
+void *GraphicsAPI::CreatePipelineAsync(const PipelineCreateInfo &pipelineCI, void *placeholderPipeline) {
+    return new AsyncPipeline{placeholderPipeline, StartPipelineBuild(pipelineCI), nullptr};
+}
+
+void GraphicsAPI::FinishAsyncPipeline(AsyncPipeline &asyncPipeline, bool wait) {
+    if (asyncPipeline.build && FinishPipelineBuild(asyncPipeline.build, wait, asyncPipeline.pipeline)) {
+        asyncPipeline.build = nullptr;
+    }
+}
+
+void *GraphicsAPI::GetAsyncPipeline(void *asyncPipeline) {
+    AsyncPipeline &pipeline = *reinterpret_cast<AsyncPipeline *>(asyncPipeline);
+    FinishAsyncPipeline(pipeline, false);
+    return pipeline.pipeline ? pipeline.pipeline : pipeline.placeholderPipeline;
+}
+
+bool GraphicsAPI::IsAsyncPipelineReady(void *asyncPipeline) {
+    AsyncPipeline &pipeline = *reinterpret_cast<AsyncPipeline *>(asyncPipeline);
+    FinishAsyncPipeline(pipeline, false);
+    return pipeline.pipeline != nullptr;
+}
+
+void GraphicsAPI::DestroyAsyncPipeline(void *&asyncPipeline) {
+    AsyncPipeline *pipeline = reinterpret_cast<AsyncPipeline *>(asyncPipeline);
+    FinishAsyncPipeline(*pipeline, true);
+    if (pipeline->pipeline) {
+        DestroyPipeline(pipeline->pipeline);
+    }
+    delete pipeline;
+    asyncPipeline = nullptr;
+}
+
+void GraphicsAPI::BeginTimestampScope(const std::string &name) {
+    TimestampScope scope = {name, false, 0, 0};
+    scope.written = WriteTimestamp(scope.begin);
+    openTimestampScopes.push_back(scope);
+}
+
+void GraphicsAPI::EndTimestampScope() {
+    if (openTimestampScopes.empty()) {
+        std::cout << "ERROR: EndTimestampScope() called without a matching BeginTimestampScope()." << std::endl;
+        DEBUG_BREAK;
+        return;
+    }
+    TimestampScope scope = openTimestampScopes.back();
+    openTimestampScopes.pop_back();
+    if (!scope.written) {
+        return;
+    }
+    if (!WriteTimestamp(scope.end)) {
+        ReleaseTimestamp(scope.begin);
+        return;
+    }
+    pendingTimestampScopes.push_back(scope);
+
+    while (pendingTimestampScopes.size() > maxPendingTimestampScopes) {
+        ReleaseTimestamp(pendingTimestampScopes.front().begin);
+        ReleaseTimestamp(pendingTimestampScopes.front().end);
+        pendingTimestampScopes.pop_front();
+    }
+}
+
+std::vector<GraphicsAPI::TimestampResult> GraphicsAPI::GetTimestampResults() {
+    // The GPU executes the scopes in the order they were recorded, so stop at the first one that isn't available yet.
+    std::vector<TimestampResult> results;
+    while (!pendingTimestampScopes.empty()) {
+        const TimestampScope &scope = pendingTimestampScopes.front();
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        if (!ReadTimestamp(scope.end, end) || !ReadTimestamp(scope.begin, begin)) {
+            break;
+        }
+        results.push_back({scope.name, end > begin ? static_cast<double>(end - begin) / 1e6 : 0.0});
+        ReleaseTimestamp(scope.begin);
+        ReleaseTimestamp(scope.end);
+        pendingTimestampScopes.pop_front();
+    }
+
+    // A disjoint event may have happened while any of the scopes read here, or still pending, were running, so drop them all.
+    if ((!results.empty() || !pendingTimestampScopes.empty()) && TimestampsDisjoint()) {
+        results.clear();
+        for (const TimestampScope &scope : pendingTimestampScopes) {
+            ReleaseTimestamp(scope.begin);
+            ReleaseTimestamp(scope.end);
+        }
+        pendingTimestampScopes.clear();
+    }
+    return results;
+}
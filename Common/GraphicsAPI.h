@@ -137,7 +137,10 @@ public:
         UINT,
         UVEC2,
         UVEC3,
-        UVEC4
+        UVEC4,
+        // Signed normalized integers, read by the shader as a vec4 in [-1, 1].
+        VEC4_SNORM16,
+        VEC4_SNORM8
     };
     enum class PrimitiveTopology : uint8_t {
         POINT_LIST = 0,
@@ -349,6 +352,9 @@ public:
         std::vector<int64_t> colorFormats;
         int64_t depthFormat;
         std::vector<DescriptorInfo> layout;
+        // Non-zero to draw to several layers of 2D array attachments in one pass, where bit i is set for layer i. The vertex
+        // shader selects each view's transforms by view index. Only for backends that return true from SupportsMultiview().
+        uint32_t viewMask = 0;
     };
 
     struct SwapchainCreateInfo {
@@ -369,6 +375,12 @@ public:
         size_t stride;
         size_t size;
         void* data;
+        // The contents are rewritten every frame. SetBufferData() doesn't wait for the frames in flight that read the buffer:
+        // it writes another copy of a persistently mapped buffer, or has the driver orphan it. Writes through
+        // GetBufferMappedData() go to the mapping in place, so they must not overwrite data that the GPU may still be reading.
+        // Buffers created with data that are not streaming are static. Backends may place them in memory that the CPU can't
+        // map, so SetBufferData() on them goes through a copy and GetBufferMappedData() returns nullptr.
+        bool streaming;
     };
 
     struct ImageCreateInfo {
@@ -442,6 +454,32 @@ public:
         float borderColor[4];
     };
 
+    // A slice of a uniform buffer returned by AllocateTransientUniform(). Bind it with DescriptorInfo::resource = buffer,
+    // bufferOffset = offset and bufferSize = size.
+    struct TransientUniform {
+        void* buffer;
+        size_t offset;
+        size_t size;
+    };
+
+    // Counts of SetPipeline(), SetVertexBuffers() and SetIndexBuffer() calls that were passed on to the driver,
+    // and of those skipped because the same state was already bound.
+    struct StateBindStatistics {
+        struct Counter {
+            uint64_t issued;
+            uint64_t elided;
+        };
+        Counter pipeline;
+        Counter vertexBuffers;
+        Counter indexBuffer;
+    };
+
+    // The GPU time between BeginTimestampScope() and the matching EndTimestampScope().
+    struct TimestampResult {
+        std::string name;
+        double gpuMs;
+    };
+
     struct Viewport {
         float x;
         float y;
@@ -501,10 +539,33 @@ public:
     virtual void* CreatePipeline(const PipelineCreateInfo& pipelineCI) = 0;
     virtual void DestroyPipeline(void*& pipeline) = 0;
 
+    // Loads compiled pipelines saved by SavePipelineCache() in an earlier run, so that CreatePipeline() can skip shader compilation.
+    // Call before creating pipelines. A missing file, or one written by a different device or driver, is ignored.
+    virtual void LoadPipelineCache(const std::string& /*filepath*/) {}
+    virtual void SavePipelineCache(const std::string& /*filepath*/) {}
+
+    // Builds a pipeline in the background, so that the rendering thread doesn't stall on shader compilation, and returns a
+    // handle to it at once. Vulkan builds it on another thread, sharing the pipeline cache, and OpenGL links it with
+    // GL_KHR_parallel_shader_compile. Other backends build it before returning. GetAsyncPipeline() returns the pipeline once
+    // it is built, and placeholderPipeline until then: a cheaper pipeline for the same render attachments, or nullptr to draw
+    // nothing. The placeholder stays owned by the caller, and the shaders must outlive the build. Call these on the rendering
+    // thread. DestroyAsyncPipeline() waits for the build to finish, and destroys the pipeline.
+    void* CreatePipelineAsync(const PipelineCreateInfo& pipelineCI, void* placeholderPipeline = nullptr);
+    void* GetAsyncPipeline(void* asyncPipeline);
+    bool IsAsyncPipelineReady(void* asyncPipeline);
+    void DestroyAsyncPipeline(void*& asyncPipeline);
+
     virtual void BeginRendering() = 0;
     virtual void EndRendering() = 0;
 
     virtual void SetBufferData(void* buffer, size_t offset, size_t size, void* data) = 0;
+    // Returns a CPU pointer to the start of a persistently mapped buffer, or nullptr if the backend does not keep buffers mapped.
+    // Writes through the pointer are not synchronised with the GPU, so the caller must not overwrite data still in use.
+    virtual void* GetBufferMappedData(void* /*buffer*/) { return nullptr; }
+
+    // Bump-allocates size bytes of uniform data from the current frame's pages, creating more pages as needed, and copies
+    // dataSize bytes from data into it (size bytes if dataSize is 0). The slice is only valid until the next BeginRendering().
+    TransientUniform AllocateTransientUniform(size_t size, const void* data, size_t dataSize = 0);
 
     virtual void ClearColor(void* imageView, float r, float g, float b, float a) = 0;
     virtual void ClearDepth(void* imageView, float d) = 0;
@@ -521,8 +582,125 @@ public:
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0) = 0;
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) = 0;
 
+    // Whether pipelines may set a viewMask, to draw every view of a stereo frame in one pass to 2D array image views.
+    virtual bool SupportsMultiview() { return false; }
+
+    // Command lists let several threads record draws for the current render attachments at once. After SetRenderAttachments(),
+    // each thread calls BeginCommandList(), records with SetViewports(), SetScissors(), SetPipeline(), SetDescriptor(),
+    // UpdateDescriptors(), SetVertexBuffers(), SetIndexBuffer(), DrawIndexed(), Draw() and AllocateTransientUniform(), then calls
+    // EndCommandList(). A command list starts with the viewports and scissors last set on the rendering thread, and no other state.
+    // The rendering thread then calls ExecuteCommandLists(), which runs them in the order given. No other GraphicsAPI calls may be
+    // made while command lists are being recorded. Backends that return false from SupportsCommandLists() record on one thread only.
+    virtual bool SupportsCommandLists() { return false; }
+    virtual void* BeginCommandList() { return nullptr; }
+    virtual void EndCommandList(void* /*commandList*/) {}
+    virtual void ExecuteCommandLists(void* const* /*commandLists*/, size_t /*count*/) {}
+
+    // Includes the command lists that have been executed.
+    const StateBindStatistics& GetStateBindStatistics() const { return recordingState.stateBindStatistics; }
+    void ResetStateBindStatistics() { recordingState.stateBindStatistics = {}; }
+
+    // Writes GPU timestamps around a named scope of commands. Scopes may nest, and must begin and end between the same
+    // BeginRendering() and EndRendering(). Backends without timestamp queries ignore them.
+    void BeginTimestampScope(const std::string& name);
+    void EndTimestampScope();
+    // Returns the scopes that the GPU has finished since the last call, in the order they ended. This never waits for the GPU,
+    // so a scope is typically returned a frame or two after it was recorded.
+    std::vector<TimestampResult> GetTimestampResults();
+
 protected:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() = 0;
     virtual const std::vector<int64_t> GetSupportedDepthSwapchainFormats() = 0;
     bool debugAPI = false;
+
+    // Called from BeginRendering() once the GPU has finished reading the transient uniforms last allocated for frameIndex.
+    void BeginTransientUniforms(size_t frameIndex);
+    // Called from the backend's destructor, while its device is still valid.
+    void DestroyTransientUniforms();
+    // The alignment required for the offset of a uniform buffer binding. D3D binds constant buffers in 256 byte units.
+    virtual size_t GetUniformBufferOffsetAlignment() { return 256; }
+    // Writes to a transient uniform page. discard is set for the first write to the page since BeginTransientUniforms().
+    virtual void SetTransientUniformData(void* buffer, size_t offset, size_t size, const void* data, bool discard) { SetBufferData(buffer, offset, size, const_cast<void*>(data)); }
+
+    struct TransientUniformFrame {
+        std::vector<std::pair<void*, size_t>> pages;  // Uniform buffers and their sizes.
+        size_t pageIndex = 0;
+        size_t pageOffset = 0;
+        bool pageWritten = false;
+    };
+    std::vector<TransientUniformFrame> transientUniformFrames;
+    std::mutex transientUniformMutex;  // AllocateTransientUniform() is called by the threads recording command lists.
+    size_t transientUniformFrameIndex = 0;
+    size_t transientUniformAlignment = 0;  // Queried on first use.
+    const size_t transientUniformPageSize = 64 * 1024;
+
+    // Redundant state filtering for SetPipeline(), SetVertexBuffers() and SetIndexBuffer(). Each returns false if the state is
+    // already bound, so the backend can return early, and otherwise records it as bound. Backends call InvalidateBoundState()
+    // wherever the API state may be lost or changed behind the filter's back, such as when a new command buffer is started,
+    // and when a pipeline or buffer is destroyed, as a new object may reuse its handle.
+    bool FilterSetPipeline(void* pipeline);
+    bool FilterSetVertexBuffers(void** vertexBuffers, size_t count);
+    bool FilterSetIndexBuffer(void* indexBuffer);
+    void InvalidateBoundState();
+    // Only forgets the vertex and index buffers, for when they are lost without the pipeline changing.
+    void InvalidateBoundBuffers();
+
+    struct BoundState {
+        bool pipelineBound = false;
+        void* pipeline = nullptr;
+        bool vertexBuffersBound = false;
+        void* vertexBuffersPipeline = nullptr;  // The vertex input layout comes from the pipeline, so the buffers are bound against it.
+        std::vector<void*> vertexBuffers;
+        bool indexBufferBound = false;
+        void* indexBuffer = nullptr;
+    };
+    // The filter's state for one command stream. The rendering thread uses recordingState, and each command list its own.
+    struct RecordingState {
+        BoundState boundState;
+        StateBindStatistics stateBindStatistics{};
+    };
+    RecordingState recordingState;
+    // Backends call this from BeginCommandList() with the command list's state, and from EndCommandList() with nullptr,
+    // on the recording thread. The filter functions then use that thread's state.
+    void SetThreadRecordingState(RecordingState* state) { threadRecordingState = state; }
+    RecordingState& GetRecordingState() { return threadRecordingState ? *threadRecordingState : recordingState; }
+    // Called from ExecuteCommandLists() on the rendering thread, so that GetStateBindStatistics() includes the command lists.
+    void AddStateBindStatistics(const StateBindStatistics& statistics);
+    static thread_local RecordingState* threadRecordingState;
+
+    // Builds for CreatePipelineAsync(). StartPipelineBuild() starts building the pipeline, and returns an id for the build.
+    // FinishPipelineBuild() returns false if the build is still running, unless wait is set, and otherwise ends the build
+    // and sets pipeline to the built pipeline, or nullptr if it failed. By default, StartPipelineBuild() builds the pipeline.
+    virtual void* StartPipelineBuild(const PipelineCreateInfo& pipelineCI) { return CreatePipeline(pipelineCI); }
+    virtual bool FinishPipelineBuild(void* build, bool wait, void*& pipeline) {
+        pipeline = build;
+        return true;
+    }
+    struct AsyncPipeline {
+        void* placeholderPipeline;
+        void* build;     // Until the build has finished.
+        void* pipeline;  // Once the build has finished, unless it failed.
+    };
+    void FinishAsyncPipeline(AsyncPipeline& asyncPipeline, bool wait);
+
+    // Timestamp queries for the scopes. WriteTimestamp() records a timestamp into the current command stream and returns an id
+    // for it, or false if it can't. ReadTimestamp() returns false if the GPU has not written it yet, and must not wait.
+    // ReleaseTimestamp() is called once the result has been read, so that the id can be reused.
+    // TimestampsDisjoint() returns true if something, such as a change of GPU clock, has made the timestamps written since
+    // the last call meaningless.
+    virtual bool WriteTimestamp(uint64_t& /*timestamp*/) { return false; }
+    virtual bool ReadTimestamp(uint64_t /*timestamp*/, uint64_t& /*nanoseconds*/) { return false; }
+    virtual void ReleaseTimestamp(uint64_t /*timestamp*/) {}
+    virtual bool TimestampsDisjoint() { return false; }
+
+    struct TimestampScope {
+        std::string name;
+        bool written;  // False if the backend could not write the begin timestamp.
+        uint64_t begin;
+        uint64_t end;
+    };
+    std::vector<TimestampScope> openTimestampScopes;
+    std::list<TimestampScope> pendingTimestampScopes;
+    // Results that are never collected are dropped past this many scopes, oldest first.
+    const size_t maxPendingTimestampScopes = 256;
 };
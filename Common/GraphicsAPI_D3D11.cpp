@@ -176,6 +176,10 @@ static DXGI_FORMAT ToDXGI_FORMAT(GraphicsAPI::VertexType type) {
         return DXGI_FORMAT_R32G32B32_UINT;
     case GraphicsAPI::VertexType::UVEC4:
         return DXGI_FORMAT_R32G32B32A32_UINT;
+    case GraphicsAPI::VertexType::VEC4_SNORM16:
+        return DXGI_FORMAT_R16G16B16A16_SNORM;
+    case GraphicsAPI::VertexType::VEC4_SNORM8:
+        return DXGI_FORMAT_R8G8B8A8_SNORM;
     default:
         return DXGI_FORMAT_UNKNOWN;
     }
@@ -223,6 +227,7 @@ GraphicsAPI_D3D11::GraphicsAPI_D3D11(XrInstance m_xrInstance, XrSystemId systemI
 }
 
 GraphicsAPI_D3D11::~GraphicsAPI_D3D11() {
+    DestroyTransientUniforms();
     D3D11_SAFE_RELEASE(immediateContext);
     D3D11_SAFE_RELEASE(device);
     D3D11_SAFE_RELEASE(factory);
@@ -586,6 +591,7 @@ void *GraphicsAPI_D3D11::CreateBuffer(const BufferCreateInfo &bufferCI) {
 }
 
 void GraphicsAPI_D3D11::DestroyBuffer(void *&buffer) {
+    InvalidateBoundState();
     ID3D11Buffer *d3D11Buffer = reinterpret_cast<ID3D11Buffer *>(buffer);
     buffers.erase(d3D11Buffer);
     D3D11_SAFE_RELEASE(d3D11Buffer);
@@ -652,11 +658,15 @@ void *GraphicsAPI_D3D11::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
 }
 
 void GraphicsAPI_D3D11::DestroyPipeline(void *&pipeline) {
+    InvalidateBoundState();
     pipelines.erase((UINT64)pipeline);
     pipeline = nullptr;
 }
 
 void GraphicsAPI_D3D11::BeginRendering() {
+    // Discarding a page on its first write renames it, so a single set of pages is enough.
+    BeginTransientUniforms(0);
+    InvalidateBoundState();
 }
 
 void GraphicsAPI_D3D11::EndRendering() {
@@ -671,6 +681,17 @@ void GraphicsAPI_D3D11::SetBufferData(void *buffer, size_t offset, size_t size,
     immediateContext->Unmap(d3d11Buffer, 0);
 }
 
+void GraphicsAPI_D3D11::SetTransientUniformData(void *buffer, size_t offset, size_t size, const void *data, bool discard) {
+    // After the first write, map with WRITE_NO_OVERWRITE so that the slices already bound for earlier draws keep their data.
+    // This needs the D3D11.1 MapNoOverwriteOnDynamicConstantBuffer feature, like the constant buffer offsets in SetDescriptor().
+    ID3D11Buffer *d3d11Buffer = (ID3D11Buffer *)buffer;
+    D3D11_MAPPED_SUBRESOURCE mappedSubresource = {};
+    D3D11_CHECK(immediateContext->Map(d3d11Buffer, 0, discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedSubresource), "Failed to map Resource.");
+    if (mappedSubresource.pData && data)
+        memcpy((char *)mappedSubresource.pData + offset, data, size);
+    immediateContext->Unmap(d3d11Buffer, 0);
+}
+
 void GraphicsAPI_D3D11::ClearColor(void *imageView, float r, float g, float b, float a) {
     const FLOAT clearColor[4] = {r, g, b, a};
     immediateContext->ClearRenderTargetView((ID3D11RenderTargetView *)imageView, clearColor);
@@ -705,6 +726,10 @@ void GraphicsAPI_D3D11::SetScissors(Rect2D *scissors, size_t count) {
 }
 
 void GraphicsAPI_D3D11::SetPipeline(void *pipeline) {
+    if (!FilterSetPipeline(pipeline)) {
+        return;
+    }
+
     PipelineCreateInfo pipelineCI = pipelines[(UINT64)pipeline];
     setPipeline = (UINT64)pipeline;
 
@@ -967,6 +992,10 @@ void GraphicsAPI_D3D11::UpdateDescriptors() {
 }
 
 void GraphicsAPI_D3D11::SetVertexBuffers(void **vertexBuffers, size_t count) {
+    if (!FilterSetVertexBuffers(vertexBuffers, count)) {
+        return;
+    }
+
     const VertexInputState &vertexInputState = pipelines[setPipeline].vertexInputState;
     std::vector<UINT> strides;
     std::vector<UINT> offsets;
@@ -982,6 +1011,10 @@ void GraphicsAPI_D3D11::SetVertexBuffers(void **vertexBuffers, size_t count) {
 }
 
 void GraphicsAPI_D3D11::SetIndexBuffer(void *indexBuffer) {
+    if (!FilterSetIndexBuffer(indexBuffer)) {
+        return;
+    }
+
     ID3D11Buffer *d3d11IndexBuffer = (ID3D11Buffer *)indexBuffer;
     const BufferCreateInfo &bufferCI = buffers[d3d11IndexBuffer];
     immediateContext->IASetIndexBuffer(d3d11IndexBuffer, bufferCI.stride == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT, 0);
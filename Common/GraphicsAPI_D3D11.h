@@ -77,6 +77,8 @@ private:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() override;
     virtual const std::vector<int64_t> GetSupportedDepthSwapchainFormats() override;
 
+    virtual void SetTransientUniformData(void* buffer, size_t offset, size_t size, const void* data, bool discard) override;
+
 private:
     IDXGIFactory4* factory = nullptr;
     ID3D11Device* device = nullptr;
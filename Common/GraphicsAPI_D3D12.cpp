@@ -66,6 +66,10 @@ static DXGI_FORMAT ToDXGI_FORMAT(GraphicsAPI::VertexType type) {
         return DXGI_FORMAT_R32G32B32_UINT;
     case GraphicsAPI::VertexType::UVEC4:
         return DXGI_FORMAT_R32G32B32A32_UINT;
+    case GraphicsAPI::VertexType::VEC4_SNORM16:
+        return DXGI_FORMAT_R16G16B16A16_SNORM;
+    case GraphicsAPI::VertexType::VEC4_SNORM8:
+        return DXGI_FORMAT_R8G8B8A8_SNORM;
     default:
         return DXGI_FORMAT_UNKNOWN;
     }
@@ -292,6 +296,7 @@ GraphicsAPI_D3D12::GraphicsAPI_D3D12(XrInstance m_xrInstance, XrSystemId systemI
 }
 
 GraphicsAPI_D3D12 ::~GraphicsAPI_D3D12() {
+    DestroyTransientUniforms();
     D3D12_SAFE_RELEASE(SAMPLER_DescriptorHeap);
     D3D12_SAFE_RELEASE(CBV_SRV_UAV_DescriptorHeap);
     D3D12_SAFE_RELEASE(queue);
@@ -750,6 +755,7 @@ void *GraphicsAPI_D3D12::CreateBuffer(const BufferCreateInfo &bufferCI) {
 }
 
 void GraphicsAPI_D3D12::DestroyBuffer(void *&buffer) {
+    InvalidateBoundState();
     ID3D12Resource *d3d12Buffer = reinterpret_cast<ID3D12Resource *>(buffer);
     ID3D12Heap *heap = bufferResources[d3d12Buffer].first;
     bufferResources.erase(d3d12Buffer);
@@ -1000,6 +1006,7 @@ void *GraphicsAPI_D3D12::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
 }
 
 void GraphicsAPI_D3D12::DestroyPipeline(void *&pipeline) {
+    InvalidateBoundState();
     ID3D12PipelineState *d3d12Pipeline = reinterpret_cast<ID3D12PipelineState *>(pipeline);
     ID3D12RootSignature *rootSignature = pipelineResources[d3d12Pipeline].first;
     pipelineResources.erase(d3d12Pipeline);
@@ -1016,6 +1023,10 @@ void GraphicsAPI_D3D12::BeginRendering() {
     CBV_SRV_UAV_DescriptorOffset = 0;
     SAMPLER_DescriptorOffset = 0;
 
+    // EndRendering() waits for the GPU to finish, so a single set of pages is enough.
+    BeginTransientUniforms(0);
+    InvalidateBoundState();
+
     if (currentDesktopSwapchainImage) {
         D3D12_RESOURCE_BARRIER swapchainImageBarrier;
         swapchainImageBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -1133,6 +1144,10 @@ void GraphicsAPI_D3D12::SetScissors(Rect2D *scissors, size_t count) {
 }
 
 void GraphicsAPI_D3D12::SetPipeline(void *pipeline) {
+    if (!FilterSetPipeline(pipeline)) {
+        return;
+    }
+
     ID3D12PipelineState *d3d12Pipeline = reinterpret_cast<ID3D12PipelineState *>(pipeline);
     setPipeline = d3d12Pipeline;
 
@@ -1234,6 +1249,10 @@ void GraphicsAPI_D3D12::UpdateDescriptors() {
 }
 
 void GraphicsAPI_D3D12::SetVertexBuffers(void **vertexBuffers, size_t count) {
+    if (!FilterSetVertexBuffers(vertexBuffers, count)) {
+        return;
+    }
+
     std::vector<D3D12_VERTEX_BUFFER_VIEW> vertexBufferViews;
     vertexBufferViews.reserve(count);
     for (size_t i = 0; i < count; i++) {
@@ -1253,6 +1272,10 @@ void GraphicsAPI_D3D12::SetVertexBuffers(void **vertexBuffers, size_t count) {
 }
 
 void GraphicsAPI_D3D12::SetIndexBuffer(void *indexBuffer) {
+    if (!FilterSetIndexBuffer(indexBuffer)) {
+        return;
+    }
+
     ID3D12Resource *d3d12IndexBuffer = reinterpret_cast<ID3D12Resource *>(indexBuffer);
     const BufferCreateInfo &bufferCI = bufferResources[d3d12IndexBuffer].second;
     D3D12_INDEX_BUFFER_VIEW indexBufferView;
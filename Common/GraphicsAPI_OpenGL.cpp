@@ -18,6 +18,12 @@ void (*GetExtension(const char *functionName))() { return glXGetProcAddress((con
 void (*GetExtension(const char *functionName))() { return eglGetProcAddress(functionName); }
 #endif
 
+// GL_KHR_parallel_shader_compile, which older headers don't define.
+#if !defined(GL_COMPLETION_STATUS_KHR)
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void(APIENTRY *PFN_glMaxShaderCompilerThreadsKHR)(GLuint count);
+
 #pragma region PiplineHelpers
 
 GLenum GetGLTextureTarget(const GraphicsAPI::ImageCreateInfo &imageCI) {
@@ -413,9 +419,65 @@ GraphicsAPI_OpenGL::GraphicsAPI_OpenGL(XrInstance m_xrInstance, XrSystemId syste
     glDebugMessageCallback(GLDebugCallback, nullptr);
     glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
     glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+    // GL_OVR_multiview draws every layer of a 2D array framebuffer attachment in one pass, with gl_ViewID_OVR set to the layer.
+    // GL_KHR_parallel_shader_compile links programs on the driver's threads, for CreatePipelineAsync().
+    // GL_ARB_buffer_storage, core in 4.4, gives the streaming buffers persistent mappings.
+    // GL_ARB_timer_query, core in 3.3, gives the GL_TIMESTAMP queries of WriteTimestamp().
+    // GL_ARB_get_program_binary, core in 4.1, gives the program binaries of LoadPipelineCache() and SavePipelineCache().
+    // Entry points can't be used to detect these, as glXGetProcAddress() returns a function for any name.
+    bufferStorageSupported = glMajorVersion > 4 || (glMajorVersion == 4 && glMinorVersion >= 4);
+    timerQuerySupported = glMajorVersion > 3 || (glMajorVersion == 3 && glMinorVersion >= 3);
+    bool programBinarySupported = glMajorVersion > 4 || (glMajorVersion == 4 && glMinorVersion >= 1);
+    PFNGLGETSTRINGIPROC glGetStringi = (PFNGLGETSTRINGIPROC)GetExtension("glGetStringi");  // 3.0+
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; glGetStringi && i < extensionCount; i++) {
+        const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (!extension) {
+            continue;
+        }
+        if (strcmp(extension, "GL_OVR_multiview") == 0) {
+            multiviewSupported = true;
+        } else if (strcmp(extension, "GL_KHR_parallel_shader_compile") == 0) {
+            parallelShaderCompileSupported = true;
+        } else if (strcmp(extension, "GL_ARB_buffer_storage") == 0) {
+            bufferStorageSupported = true;
+        } else if (strcmp(extension, "GL_ARB_timer_query") == 0) {
+            timerQuerySupported = true;
+        } else if (strcmp(extension, "GL_ARB_get_program_binary") == 0) {
+            programBinarySupported = true;
+        }
+    }
+    PFNGLPROGRAMBINARYPROC glProgramBinary = (PFNGLPROGRAMBINARYPROC)GetExtension("glProgramBinary");              // 4.1+
+    PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)GetExtension("glGetProgramBinary");  // 4.1+
+    programBinaryCache.Init(programBinarySupported, glProgramBinary, glGetProgramBinary);
+    if (parallelShaderCompileSupported) {
+        PFN_glMaxShaderCompilerThreadsKHR glMaxShaderCompilerThreadsKHR = (PFN_glMaxShaderCompilerThreadsKHR)GetExtension("glMaxShaderCompilerThreadsKHR");
+        if (glMaxShaderCompilerThreadsKHR) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);  // As many threads as the driver likes.
+        } else {
+            parallelShaderCompileSupported = false;
+        }
+    }
 }
 
 GraphicsAPI_OpenGL::~GraphicsAPI_OpenGL() {
+    DestroyTransientUniforms();
+
+    PFNGLDELETESYNCPROC glDeleteSync = (PFNGLDELETESYNCPROC)GetExtension("glDeleteSync");  // 3.2+
+    for (GLsync &fence : frameFences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+
+    objectCache.Destroy();
+    if (!timestampQueries.empty()) {
+        PFNGLDELETEQUERIESPROC glDeleteQueries = (PFNGLDELETEQUERIESPROC)GetExtension("glDeleteQueries");  // 1.5+
+        glDeleteQueries(static_cast<GLsizei>(timestampQueries.size()), timestampQueries.data());
+    }
+
     ksGpuWindow_Destroy(&window);
 }
 // XR_DOCS_TAG_END_GraphicsAPI_OpenGL
@@ -545,6 +607,7 @@ void *GraphicsAPI_OpenGL::CreateImageView(const ImageViewCreateInfo &imageViewCI
 
 void GraphicsAPI_OpenGL::DestroyImageView(void *&imageView) {
     GLuint framebuffer = (GLuint)(uint64_t)imageView;
+    objectCache.EvictFramebuffers(framebuffer, setFramebuffer);
     imageViews.erase(framebuffer);
     glDeleteFramebuffers(1, &framebuffer);
     imageView = nullptr;
@@ -610,15 +673,39 @@ void *GraphicsAPI_OpenGL::CreateBuffer(const BufferCreateInfo &bufferCI) {
     }
 
     glBindBuffer(target, buffer);
-    glBufferData(target, (GLsizeiptr)bufferCI.size, bufferCI.data, GL_STATIC_DRAW);
+    if (bufferCI.streaming && bufferStorageSupported) {
+        PFNGLBUFFERSTORAGEPROC glBufferStorage = (PFNGLBUFFERSTORAGEPROC)GetExtension("glBufferStorage");  // 4.4+
+        // A coherent mapping makes CPU writes visible to the GPU without flushing or unmapping.
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, (GLsizeiptr)bufferCI.size, bufferCI.data, flags);
+        PFNGLMAPBUFFERRANGEPROC glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)GetExtension("glMapBufferRange");  // 3.0+
+        bufferMappings[buffer] = glMapBufferRange(target, 0, (GLsizeiptr)bufferCI.size, flags);
+    } else {
+        glBufferData(target, (GLsizeiptr)bufferCI.size, bufferCI.data, bufferCI.streaming ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+    }
     glBindBuffer(target, 0);
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        InvalidateBoundBuffers();
+    }
 
     buffers[buffer] = bufferCI;
     return (void *)(uint64_t)buffer;
 }
 
 void GraphicsAPI_OpenGL::DestroyBuffer(void *&buffer) {
+    InvalidateBoundState();
     GLuint glBuffer = (GLuint)(uint64_t)buffer;
+    auto copiesIt = bufferCopies.find(glBuffer);
+    if (copiesIt != bufferCopies.end()) {
+        const std::vector<GLuint> copies = copiesIt->second.copies;
+        bufferCopies.erase(copiesIt);
+        for (size_t i = 1; i < copies.size(); i++) {
+            void *copy = (void *)(uint64_t)copies[i];
+            DestroyBuffer(copy);
+        }
+    }
+    bufferFrameNumbers.erase(glBuffer);
+    bufferMappings.erase(glBuffer);  // Deleting the buffer unmaps it.
     buffers.erase(glBuffer);
     glDeleteBuffers(1, &glBuffer);
     buffer = nullptr;
@@ -656,7 +743,9 @@ void *GraphicsAPI_OpenGL::CreateShader(const ShaderCreateInfo &shaderCI) {
     }
     GLuint shader = glCreateShader(type);
 
-    glShaderSource(shader, 1, &shaderCI.sourceData, nullptr);
+    // The source may be a FileView, which is not null-terminated.
+    const GLint sourceLength = static_cast<GLint>(shaderCI.sourceSize);
+    glShaderSource(shader, 1, &shaderCI.sourceData, &sourceLength);
     glCompileShader(shader);
 
     GLint isCompiled = 0;
@@ -672,6 +761,8 @@ void *GraphicsAPI_OpenGL::CreateShader(const ShaderCreateInfo &shaderCI) {
 
         glDeleteShader(shader);
         shader = 0;
+    } else {
+        programBinaryCache.AddShader(shader, type, shaderCI.sourceData, shaderCI.sourceSize);
     }
 
     return (void *)(uint64_t)shader;
@@ -679,17 +770,41 @@ void *GraphicsAPI_OpenGL::CreateShader(const ShaderCreateInfo &shaderCI) {
 
 void GraphicsAPI_OpenGL::DestroyShader(void *&shader) {
     GLuint glShader = (GLuint)(uint64_t)shader;
+    programBinaryCache.RemoveShader(glShader);
     glDeleteShader(glShader);
     shader = nullptr;
 }
 
 void *GraphicsAPI_OpenGL::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
-    GLuint program = glCreateProgram();
+    return FinishProgramLink(StartProgramLink(pipelineCI));
+}
+
+GraphicsAPI_OpenGL::ProgramLink GraphicsAPI_OpenGL::StartProgramLink(const PipelineCreateInfo &pipelineCI) {
+    // A program linked from the same shaders, in this or an earlier run, may have left a binary that can be loaded instead of linking.
+    ProgramLink link = {glCreateProgram(), programBinaryCache.GetProgramKey(pipelineCI.shaders), false, pipelineCI};
+    if (programBinaryCache.Load(link.program, link.programKey)) {
+        link.loadedBinary = true;
+        return link;
+    }
 
     for (const void *const &shader : pipelineCI.shaders)
-        glAttachShader(program, (GLuint)(uint64_t)shader);
+        glAttachShader(link.program, (GLuint)(uint64_t)shader);
+
+    if (programBinaryCache.IsSupported()) {
+        PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)GetExtension("glProgramParameteri");  // 4.1+
+        glProgramParameteri(link.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(link.program);
+    return link;
+}
 
-    glLinkProgram(program);
+void *GraphicsAPI_OpenGL::FinishProgramLink(const ProgramLink &link) {
+    const GLuint program = link.program;
+    const PipelineCreateInfo &pipelineCI = link.pipelineCI;
+    if (link.loadedBinary) {
+        pipelines[program] = pipelineCI;
+        return (void *)(uint64_t)program;
+    }
 
     PFNGLVALIDATEPROGRAMPROC glValidateProgram = (PFNGLVALIDATEPROGRAMPROC)GetExtension("glValidateProgram");  // 2.0+
     glValidateProgram(program);
@@ -704,6 +819,8 @@ void *GraphicsAPI_OpenGL::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
         glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
 
         glDeleteProgram(program);
+    } else {
+        programBinaryCache.Store(program, link.programKey);
     }
 
     PFNGLDETACHSHADERPROC glDetachShader = (PFNGLDETACHSHADERPROC)GetExtension("glDetachShader");  // 2.0+
@@ -715,33 +832,164 @@ void *GraphicsAPI_OpenGL::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
     return (void *)(uint64_t)program;
 }
 
+void *GraphicsAPI_OpenGL::StartPipelineBuild(const PipelineCreateInfo &pipelineCI) {
+    return new ProgramLink(StartProgramLink(pipelineCI));
+}
+
+bool GraphicsAPI_OpenGL::FinishPipelineBuild(void *build, bool wait, void *&pipeline) {
+    ProgramLink *link = reinterpret_cast<ProgramLink *>(build);
+    // Querying the link status waits for the link, so with GL_KHR_parallel_shader_compile it is only queried once the link has
+    // completed. Without it, the link is finished on the next call, which still gives drivers that link lazily a frame's head start.
+    if (!wait && !link->loadedBinary && parallelShaderCompileSupported) {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(link->program, GL_COMPLETION_STATUS_KHR, &completed);
+        if (completed == GL_FALSE) {
+            return false;
+        }
+    }
+    pipeline = FinishProgramLink(*link);
+    delete link;
+    return true;
+}
+
 void GraphicsAPI_OpenGL::DestroyPipeline(void *&pipeline) {
+    InvalidateBoundState();
     GLint program = (GLuint)(uint64_t)pipeline;
     pipelines.erase(program);
     glDeleteProgram(program);
     pipeline = nullptr;
 }
 
+void GraphicsAPI_OpenGL::LoadPipelineCache(const std::string &filepath) {
+    programBinaryCache.LoadFile(filepath);
+}
+
+void GraphicsAPI_OpenGL::SavePipelineCache(const std::string &filepath) {
+    programBinaryCache.SaveFile(filepath);
+}
+
 void GraphicsAPI_OpenGL::BeginRendering() {
-    glGenVertexArrays(1, &vertexArray);
-    glBindVertexArray(vertexArray);
+    // Move on to the next frame's transient uniform pages, waiting if the GPU may still be reading them.
+    frameNumber++;
+    frameIndex = frameNumber % frameFences.size();
+    GLsync &fence = frameFences[frameIndex];
+    if (fence) {
+        PFNGLDELETESYNCPROC glDeleteSync = (PFNGLDELETESYNCPROC)GetExtension("glDeleteSync");  // 3.2+
+        WaitForFence(fence);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    BeginTransientUniforms(frameIndex);
+    InvalidateBoundState();
+}
 
-    glGenFramebuffers(1, &setFramebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+void GraphicsAPI_OpenGL::WaitForFence(GLsync fence) {
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)GetExtension("glClientWaitSync");  // 3.2+
+    const GLuint64 timeout = 1000000000;                                                                // 1 second
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, timeout);
+    }
+    if (result == GL_WAIT_FAILED) {
+        std::cout << "ERROR: OPENGL: Failed to wait for frame fence." << std::endl;
+    }
+}
+
+size_t GraphicsAPI_OpenGL::GetUniformBufferOffsetAlignment() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return static_cast<size_t>(alignment);
 }
 
 void GraphicsAPI_OpenGL::EndRendering() {
+    PFNGLFENCESYNCPROC glFenceSync = (PFNGLFENCESYNCPROC)GetExtension("glFenceSync");  // 3.2+
+    frameFences[frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // The cached framebuffer and vertex array stay alive, but are unbound so that nothing outside of rendering modifies them.
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDeleteFramebuffers(1, &setFramebuffer);
     setFramebuffer = 0;
 
     glBindVertexArray(0);
-    glDeleteVertexArrays(1, &vertexArray);
     vertexArray = 0;
 }
 
+bool GraphicsAPI_OpenGL::WriteTimestamp(uint64_t &timestamp) {
+    if (!timerQuerySupported) {
+        return false;
+    }
+    PFNGLQUERYCOUNTERPROC glQueryCounter = (PFNGLQUERYCOUNTERPROC)GetExtension("glQueryCounter");  // 3.3+
+    GLuint query = 0;
+    if (freeTimestampQueries.empty()) {
+        PFNGLGENQUERIESPROC glGenQueries = (PFNGLGENQUERIESPROC)GetExtension("glGenQueries");  // 1.5+
+        glGenQueries(1, &query);
+        timestampQueries.push_back(query);
+    } else {
+        query = freeTimestampQueries.back();
+        freeTimestampQueries.pop_back();
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    timestamp = query;
+    return true;
+}
+
+bool GraphicsAPI_OpenGL::ReadTimestamp(uint64_t timestamp, uint64_t &nanoseconds) {
+    PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)GetExtension("glGetQueryObjectiv");              // 1.5+
+    PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)GetExtension("glGetQueryObjectui64v");  // 3.3+
+    const GLuint query = (GLuint)timestamp;
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+    GLuint64 result = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+    nanoseconds = result;
+    return true;
+}
+
+void GraphicsAPI_OpenGL::ReleaseTimestamp(uint64_t timestamp) {
+    freeTimestampQueries.push_back((GLuint)timestamp);
+}
+
+void *GraphicsAPI_OpenGL::GetBufferMappedData(void *buffer) {
+    auto mapping = bufferMappings.find(GetBufferCopy((GLuint)(uint64_t)buffer));
+    return mapping != bufferMappings.end() ? mapping->second : nullptr;
+}
+
+void GraphicsAPI_OpenGL::SetTransientUniformData(void *buffer, size_t offset, size_t size, const void *data, bool discard) {
+    GLuint glBuffer = (GLuint)(uint64_t)buffer;
+    auto mapping = bufferMappings.find(glBuffer);
+    if (mapping != bufferMappings.end()) {
+        // BeginRendering() waited for the frame that last used this page, so the GPU is no longer reading it.
+        memcpy((char *)mapping->second + offset, data, size);
+        return;
+    }
+
+    // Without glBufferStorage(), orphan the page on its first write so that the driver can hand out new memory instead of
+    // waiting for draws that still read the old contents.
+    glBindBuffer(GL_UNIFORM_BUFFER, glBuffer);
+    if (discard) {
+        glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)buffers[glBuffer].size, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
 void GraphicsAPI_OpenGL::SetBufferData(void *buffer, size_t offset, size_t size, void *data) {
+    if (!data) {
+        return;
+    }
+
     GLuint glBuffer = (GLuint)(uint64_t)buffer;
+
+    // Buffers created with glBufferStorage() are immutable, and are written through their mapping instead. Write a copy
+    // that no frame in flight is reading, rather than wait for the GPU.
+    if (bufferMappings.find(glBuffer) != bufferMappings.end()) {
+        const GLuint copy = GetWritableBufferCopy(glBuffer, offset, size);
+        memcpy((char *)bufferMappings[copy] + offset, data, size);
+        return;
+    }
+
     const BufferCreateInfo &bufferCI = buffers[glBuffer];
 
     GLenum target = 0;
@@ -756,11 +1004,83 @@ void GraphicsAPI_OpenGL::SetBufferData(void *buffer, size_t offset, size_t size,
         std::cout << "ERROR: OPENGL: Unknown Buffer Type." << std::endl;
     }
 
-    if (data) {
-        glBindBuffer(target, glBuffer);
-        glBufferSubData(target, (GLintptr)offset, (GLsizeiptr)size, data);
-        glBindBuffer(target, 0);
+    glBindBuffer(target, glBuffer);
+    // Without glBufferStorage(), orphan a streaming buffer that is rewritten whole, so that the driver can hand out new
+    // memory instead of waiting for draws that still read the old contents. A partial write has to keep the rest.
+    if (bufferCI.streaming && offset == 0 && size >= bufferCI.size) {
+        glBufferData(target, (GLsizeiptr)bufferCI.size, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(target, (GLintptr)offset, (GLsizeiptr)size, data);
+    glBindBuffer(target, 0);
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        // The index buffer binding is part of the bound vertex array, so this unbound the one set by SetIndexBuffer().
+        InvalidateBoundBuffers();
+    }
+}
+
+void GraphicsAPI_OpenGL::TrackBufferUse(GLuint buffer) {
+    if (bufferMappings.find(buffer) != bufferMappings.end()) {
+        bufferFrameNumbers[buffer] = frameNumber;
+    }
+}
+
+GLuint GraphicsAPI_OpenGL::GetBufferCopy(GLuint buffer) {
+    auto copiesIt = bufferCopies.find(buffer);
+    return copiesIt != bufferCopies.end() ? copiesIt->second.copies[copiesIt->second.current] : buffer;
+}
+
+GLuint GraphicsAPI_OpenGL::GetWritableBufferCopy(GLuint buffer, size_t offset, size_t size) {
+    // Frames older than the last frameFences.size() have finished, as BeginRendering() waited for them.
+    auto isInUse = [&](GLuint copy) {
+        auto it = bufferFrameNumbers.find(copy);
+        return it != bufferFrameNumbers.end() && it->second + frameFences.size() > frameNumber;
+    };
+
+    BufferCopies &bufferCopy = bufferCopies[buffer];
+    if (bufferCopy.copies.empty()) {
+        bufferCopy.copies.push_back(buffer);
+    }
+    std::vector<GLuint> &copies = bufferCopy.copies;
+    const size_t current = bufferCopy.current;
+    if (!isInUse(copies[current])) {
+        return copies[current];
+    }
+
+    // Move on to the next copy that no frame reads, or create one.
+    size_t next = copies.size();
+    for (size_t i = 1; i < copies.size(); i++) {
+        const size_t index = (current + i) % copies.size();
+        if (!isInUse(copies[index])) {
+            next = index;
+            break;
+        }
+    }
+    if (next == copies.size()) {
+        if (copies.size() < frameFences.size() + 1) {
+            BufferCreateInfo copyCI = buffers[buffer];
+            copyCI.data = nullptr;
+            copies.push_back((GLuint)(uint64_t)CreateBuffer(copyCI));
+        } else {
+            // Every copy is in use, so wait for the oldest. If the frame being recorded reads it, the buffer was rewritten
+            // more often in one frame than it has copies, and it's overwritten as before. Such data belongs in
+            // AllocateTransientUniform().
+            next = (current + 1) % copies.size();
+            const uint64_t copyFrameNumber = bufferFrameNumbers[copies[next]];
+            const GLsync fence = frameFences[copyFrameNumber % frameFences.size()];
+            if (copyFrameNumber < frameNumber && fence) {
+                WaitForFence(fence);
+            }
+        }
+    }
+
+    const size_t bufferSize = buffers[buffer].size;
+    if (offset != 0 || size < bufferSize) {
+        memcpy(bufferMappings[copies[next]], bufferMappings[copies[current]], bufferSize);
     }
+    bufferCopy.current = next;
+    // The redundant state filter may still have the buffer as bound, but commands from now on must bind the new copy.
+    InvalidateBoundState();
+    return copies[next];
 }
 
 void GraphicsAPI_OpenGL::ClearColor(void *imageView, float r, float g, float b, float a) {
@@ -778,13 +1098,12 @@ void GraphicsAPI_OpenGL::ClearDepth(void *imageView, float d) {
 }
 
 void GraphicsAPI_OpenGL::SetRenderAttachments(void **colorViews, size_t colorViewCount, void *depthStencilView, uint32_t width, uint32_t height, void *pipeline) {
-    // Reset Framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDeleteFramebuffers(1, &setFramebuffer);
-    setFramebuffer = 0;
-
-    glGenFramebuffers(1, &setFramebuffer);
+    bool created = false;
+    setFramebuffer = objectCache.GetFramebuffer(colorViews, colorViewCount, depthStencilView, created);
     glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+    if (!created) {
+        return;
+    }
 
     // Color
     for (size_t i = 0; i < colorViewCount; i++) {
@@ -845,12 +1164,25 @@ void GraphicsAPI_OpenGL::SetScissors(Rect2D *scissors, size_t count) {
 }
 
 void GraphicsAPI_OpenGL::SetPipeline(void *pipeline) {
+    if (!FilterSetPipeline(pipeline)) {
+        return;
+    }
+
     GLuint program = (GLuint)(uint64_t)pipeline;
     glUseProgram(program);
     setPipeline = program;
 
     const PipelineCreateInfo &pipelineCI = pipelines[program];
 
+    // Pipelines with the same vertex input layout share a vertex array.
+    GLuint pipelineVertexArray = objectCache.GetVertexArray(pipelineCI.vertexInputState);
+    if (pipelineVertexArray != vertexArray) {
+        vertexArray = pipelineVertexArray;
+        glBindVertexArray(vertexArray);
+        // The vertex and index buffer bindings belong to the vertex array, so the other one's bindings don't apply.
+        InvalidateBoundBuffers();
+    }
+
     // InputAssemblyState
     const InputAssemblyState &IAS = pipelineCI.inputAssemblyState;
     if (IAS.primitiveRestartEnable) {
@@ -1050,7 +1382,9 @@ void GraphicsAPI_OpenGL::SetDescriptor(const DescriptorInfo &descriptorInfo) {
     const GLuint &bindingIndex = descriptorInfo.bindingIndex;
     if (descriptorInfo.type == DescriptorInfo::Type::BUFFER) {
         PFNGLBINDBUFFERRANGEPROC glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC)GetExtension("glBindBufferRange");  // 3.0+
-        glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, glResource, (GLintptr)descriptorInfo.bufferOffset, (GLsizeiptr)descriptorInfo.bufferSize);
+        const GLuint glBuffer = GetBufferCopy(glResource);
+        TrackBufferUse(glBuffer);
+        glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, glBuffer, (GLintptr)descriptorInfo.bufferOffset, (GLsizeiptr)descriptorInfo.bufferSize);
     } else if (descriptorInfo.type == DescriptorInfo::Type::IMAGE) {
         glActiveTexture(GL_TEXTURE0 + bindingIndex);
         glBindTexture(GetGLTextureTarget(images[glResource]), glResource);
@@ -1066,6 +1400,10 @@ void GraphicsAPI_OpenGL::UpdateDescriptors() {
 }
 
 void GraphicsAPI_OpenGL::SetVertexBuffers(void **vertexBuffers, size_t count) {
+    if (!FilterSetVertexBuffers(vertexBuffers, count)) {
+        return;
+    }
+
     const VertexInputState &vertexInputState = pipelines[setPipeline].vertexInputState;
     for (size_t i = 0; i < count; i++) {
         GLuint glVertexBufferID = (GLuint)(uint64_t)vertexBuffers[i];
@@ -1073,7 +1411,9 @@ void GraphicsAPI_OpenGL::SetVertexBuffers(void **vertexBuffers, size_t count) {
             std::cout << "ERROR: OpenGL: Provided buffer is not type: VERTEX." << std::endl;
         }
 
-        glBindBuffer(GL_ARRAY_BUFFER, (GLuint)(uint64_t)vertexBuffers[i]);
+        const GLuint glVertexBuffer = GetBufferCopy(glVertexBufferID);
+        TrackBufferUse(glVertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, glVertexBuffer);
 
         // https://i.redd.it/fyxp5ah06a661.png
         for (const VertexInputBinding &vertexBinding : vertexInputState.bindings) {
@@ -1084,10 +1424,16 @@ void GraphicsAPI_OpenGL::SetVertexBuffers(void **vertexBuffers, size_t count) {
                         GLint size = ((GLint)vertexAttribute.vertexType % 4) + 1;
                         GLenum type = (GLenum)vertexAttribute.vertexType >= (GLenum)VertexType::UINT ? GL_UNSIGNED_INT : (GLenum)vertexAttribute.vertexType >= (GLenum)VertexType::INT ? GL_INT
                                                                                                                                                                                        : GL_FLOAT;
+                        GLboolean normalized = GL_FALSE;
+                        if (vertexAttribute.vertexType == VertexType::VEC4_SNORM16 || vertexAttribute.vertexType == VertexType::VEC4_SNORM8) {
+                            size = 4;
+                            type = vertexAttribute.vertexType == VertexType::VEC4_SNORM16 ? GL_SHORT : GL_BYTE;
+                            normalized = GL_TRUE;
+                        }
                         GLsizei stride = vertexBinding.stride;
                         const void *offset = (const void *)vertexAttribute.offset;
                         glEnableVertexAttribArray(attribIndex);
-                        glVertexAttribPointer(attribIndex, size, type, false, stride, offset);
+                        glVertexAttribPointer(attribIndex, size, type, normalized, stride, offset);
                     }
                 }
             }
@@ -1096,11 +1442,17 @@ void GraphicsAPI_OpenGL::SetVertexBuffers(void **vertexBuffers, size_t count) {
 }
 
 void GraphicsAPI_OpenGL::SetIndexBuffer(void *indexBuffer) {
+    if (!FilterSetIndexBuffer(indexBuffer)) {
+        return;
+    }
+
     GLuint glIndexBufferID = (GLuint)(uint64_t)indexBuffer;
     if (buffers[glIndexBufferID].type != BufferCreateInfo::Type::INDEX) {
         std::cout << "ERROR: OpenGL: Provided buffer is not type: INDEX." << std::endl;
     }
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBufferID);
+    const GLuint glIndexBuffer = GetBufferCopy(glIndexBufferID);
+    TrackBufferUse(glIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBuffer);
     setIndexBuffer = glIndexBufferID;
 }
 
@@ -5,7 +5,7 @@
 // OpenXR Tutorial for Khronos Group
 
 #pragma once
-#include <GraphicsAPI.h>
+#include <GraphicsAPI_OpenGL_Common.h>
 
 #if defined(XR_USE_GRAPHICS_API_OPENGL)
 class GraphicsAPI_OpenGL : public GraphicsAPI {
@@ -53,10 +53,14 @@ public:
     virtual void* CreatePipeline(const PipelineCreateInfo& pipelineCI) override;
     virtual void DestroyPipeline(void*& pipeline) override;
 
+    virtual void LoadPipelineCache(const std::string& filepath) override;
+    virtual void SavePipelineCache(const std::string& filepath) override;
+
     virtual void BeginRendering() override;
     virtual void EndRendering() override;
 
     virtual void SetBufferData(void* buffer, size_t offset, size_t size, void* data) override;
+    virtual void* GetBufferMappedData(void* buffer) override;
 
     virtual void ClearColor(void* imageView, float r, float g, float b, float a) override;
     virtual void ClearDepth(void* imageView, float d) override;
@@ -73,10 +77,44 @@ public:
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0) override;
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) override;
 
+    // Multiview needs GL_OVR_multiview. The views are given by the vertex shader's num_views layout, not the viewMask.
+    virtual bool SupportsMultiview() override { return multiviewSupported; }
+
 private:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() override;
     virtual const std::vector<int64_t> GetSupportedDepthSwapchainFormats() override;
 
+    virtual size_t GetUniformBufferOffsetAlignment() override;
+    virtual void SetTransientUniformData(void* buffer, size_t offset, size_t size, const void* data, bool discard) override;
+
+    virtual bool WriteTimestamp(uint64_t& timestamp) override;
+    virtual bool ReadTimestamp(uint64_t timestamp, uint64_t& nanoseconds) override;
+    virtual void ReleaseTimestamp(uint64_t timestamp) override;
+
+
+    // CreatePipeline() in two steps, so that CreatePipelineAsync() can let the driver link the program in the background.
+    // StartProgramLink() loads the program from a stored binary, or starts linking it, and FinishProgramLink() checks the result.
+    struct ProgramLink {
+        GLuint program;
+        uint64_t programKey;
+        bool loadedBinary;
+        PipelineCreateInfo pipelineCI;
+    };
+    ProgramLink StartProgramLink(const PipelineCreateInfo& pipelineCI);
+    void* FinishProgramLink(const ProgramLink& link);
+    virtual void* StartPipelineBuild(const PipelineCreateInfo& pipelineCI) override;
+    virtual bool FinishPipelineBuild(void* build, bool wait, void*& pipeline) override;
+
+    // Waits until the GPU has finished the commands before the fence.
+    void WaitForFence(GLsync fence);
+    // Records that the buffer is used by the current frame, so that SetBufferData() doesn't overwrite it while the GPU reads it.
+    void TrackBufferUse(GLuint buffer);
+    // The copy of a persistently mapped buffer that commands bind in its place. See bufferCopies.
+    GLuint GetBufferCopy(GLuint buffer);
+    // Makes a copy of the persistently mapped buffer that no frame in flight reads the current one, and returns it. The
+    // rest of the contents are carried over from the previous copy, unless size bytes at offset are all of them.
+    GLuint GetWritableBufferCopy(GLuint buffer, size_t offset, size_t size);
+
 private:
     ksGpuWindow window{};
 
@@ -94,13 +132,44 @@ private:
     std::unordered_map<XrSwapchain, std::pair<SwapchainType, std::vector<XrSwapchainImageOpenGLKHR>>> swapchainImagesMap{};
 
     std::unordered_map<GLuint, BufferCreateInfo> buffers{};
+    // Persistent mappings of the streaming buffers created with glBufferStorage().
+    std::unordered_map<GLuint, void*> bufferMappings{};
+    // SetBufferData() doesn't overwrite a persistently mapped buffer that a frame in flight may still read. It writes
+    // another copy of the buffer instead, created on first use, and commands from then on bind that copy in its place.
+    // A buffer has at most one copy per frame fence, plus one for the frame being recorded.
+    struct BufferCopies {
+        std::vector<GLuint> copies;  // copies[0] is the buffer itself.
+        size_t current = 0;
+    };
+    std::unordered_map<GLuint, BufferCopies> bufferCopies{};
+    // The frame that last bound each persistently mapped buffer, counted by frameNumber.
+    std::unordered_map<GLuint, uint64_t> bufferFrameNumbers{};
     std::unordered_map<GLuint, ImageCreateInfo> images{};
     std::unordered_map<GLuint, ImageViewCreateInfo> imageViews{};
 
+    bool multiviewSupported = false;
+    bool parallelShaderCompileSupported = false;
+    bool bufferStorageSupported = false;
+    bool timerQuerySupported = false;
+
     GLuint setFramebuffer = 0;
     std::unordered_map<GLuint, PipelineCreateInfo> pipelines{};
+    // Persisted by LoadPipelineCache() and SavePipelineCache().
+    GLProgramBinaryCache programBinaryCache{};
     GLuint setPipeline = 0;
     GLuint vertexArray = 0;
+
+    // The transient uniform pages are used round robin by three frames. Each frame's fence is signalled when the GPU has
+    // finished its commands, and BeginRendering() waits on it before the frame's pages are rewritten.
+    std::vector<GLsync> frameFences{nullptr, nullptr, nullptr};
+    size_t frameIndex = 0;
+    // Counts the calls to BeginRendering(). Frame N uses frameFences[N % frameFences.size()].
+    uint64_t frameNumber = 0;
+    GLObjectCache objectCache{};
     GLuint setIndexBuffer = 0;
+
+    // Every GL_TIMESTAMP query created by WriteTimestamp(), and those whose results have been read and can be reused.
+    std::vector<GLuint> timestampQueries{};
+    std::vector<GLuint> freeTimestampQueries{};
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <GraphicsAPI_OpenGL_Common.h>
+#include <FileView.h>
+
+#if defined(XR_USE_GRAPHICS_API_OPENGL) || defined(XR_USE_GRAPHICS_API_OPENGL_ES)
+
+// The pipeline cache file holds a ProgramBinaryFileHeader followed by entryCount entries, each a ProgramBinaryEntryHeader and its binary.
+// Program binaries are only valid for the driver that produced them, so the file is discarded if the driver strings have changed.
+struct ProgramBinaryFileHeader {
+    uint32_t magic;
+    uint32_t entryCount;
+    uint64_t deviceHash;
+};
+struct ProgramBinaryEntryHeader {
+    uint64_t programKey;
+    uint32_t format;
+    uint32_t size;
+};
+static const uint32_t programBinaryFileMagic = 0x43504758;  // "XGPC"
+
+static uint64_t GetProgramBinaryDeviceHash() {
+    uint64_t hash = HashBytes(nullptr, 0);
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char *string = (const char *)glGetString(name);
+        if (string) {
+            hash = HashBytes(string, strlen(string), hash);
+        }
+    }
+    return hash;
+}
+
+void GLProgramBinaryCache::Init(bool supported, PFNGLPROGRAMBINARYPROC programBinary, PFNGLGETPROGRAMBINARYPROC getProgramBinary) {
+    GLint formatCount = 0;
+    if (supported) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+    this->supported = formatCount > 0 && programBinary && getProgramBinary;
+    programBinaryProc = programBinary;
+    getProgramBinaryProc = getProgramBinary;
+}
+
+void GLProgramBinaryCache::AddShader(GLuint shader, GLenum type, const char *sourceData, size_t sourceSize) {
+    shaderHashes[shader] = HashBytes(sourceData, sourceSize, HashBytes(&type, sizeof(type)));
+}
+
+void GLProgramBinaryCache::RemoveShader(GLuint shader) {
+    shaderHashes.erase(shader);
+}
+
+uint64_t GLProgramBinaryCache::GetProgramKey(const std::vector<void *> &shaders) {
+    uint64_t programKey = HashBytes(nullptr, 0);
+    for (const void *const &shader : shaders)
+        programKey = HashBytes(&shaderHashes[(GLuint)(uint64_t)shader], sizeof(uint64_t), programKey);
+    return programKey;
+}
+
+bool GLProgramBinaryCache::Load(GLuint program, uint64_t programKey) {
+    auto it = programBinaries.find(programKey);
+    if (it == programBinaries.end()) {
+        return false;
+    }
+
+    programBinaryProc(program, it->second.first, it->second.second.data(), static_cast<GLsizei>(it->second.second.size()));
+
+    GLint isLinked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_FALSE) {
+        // The driver may reject binaries from an older version of itself. Drop it, and the caller links from source instead.
+        programBinaries.erase(it);
+        return false;
+    }
+    return true;
+}
+
+void GLProgramBinaryCache::Store(GLuint program, uint64_t programKey) {
+    if (!supported) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    GLenum format = 0;
+    std::vector<char> binary(length);
+    getProgramBinaryProc(program, length, &length, &format, binary.data());
+    binary.resize(length);
+    programBinaries[programKey] = {format, std::move(binary)};
+}
+
+void GLProgramBinaryCache::LoadFile(const std::string &filepath) {
+    if (!supported) {
+        return;
+    }
+
+    FileView fileData(filepath);
+    if (fileData.GetSize() < sizeof(ProgramBinaryFileHeader)) {
+        return;
+    }
+
+    ProgramBinaryFileHeader header;
+    memcpy(&header, fileData.GetData(), sizeof(header));
+    if (header.magic != programBinaryFileMagic || header.deviceHash != GetProgramBinaryDeviceHash()) {
+        std::cout << "Ignoring pipeline cache " << filepath.c_str() << ". It was written for a different device or driver." << std::endl;
+        return;
+    }
+
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        ProgramBinaryEntryHeader entry;
+        if (fileData.GetSize() - offset < sizeof(entry)) {
+            break;
+        }
+        memcpy(&entry, fileData.GetData() + offset, sizeof(entry));
+        offset += sizeof(entry);
+        if (fileData.GetSize() - offset < entry.size) {
+            break;
+        }
+        programBinaries[entry.programKey] = {(GLenum)entry.format, std::vector<char>(fileData.GetData() + offset, fileData.GetData() + offset + entry.size)};
+        offset += entry.size;
+    }
+}
+
+void GLProgramBinaryCache::SaveFile(const std::string &filepath) {
+    if (!supported) {
+        return;
+    }
+
+    ProgramBinaryFileHeader header = {programBinaryFileMagic, static_cast<uint32_t>(programBinaries.size()), GetProgramBinaryDeviceHash()};
+    std::vector<char> fileData(reinterpret_cast<const char *>(&header), reinterpret_cast<const char *>(&header) + sizeof(header));
+    for (const auto &programBinary : programBinaries) {
+        const std::vector<char> &binary = programBinary.second.second;
+        ProgramBinaryEntryHeader entry = {programBinary.first, programBinary.second.first, static_cast<uint32_t>(binary.size())};
+        fileData.insert(fileData.end(), reinterpret_cast<const char *>(&entry), reinterpret_cast<const char *>(&entry) + sizeof(entry));
+        fileData.insert(fileData.end(), binary.begin(), binary.end());
+    }
+    WriteBinaryFile(filepath, fileData);
+}
+
+void GLObjectCache::Destroy() {
+    for (const auto &framebuffer : framebuffers) {
+        glDeleteFramebuffers(1, &framebuffer.second);
+    }
+    framebuffers.clear();
+    for (const auto &vertexArray : vertexArrays) {
+        glDeleteVertexArrays(1, &vertexArray.second);
+    }
+    vertexArrays.clear();
+}
+
+GLuint GLObjectCache::GetFramebuffer(void **colorViews, size_t colorViewCount, void *depthStencilView, bool &created) {
+    std::vector<uint64_t> framebufferKey;
+    for (size_t i = 0; i < colorViewCount; i++) {
+        framebufferKey.push_back((uint64_t)colorViews[i]);
+    }
+    framebufferKey.push_back((uint64_t)depthStencilView);
+
+    GLuint &framebuffer = framebuffers[framebufferKey];
+    created = !framebuffer;
+    if (created) {
+        glGenFramebuffers(1, &framebuffer);
+    }
+    return framebuffer;
+}
+
+void GLObjectCache::EvictFramebuffers(GLuint imageView, GLuint &boundFramebuffer) {
+    for (auto it = framebuffers.begin(); it != framebuffers.end();) {
+        const std::vector<uint64_t> &framebufferKey = it->first;
+        if (std::find(framebufferKey.begin(), framebufferKey.end(), (uint64_t)imageView) != framebufferKey.end()) {
+            if (boundFramebuffer == it->second) {
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                boundFramebuffer = 0;
+            }
+            glDeleteFramebuffers(1, &it->second);
+            it = framebuffers.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+GLuint GLObjectCache::GetVertexArray(const GraphicsAPI::VertexInputState &vertexInputState) {
+    std::vector<uint64_t> vertexArrayKey;
+    vertexArrayKey.push_back(vertexInputState.attributes.size());
+    for (const GraphicsAPI::VertexInputAttribute &attribute : vertexInputState.attributes) {
+        vertexArrayKey.push_back(attribute.attribIndex);
+        vertexArrayKey.push_back(attribute.bindingIndex);
+        vertexArrayKey.push_back((uint64_t)attribute.vertexType);
+        vertexArrayKey.push_back(attribute.offset);
+    }
+    for (const GraphicsAPI::VertexInputBinding &binding : vertexInputState.bindings) {
+        vertexArrayKey.push_back(binding.bindingIndex);
+        vertexArrayKey.push_back(binding.offset);
+        vertexArrayKey.push_back(binding.stride);
+    }
+
+    GLuint &vertexArray = vertexArrays[vertexArrayKey];
+    if (!vertexArray) {
+        glGenVertexArrays(1, &vertexArray);
+    }
+    return vertexArray;
+}
+#endif
@@ -0,0 +1,68 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+#if defined(XR_USE_GRAPHICS_API_OPENGL) || defined(XR_USE_GRAPHICS_API_OPENGL_ES)
+// Shared by GraphicsAPI_OpenGL and GraphicsAPI_OpenGL_ES. Every function is called with the backend's context current.
+
+// Linked program binaries, keyed by the shaders that the program was linked from. Persisted by LoadFile() and SaveFile().
+class GLProgramBinaryCache {
+public:
+    // OpenGL loads glProgramBinary() and glGetProgramBinary() by name, and OpenGL ES links to them, so they are passed in.
+    // supported is whether the context has them: OpenGL 4.1, GL_ARB_get_program_binary or OpenGL ES 3.0. Binaries are
+    // only used if the driver also has at least one binary format.
+    void Init(bool supported, PFNGLPROGRAMBINARYPROC programBinary, PFNGLGETPROGRAMBINARYPROC getProgramBinary);
+    bool IsSupported() const { return supported; }
+
+    // Records the hash of a compiled shader's type and source.
+    void AddShader(GLuint shader, GLenum type, const char* sourceData, size_t sourceSize);
+    void RemoveShader(GLuint shader);
+    // A program is keyed by the hashes of the shaders that it's linked from.
+    uint64_t GetProgramKey(const std::vector<void*>& shaders);
+
+    // Restores program from a binary saved by an earlier link of the same shaders. Returns false if there is none or the driver rejects it.
+    bool Load(GLuint program, uint64_t programKey);
+    // Saves the binary of a linked program.
+    void Store(GLuint program, uint64_t programKey);
+
+    void LoadFile(const std::string& filepath);
+    void SaveFile(const std::string& filepath);
+
+private:
+    bool supported = false;
+    PFNGLPROGRAMBINARYPROC programBinaryProc = nullptr;
+    PFNGLGETPROGRAMBINARYPROC getProgramBinaryProc = nullptr;
+
+    // Hash of each shader's type and source.
+    std::unordered_map<GLuint, uint64_t> shaderHashes{};
+    // Linked program binaries and their formats, keyed by program.
+    std::unordered_map<uint64_t, std::pair<GLenum, std::vector<char>>> programBinaries{};
+};
+
+// Framebuffers keyed by their attachments' image views, and vertex arrays keyed by vertex input layout.
+// Both are kept for the lifetime of the device rather than recreated every frame.
+class GLObjectCache {
+public:
+    // Deletes every cached framebuffer and vertex array. Called from the backend's destructor.
+    void Destroy();
+
+    // Returns the framebuffer for these attachments, creating it on first use. created is set for a new framebuffer, whose
+    // attachments the caller then sets up.
+    GLuint GetFramebuffer(void** colorViews, size_t colorViewCount, void* depthStencilView, bool& created);
+    // Deletes any cached framebuffers that have imageView as an attachment. If boundFramebuffer is one of them, it's unbound
+    // and set to 0.
+    void EvictFramebuffers(GLuint imageView, GLuint& boundFramebuffer);
+
+    // Returns the vertex array for this vertex input layout, creating it on first use.
+    GLuint GetVertexArray(const GraphicsAPI::VertexInputState& vertexInputState);
+
+private:
+    std::unordered_map<std::vector<uint64_t>, GLuint, KeyHash> framebuffers{};
+    std::unordered_map<std::vector<uint64_t>, GLuint, KeyHash> vertexArrays{};
+};
+#endif
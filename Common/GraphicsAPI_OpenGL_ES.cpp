@@ -408,6 +408,9 @@ GraphicsAPI_OpenGL_ES::GraphicsAPI_OpenGL_ES(XrInstance m_xrInstance, XrSystemId
         std::cerr << "ERROR: OPENGL ES: The created OpenGL ES version " << glMajorVersion << "." << glMinorVersion << " doesn't meet the minimum required API version " << requiredMajorVersion << "." << requiredMinorVersion << " for OpenXR." << std::endl;
     }
 
+    // Program binaries are core in OpenGL ES 3.0.
+    programBinaryCache.Init(glMajorVersion >= 3, glProgramBinary, glGetProgramBinary);
+
     glEnable(GL_DEBUG_OUTPUT);
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
     glDebugMessageCallback(GLDebugCallback, nullptr);
@@ -416,6 +419,13 @@ GraphicsAPI_OpenGL_ES::GraphicsAPI_OpenGL_ES(XrInstance m_xrInstance, XrSystemId
 }
 
 GraphicsAPI_OpenGL_ES::~GraphicsAPI_OpenGL_ES() {
+    DestroyTransientUniforms();
+
+    objectCache.Destroy();
+    if (!timestampQueries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(timestampQueries.size()), timestampQueries.data());
+    }
+
     ksGpuWindow_Destroy(&window);
 }
 // XR_DOCS_TAG_END_GraphicsAPI_OpenGL_ES
@@ -515,6 +525,7 @@ void *GraphicsAPI_OpenGL_ES::CreateImageView(const ImageViewCreateInfo &imageVie
 
 void GraphicsAPI_OpenGL_ES::DestroyImageView(void *&imageView) {
     GLuint framebuffer = (GLuint)(uint64_t)imageView;
+    objectCache.EvictFramebuffers(framebuffer, setFramebuffer);
     imageViews.erase(framebuffer);
     glDeleteFramebuffers(1, &framebuffer);
     imageView = nullptr;
@@ -574,14 +585,18 @@ void *GraphicsAPI_OpenGL_ES::CreateBuffer(const BufferCreateInfo &bufferCI) {
     }
 
     glBindBuffer(target, buffer);
-    glBufferData(target, (GLsizeiptr)bufferCI.size, bufferCI.data, GL_STATIC_DRAW);
+    glBufferData(target, (GLsizeiptr)bufferCI.size, bufferCI.data, bufferCI.streaming ? GL_STREAM_DRAW : GL_STATIC_DRAW);
     glBindBuffer(target, 0);
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        InvalidateBoundBuffers();
+    }
 
     buffers[buffer] = bufferCI;
     return (void *)(uint64_t)buffer;
 }
 
 void GraphicsAPI_OpenGL_ES::DestroyBuffer(void *&buffer) {
+    InvalidateBoundState();
     GLuint glBuffer = (GLuint)(uint64_t)buffer;
     buffers.erase(glBuffer);
     glDeleteBuffers(1, &glBuffer);
@@ -620,7 +635,9 @@ void *GraphicsAPI_OpenGL_ES::CreateShader(const ShaderCreateInfo &shaderCI) {
     }
     GLuint shader = glCreateShader(type);
 
-    glShaderSource(shader, 1, &shaderCI.sourceData, nullptr);
+    // The source may be a FileView, which is not null-terminated.
+    const GLint sourceLength = static_cast<GLint>(shaderCI.sourceSize);
+    glShaderSource(shader, 1, &shaderCI.sourceData, &sourceLength);
     glCompileShader(shader);
 
     GLint isCompiled = 0;
@@ -636,12 +653,15 @@ void *GraphicsAPI_OpenGL_ES::CreateShader(const ShaderCreateInfo &shaderCI) {
 
         glDeleteShader(shader);
         shader = 0;
+    } else {
+        programBinaryCache.AddShader(shader, type, shaderCI.sourceData, shaderCI.sourceSize);
     }
     return (void *)(uint64_t)shader;
 }
 
 void GraphicsAPI_OpenGL_ES::DestroyShader(void *&shader) {
     GLuint glShader = (GLuint)(uint64_t)shader;
+    programBinaryCache.RemoveShader(glShader);
     glDeleteShader(glShader);
     shader = nullptr;
 }
@@ -649,9 +669,19 @@ void GraphicsAPI_OpenGL_ES::DestroyShader(void *&shader) {
 void *GraphicsAPI_OpenGL_ES::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
     GLuint program = glCreateProgram();
 
+    // A program linked from the same shaders, in this or an earlier run, may have left a binary that can be loaded instead of linking.
+    const uint64_t programKey = programBinaryCache.GetProgramKey(pipelineCI.shaders);
+    if (programBinaryCache.Load(program, programKey)) {
+        pipelines[program] = pipelineCI;
+        return (void *)(uint64_t)program;
+    }
+
     for (const void *const &shader : pipelineCI.shaders)
         glAttachShader(program, (GLuint)(uint64_t)shader);
 
+    if (programBinaryCache.IsSupported()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(program);
     glValidateProgram(program);
 
@@ -665,6 +695,8 @@ void *GraphicsAPI_OpenGL_ES::CreatePipeline(const PipelineCreateInfo &pipelineCI
         glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
 
         glDeleteProgram(program);
+    } else {
+        programBinaryCache.Store(program, programKey);
     }
 
     for (const void *const &shader : pipelineCI.shaders)
@@ -676,30 +708,130 @@ void *GraphicsAPI_OpenGL_ES::CreatePipeline(const PipelineCreateInfo &pipelineCI
 }
 
 void GraphicsAPI_OpenGL_ES::DestroyPipeline(void *&pipeline) {
+    InvalidateBoundState();
     GLint program = (GLuint)(uint64_t)pipeline;
     pipelines.erase(program);
     glDeleteProgram(program);
     pipeline = nullptr;
 }
 
+void GraphicsAPI_OpenGL_ES::LoadPipelineCache(const std::string &filepath) {
+    programBinaryCache.LoadFile(filepath);
+}
+
+void GraphicsAPI_OpenGL_ES::SavePipelineCache(const std::string &filepath) {
+    programBinaryCache.SaveFile(filepath);
+}
+
 void GraphicsAPI_OpenGL_ES::BeginRendering() {
-    glGenVertexArrays(1, &vertexArray);
-    glBindVertexArray(vertexArray);
+    // SetTransientUniformData() orphans each page on its first write, so a single set of pages is enough.
+    BeginTransientUniforms(0);
+    InvalidateBoundState();
+}
 
-    glGenFramebuffers(1, &setFramebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+size_t GraphicsAPI_OpenGL_ES::GetUniformBufferOffsetAlignment() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return static_cast<size_t>(alignment);
 }
 
 void GraphicsAPI_OpenGL_ES::EndRendering() {
+    // The cached framebuffer and vertex array stay alive, but are unbound so that nothing outside of rendering modifies them.
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDeleteFramebuffers(1, &setFramebuffer);
     setFramebuffer = 0;
 
     glBindVertexArray(0);
-    glDeleteVertexArrays(1, &vertexArray);
     vertexArray = 0;
 }
 
+// OpenGL ES only has timestamps through GL_EXT_disjoint_timer_query. Its functions are loaded by name, so declare their types here
+// rather than depend on which extension headers are included.
+#if !defined(GL_TIMESTAMP_EXT)
+#define GL_TIMESTAMP_EXT 0x8E28
+#endif
+#if !defined(GL_GPU_DISJOINT_EXT)
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+typedef void(GL_APIENTRY *PFN_glQueryCounterEXT)(GLuint id, GLenum target);
+typedef void(GL_APIENTRY *PFN_glGetQueryObjectui64vEXT)(GLuint id, GLenum pname, GLuint64 *params);
+
+bool GraphicsAPI_OpenGL_ES::TimestampsSupported() {
+    if (timestampsSupported < 0) {
+        timestampsSupported = 0;
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; i++) {
+            const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+            if (extension && strcmp(extension, "GL_EXT_disjoint_timer_query") == 0) {
+                timestampsSupported = 1;
+                break;
+            }
+        }
+    }
+    return timestampsSupported == 1;
+}
+
+bool GraphicsAPI_OpenGL_ES::WriteTimestamp(uint64_t &timestamp) {
+    if (!TimestampsSupported()) {
+        return false;
+    }
+    PFN_glQueryCounterEXT glQueryCounterEXT = (PFN_glQueryCounterEXT)GetExtension("glQueryCounterEXT");
+    if (!glQueryCounterEXT) {
+        return false;
+    }
+    GLuint query = 0;
+    if (freeTimestampQueries.empty()) {
+        glGenQueries(1, &query);
+        timestampQueries.push_back(query);
+    } else {
+        query = freeTimestampQueries.back();
+        freeTimestampQueries.pop_back();
+    }
+    glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+    timestamp = query;
+    return true;
+}
+
+bool GraphicsAPI_OpenGL_ES::ReadTimestamp(uint64_t timestamp, uint64_t &nanoseconds) {
+    PFN_glGetQueryObjectui64vEXT glGetQueryObjectui64vEXT = (PFN_glGetQueryObjectui64vEXT)GetExtension("glGetQueryObjectui64vEXT");
+    const GLuint query = (GLuint)timestamp;
+    GLuint available = 0;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+    GLuint64 result = 0;
+    glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT, &result);
+    nanoseconds = result;
+    return true;
+}
+
+void GraphicsAPI_OpenGL_ES::ReleaseTimestamp(uint64_t timestamp) {
+    freeTimestampQueries.push_back((GLuint)timestamp);
+}
+
+bool GraphicsAPI_OpenGL_ES::TimestampsDisjoint() {
+    if (!TimestampsSupported()) {
+        return false;
+    }
+    // Reading GL_GPU_DISJOINT_EXT also clears it.
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    return disjoint != 0;
+}
+
+void GraphicsAPI_OpenGL_ES::SetTransientUniformData(void *buffer, size_t offset, size_t size, const void *data, bool discard) {
+    // OpenGL ES 3.x has no core glBufferStorage() for persistent mappings, so orphan the page on its first write instead.
+    // The driver can then hand out new memory rather than wait for draws that still read the old contents.
+    GLuint glBuffer = (GLuint)(uint64_t)buffer;
+    glBindBuffer(GL_UNIFORM_BUFFER, glBuffer);
+    if (discard) {
+        glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)buffers[glBuffer].size, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
 void GraphicsAPI_OpenGL_ES::ClearColor(void *imageView, float r, float g, float b, float a) {
     glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)(uint64_t)imageView);
     glClearColor(r, g, b, a);
@@ -732,19 +864,27 @@ void GraphicsAPI_OpenGL_ES::SetBufferData(void *buffer, size_t offset, size_t si
 
     if (data) {
         glBindBuffer(target, glBuffer);
+        // Orphan a streaming buffer that is rewritten whole, so that the driver can hand out new memory instead of waiting
+        // for draws that still read the old contents. A partial write has to keep the rest.
+        if (bufferCI.streaming && offset == 0 && size >= bufferCI.size) {
+            glBufferData(target, (GLsizeiptr)bufferCI.size, nullptr, GL_STREAM_DRAW);
+        }
         glBufferSubData(target, (GLintptr)offset, (GLsizeiptr)size, data);
         glBindBuffer(target, 0);
+        if (target == GL_ELEMENT_ARRAY_BUFFER) {
+            // The index buffer binding is part of the bound vertex array, so this unbound the one set by SetIndexBuffer().
+            InvalidateBoundBuffers();
+        }
     }
 }
 
 void GraphicsAPI_OpenGL_ES::SetRenderAttachments(void **colorViews, size_t colorViewCount, void *depthStencilView, uint32_t width, uint32_t height, void *pipeline) {
-    // Reset Framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDeleteFramebuffers(1, &setFramebuffer);
-    setFramebuffer = 0;
-
-    glGenFramebuffers(1, &setFramebuffer);
+    bool created = false;
+    setFramebuffer = objectCache.GetFramebuffer(colorViews, colorViewCount, depthStencilView, created);
     glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+    if (!created) {
+        return;
+    }
 
     // Color
     for (size_t i = 0; i < colorViewCount; i++) {
@@ -796,12 +936,25 @@ void GraphicsAPI_OpenGL_ES::SetScissors(Rect2D *scissors, size_t count) {
 }
 
 void GraphicsAPI_OpenGL_ES::SetPipeline(void *pipeline) {
+    if (!FilterSetPipeline(pipeline)) {
+        return;
+    }
+
     GLuint program = (GLuint)(uint64_t)pipeline;
     glUseProgram(program);
     setPipeline = program;
 
     const PipelineCreateInfo &pipelineCI = pipelines[program];
 
+    // Pipelines with the same vertex input layout share a vertex array.
+    GLuint pipelineVertexArray = objectCache.GetVertexArray(pipelineCI.vertexInputState);
+    if (pipelineVertexArray != vertexArray) {
+        vertexArray = pipelineVertexArray;
+        glBindVertexArray(vertexArray);
+        // The vertex and index buffer bindings belong to the vertex array, so the other one's bindings don't apply.
+        InvalidateBoundBuffers();
+    }
+
     // InputAssemblyState
     const InputAssemblyState &IAS = pipelineCI.inputAssemblyState;
     if (IAS.primitiveRestartEnable) {
@@ -1003,6 +1156,10 @@ void GraphicsAPI_OpenGL_ES::UpdateDescriptors() {
 }
 
 void GraphicsAPI_OpenGL_ES::SetVertexBuffers(void **vertexBuffers, size_t count) {
+    if (!FilterSetVertexBuffers(vertexBuffers, count)) {
+        return;
+    }
+
     const VertexInputState &vertexInputState = pipelines[setPipeline].vertexInputState;
     for (size_t i = 0; i < count; i++) {
         GLuint glVertexBufferID = (GLuint)(uint64_t)vertexBuffers[i];
@@ -1021,10 +1178,16 @@ void GraphicsAPI_OpenGL_ES::SetVertexBuffers(void **vertexBuffers, size_t count)
                         GLint size = ((GLint)vertexAttribute.vertexType % 4) + 1;
                         GLenum type = (GLenum)vertexAttribute.vertexType >= (GLenum)VertexType::UINT ? GL_UNSIGNED_INT : (GLenum)vertexAttribute.vertexType >= (GLenum)VertexType::INT ? GL_INT
                                                                                                                                                                                        : GL_FLOAT;
+                        GLboolean normalized = GL_FALSE;
+                        if (vertexAttribute.vertexType == VertexType::VEC4_SNORM16 || vertexAttribute.vertexType == VertexType::VEC4_SNORM8) {
+                            size = 4;
+                            type = vertexAttribute.vertexType == VertexType::VEC4_SNORM16 ? GL_SHORT : GL_BYTE;
+                            normalized = GL_TRUE;
+                        }
                         GLsizei stride = vertexBinding.stride;
                         const void *offset = (const void *)vertexAttribute.offset;
                         glEnableVertexAttribArray(attribIndex);
-                        glVertexAttribPointer(attribIndex, size, type, false, stride, offset);
+                        glVertexAttribPointer(attribIndex, size, type, normalized, stride, offset);
                     }
                 }
             }
@@ -1033,6 +1196,10 @@ void GraphicsAPI_OpenGL_ES::SetVertexBuffers(void **vertexBuffers, size_t count)
 }
 
 void GraphicsAPI_OpenGL_ES::SetIndexBuffer(void *indexBuffer) {
+    if (!FilterSetIndexBuffer(indexBuffer)) {
+        return;
+    }
+
     GLuint glIndexBufferID = (GLuint)(uint64_t)indexBuffer;
     if (buffers[glIndexBufferID].type != BufferCreateInfo::Type::INDEX) {
         std::cout << "ERROR: OpenGL: Provided buffer is not type: INDEX." << std::endl;
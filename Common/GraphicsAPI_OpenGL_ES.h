@@ -5,7 +5,7 @@
 // OpenXR Tutorial for Khronos Group
 
 #pragma once
-#include <GraphicsAPI.h>
+#include <GraphicsAPI_OpenGL_Common.h>
 
 #if defined(XR_USE_GRAPHICS_API_OPENGL_ES)
 class GraphicsAPI_OpenGL_ES : public GraphicsAPI {
@@ -53,6 +53,9 @@ public:
     virtual void* CreatePipeline(const PipelineCreateInfo& pipelineCI) override;
     virtual void DestroyPipeline(void*& pipeline) override;
 
+    virtual void LoadPipelineCache(const std::string& filepath) override;
+    virtual void SavePipelineCache(const std::string& filepath) override;
+
     virtual void BeginRendering() override;
     virtual void EndRendering() override;
 
@@ -77,6 +80,16 @@ private:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() override;
     virtual const std::vector<int64_t> GetSupportedDepthSwapchainFormats() override;
 
+    virtual size_t GetUniformBufferOffsetAlignment() override;
+    virtual void SetTransientUniformData(void* buffer, size_t offset, size_t size, const void* data, bool discard) override;
+
+    virtual bool WriteTimestamp(uint64_t& timestamp) override;
+    virtual bool ReadTimestamp(uint64_t timestamp, uint64_t& nanoseconds) override;
+    virtual void ReleaseTimestamp(uint64_t timestamp) override;
+    virtual bool TimestampsDisjoint() override;
+    bool TimestampsSupported();
+
+
 private:
     ksGpuWindow window{};
 
@@ -91,8 +104,16 @@ private:
 
     GLuint setFramebuffer = 0;
     std::unordered_map<GLuint, PipelineCreateInfo> pipelines{};
+    // Persisted by LoadPipelineCache() and SavePipelineCache().
+    GLProgramBinaryCache programBinaryCache{};
     GLuint setPipeline = 0;
     GLuint vertexArray = 0;
+    GLObjectCache objectCache{};
     GLuint setIndexBuffer = 0;
+
+    // Every GL_TIMESTAMP query created by WriteTimestamp(), and those whose results have been read and can be reused.
+    std::vector<GLuint> timestampQueries{};
+    std::vector<GLuint> freeTimestampQueries{};
+    int timestampsSupported = -1;  // Whether GL_EXT_disjoint_timer_query is available, checked on first use.
 };
 #endif
\ No newline at end of file
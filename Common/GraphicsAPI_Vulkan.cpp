@@ -8,6 +8,7 @@
 #define VK_USE_PLATFORM_WIN32_KHR
 #endif
 #include <GraphicsAPI_Vulkan.h>
+#include <FileView.h>
 
 #if defined(XR_USE_GRAPHICS_API_VULKAN)
 
@@ -40,6 +41,10 @@ static bool MemoryTypeFromProperties(VkPhysicalDeviceMemoryProperties memoryProp
     return false;
 };
 
+static bool HasExtension(const std::vector<const char *> &extensions, const char *name) {
+    return std::find_if(extensions.begin(), extensions.end(), [name](const char *extension) { return strcmp(extension, name) == 0; }) != extensions.end();
+}
+
 static VkFormat ToVkFormat(GraphicsAPI::VertexType type) {
     switch (type) {
     case GraphicsAPI::VertexType::FLOAT:
@@ -66,6 +71,10 @@ static VkFormat ToVkFormat(GraphicsAPI::VertexType type) {
         return VK_FORMAT_R32G32B32_UINT;
     case GraphicsAPI::VertexType::UVEC4:
         return VK_FORMAT_R32G32B32A32_UINT;
+    case GraphicsAPI::VertexType::VEC4_SNORM16:
+        return VK_FORMAT_R16G16B16A16_SNORM;
+    case GraphicsAPI::VertexType::VEC4_SNORM8:
+        return VK_FORMAT_R8G8B8A8_SNORM;
     default:
         return VK_FORMAT_UNDEFINED;
     }
@@ -90,6 +99,8 @@ VkDescriptorType ToVkDescrtiptorType(const GraphicsAPI::DescriptorInfo &descInfo
     return vkType;
 }
 
+thread_local GraphicsAPI_Vulkan::Recording *GraphicsAPI_Vulkan::threadCommandList = nullptr;
+
 GraphicsAPI_Vulkan::GraphicsAPI_Vulkan() {
     // Instance
     VkApplicationInfo ai;
@@ -207,49 +218,15 @@ GraphicsAPI_Vulkan::GraphicsAPI_Vulkan() {
     deviceCI.pEnabledFeatures = &features;
     VULKAN_CHECK(vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device), "Failed to create Device.");
 
-    VkCommandPoolCreateInfo cmdPoolCI;
-    cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    cmdPoolCI.pNext = nullptr;
-    cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    cmdPoolCI.queueFamilyIndex = queueFamilyIndex;
-    VULKAN_CHECK(vkCreateCommandPool(device, &cmdPoolCI, nullptr, &cmdPool), "Failed to create CommandPool.");
-
-    VkCommandBufferAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.commandPool = cmdPool;
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfo.commandBufferCount = 1;
-    VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocateInfo, &cmdBuffer), "Failed to allocate CommandBuffers.");
-
     vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, &queue);
+    CreateUploadResources(queueFamilyProperties, false);
 
-    VkFenceCreateInfo fenceCI{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-    fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCI.pNext = nullptr;
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    VULKAN_CHECK(vkCreateFence(device, &fenceCI, nullptr, &fence), "Failed to create Fence.")
-    
-    uint32_t maxSets = 1024;
-    std::vector<VkDescriptorPoolSize> poolSizes{
-        {VK_DESCRIPTOR_TYPE_SAMPLER, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16 * maxSets}};
-
-    VkDescriptorPoolCreateInfo descPoolCI;
-    descPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descPoolCI.pNext = nullptr;
-    descPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descPoolCI.maxSets = maxSets;
-    descPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    descPoolCI.pPoolSizes = poolSizes.data();
-    VULKAN_CHECK(vkCreateDescriptorPool(device, &descPoolCI, nullptr, &descriptorPool), "Failed to create DescriptorPool");
+    CreateFrames(defaultFramesInFlight);
+    CreatePipelineCache({});
 }
 
 // XR_DOCS_TAG_BEGIN_GraphicsAPI_Vulkan
-GraphicsAPI_Vulkan::GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId systemId) {
+GraphicsAPI_Vulkan::GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId systemId, uint32_t framesInFlight) {
     // Instance
     LoadPFN_XrFunctions(m_xrInstance);
 
@@ -281,6 +258,17 @@ GraphicsAPI_Vulkan::GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId syste
             break;
         }
     }
+    // VK_KHR_multiview depends on VK_KHR_get_physical_device_properties2 on Vulkan 1.0.
+    bool physicalDeviceProperties2Enabled = false;
+    for (const VkExtensionProperties &extensionProperty : instanceExtensionProperties) {
+        if (strcmp(extensionProperty.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0) {
+            if (!HasExtension(activeInstanceExtensions, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+                activeInstanceExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            }
+            physicalDeviceProperties2Enabled = true;
+            break;
+        }
+    }
 
     VkInstanceCreateInfo instanceCI;
     instanceCI.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -356,12 +344,41 @@ GraphicsAPI_Vulkan::GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId syste
         }
     }
 
+    // Multiview draws every view in one render pass. Devices with the extension must support its multiview feature.
+    VkPhysicalDeviceMultiviewFeaturesKHR multiviewFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES_KHR};
+    for (const VkExtensionProperties &extensionProperty : deviceExtensionProperties) {
+        if (physicalDeviceProperties2Enabled && strcmp(extensionProperty.extensionName, VK_KHR_MULTIVIEW_EXTENSION_NAME) == 0) {
+            if (!HasExtension(activeDeviceExtensions, VK_KHR_MULTIVIEW_EXTENSION_NAME)) {
+                activeDeviceExtensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+            }
+            multiviewFeatures.multiview = VK_TRUE;
+            multiviewSupported = true;
+            break;
+        }
+    }
+    // Timeline semaphores let frames wait on the GPU for uploads made on another queue. Devices with the extension must
+    // support its timelineSemaphore feature.
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR};
+    bool timelineSemaphoreEnabled = false;
+    for (const VkExtensionProperties &extensionProperty : deviceExtensionProperties) {
+        if (physicalDeviceProperties2Enabled && strcmp(extensionProperty.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0) {
+            if (!HasExtension(activeDeviceExtensions, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+                activeDeviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+            }
+            timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+            timelineSemaphoreEnabled = true;
+            break;
+        }
+    }
+    timelineSemaphoreFeatures.pNext = nullptr;
+    multiviewFeatures.pNext = timelineSemaphoreEnabled ? &timelineSemaphoreFeatures : nullptr;
+
     VkPhysicalDeviceFeatures features;
     vkGetPhysicalDeviceFeatures(physicalDevice, &features);
 
     VkDeviceCreateInfo deviceCI;
     deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    deviceCI.pNext = nullptr;
+    deviceCI.pNext = multiviewSupported ? (void *)&multiviewFeatures : timelineSemaphoreEnabled ? (void *)&timelineSemaphoreFeatures : nullptr;
     deviceCI.flags = 0;
     deviceCI.queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCIs.size());
     deviceCI.pQueueCreateInfos = deviceQueueCIs.data();
@@ -372,54 +389,56 @@ GraphicsAPI_Vulkan::GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId syste
     deviceCI.pEnabledFeatures = &features;
     VULKAN_CHECK(vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device), "Failed to create Device.");
 
-    VkCommandPoolCreateInfo cmdPoolCI;
-    cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    cmdPoolCI.pNext = nullptr;
-    cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    cmdPoolCI.queueFamilyIndex = queueFamilyIndex;
-    VULKAN_CHECK(vkCreateCommandPool(device, &cmdPoolCI, nullptr, &cmdPool), "Failed to create CommandPool.");
+    vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, &queue);
+    CreateUploadResources(queueFamilyProperties, timelineSemaphoreEnabled);
 
-    VkCommandBufferAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.commandPool = cmdPool;
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfo.commandBufferCount = 1;
-    VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocateInfo, &cmdBuffer), "Failed to allocate CommandBuffers.");
+    CreateFrames(framesInFlight);
+    CreatePipelineCache({});
+}
 
-    vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, &queue);
+GraphicsAPI_Vulkan::~GraphicsAPI_Vulkan() {
+    WaitForSubmission(submissionCount);
+    WaitForUploads(uploadCount);
+    DestroyTransientUniforms();
 
-    VkFenceCreateInfo fenceCI{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-    fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCI.pNext = nullptr;
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    VULKAN_CHECK(vkCreateFence(device, &fenceCI, nullptr, &fence), "Failed to create Fence.")
+    for (const auto &cachedFramebuffer : framebufferLRU) {
+        vkDestroyFramebuffer(device, cachedFramebuffer.second, nullptr);
+    }
+    for (const auto &framebufferToDestroy : framebuffersToDestroy) {
+        vkDestroyFramebuffer(device, framebufferToDestroy.second, nullptr);
+    }
 
-    uint32_t maxSets = 1024;
-    std::vector<VkDescriptorPoolSize> poolSizes{
-        {VK_DESCRIPTOR_TYPE_SAMPLER, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 * maxSets},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16 * maxSets}};
+    for (Frame &frame : frames) {
+        vkDestroyFence(device, frame.fence, nullptr);
 
-    VkDescriptorPoolCreateInfo descPoolCI;
-    descPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descPoolCI.pNext = nullptr;
-    descPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descPoolCI.maxSets = maxSets;
-    descPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    descPoolCI.pPoolSizes = poolSizes.data();
-    VULKAN_CHECK(vkCreateDescriptorPool(device, &descPoolCI, nullptr, &descriptorPool), "Failed to create DescriptorPool");
-}
+        DestroyRecording(frame.primary);
+        for (Recording &commandList : frame.commandLists) {
+            DestroyRecording(commandList);
+        }
+    }
 
-GraphicsAPI_Vulkan::~GraphicsAPI_Vulkan() {
-    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    DestroyUploadBatch(currentUpload);
+    for (UploadBatch &batch : freeUploads) {
+        DestroyUploadBatch(batch);
+    }
+    if (stagingBuffer) {
+        vkDestroyBuffer(device, stagingBuffer, nullptr);
+    }
+    if (uploadSemaphore) {
+        vkDestroySemaphore(device, uploadSemaphore, nullptr);
+    }
 
-    vkDestroyFence(device, fence, nullptr);
+    for (MemoryBlock &block : memoryBlocks) {
+        if (block.mappedData) {
+            vkUnmapMemory(device, block.memory);
+        }
+        vkFreeMemory(device, block.memory, nullptr);
+    }
 
-    vkFreeCommandBuffers(device, cmdPool, 1, &cmdBuffer);
-    vkDestroyCommandPool(device, cmdPool, nullptr);
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    if (timestampQueryPool) {
+        vkDestroyQueryPool(device, timestampQueryPool, nullptr);
+    }
 
     vkDestroyDevice(device, nullptr);
     vkDestroyInstance(instance, nullptr);
@@ -662,6 +681,8 @@ void GraphicsAPI_Vulkan::DestroyImageView(void *&imageView) {
     VkImageView vkImageView = (VkImageView)imageView;
     vkDestroyImageView(device, vkImageView, nullptr);
     imageViewResources.erase(vkImageView);
+    EvictFramebuffers(VK_NULL_HANDLE, vkImageView);
+    ClearDescriptorSetCaches();  // Cached descriptor sets may refer to this handle.
     imageView = nullptr;
 }
 
@@ -695,6 +716,7 @@ void *GraphicsAPI_Vulkan::CreateSampler(const SamplerCreateInfo &samplerCI) {
 }
 
 void GraphicsAPI_Vulkan::DestroySampler(void *&sampler) {
+    ClearDescriptorSetCaches();  // Cached descriptor sets may refer to this handle.
     vkDestroySampler(device, (VkSampler)sampler, nullptr);
     sampler = nullptr;
 }
@@ -707,39 +729,66 @@ void *GraphicsAPI_Vulkan::CreateBuffer(const BufferCreateInfo &bufferCI) {
     vkBufferCI.flags = 0;
     vkBufferCI.size = static_cast<VkDeviceSize>(bufferCI.size);
     vkBufferCI.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | (bufferCI.type == BufferCreateInfo::Type::VERTEX ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : 0) | (bufferCI.type == BufferCreateInfo::Type::INDEX ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT : 0) | (bufferCI.type == BufferCreateInfo::Type::UNIFORM ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT : 0);
-    vkBufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    vkBufferCI.queueFamilyIndexCount = 0;
-    vkBufferCI.pQueueFamilyIndices = nullptr;
+    // Static buffers are read by the graphics queue and, with a transfer-only queue, written by the upload queue.
+    const bool staticBuffer = bufferCI.data && !bufferCI.streaming;
+    const uint32_t queueFamilyIndices[2] = {queueFamilyIndex, uploadQueueFamilyIndex};
+    const bool concurrent = staticBuffer && uploadQueueFamilyIndex != queueFamilyIndex;
+    vkBufferCI.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    vkBufferCI.queueFamilyIndexCount = concurrent ? 2 : 0;
+    vkBufferCI.pQueueFamilyIndices = concurrent ? queueFamilyIndices : nullptr;
     vkCreateBuffer(device, &vkBufferCI, nullptr, &buffer);
 
     VkMemoryRequirements memoryRequirements{};
     vkGetBufferMemoryRequirements(device, buffer, &memoryRequirements);
 
-    VkDeviceMemory memory{};
-    VkMemoryAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.allocationSize = memoryRequirements.size;
-
-    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
-    MemoryTypeFromProperties(physicalDeviceMemoryProperties, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &allocateInfo.memoryTypeIndex);
+    MemoryAllocation allocation = AllocateMemory(memoryRequirements, staticBuffer ? staticBufferMemoryProperties : VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VULKAN_CHECK(vkBindBufferMemory(device, buffer, allocation.block->memory, allocation.offset), "Failed to bind Memory to Buffer.");
 
-    VULKAN_CHECK(vkAllocateMemory(device, &allocateInfo, nullptr, &memory), "Failed to allocate Memory.");
-    VULKAN_CHECK(vkBindBufferMemory(device, buffer, memory, 0), "Failed to bind Memory to Buffer.");
-
-    bufferResources[buffer] = {memory, bufferCI};
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        bufferResources[buffer] = {allocation, bufferCI};
+    }
     SetBufferData((void *)buffer, 0, bufferCI.size, bufferCI.data);
 
     return (void *)buffer;
 }
 
 void GraphicsAPI_Vulkan::DestroyBuffer(void *&buffer) {
+    InvalidateBoundState();
     VkBuffer vkBuffer = (VkBuffer)buffer;
-    VkDeviceMemory memory = bufferResources[vkBuffer].first;
-    vkFreeMemory(device, memory, nullptr);
+    // Destroy the copies made by SetBufferData() first. Each waits for the frames that read it.
+    std::vector<VkBuffer> copies;
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        auto copiesIt = bufferCopies.find(vkBuffer);
+        if (copiesIt != bufferCopies.end()) {
+            copies = copiesIt->second.copies;
+            bufferCopies.erase(copiesIt);
+        }
+    }
+    for (size_t i = 1; i < copies.size(); i++) {
+        void *copy = (void *)copies[i];
+        DestroyBuffer(copy);
+    }
+    // Don't free the memory while a submitted frame may still be reading from it.
+    auto it = bufferSubmissionIndices.find(vkBuffer);
+    if (it != bufferSubmissionIndices.end()) {
+        WaitForSubmission(std::min(it->second, submissionCount));
+        bufferSubmissionIndices.erase(it);
+    }
+    // Nor while an upload may still be copying into it.
+    auto uploadIt = bufferUploadIndices.find(vkBuffer);
+    if (uploadIt != bufferUploadIndices.end()) {
+        WaitForUploads(uploadIt->second);
+        bufferUploadIndices.erase(uploadIt);
+    }
     vkDestroyBuffer(device, vkBuffer, nullptr);
-    bufferResources.erase(vkBuffer);
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        FreeMemory(bufferResources[vkBuffer].first);
+        bufferResources.erase(vkBuffer);
+    }
+    ClearDescriptorSetCaches();  // Cached descriptor sets may refer to this handle.
     buffer = nullptr;
 }
 
@@ -764,6 +813,19 @@ void GraphicsAPI_Vulkan::DestroyShader(void *&shader) {
 }
 
 void *GraphicsAPI_Vulkan::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
+    return AddPipeline(BuildPipeline(pipelineCI, GetShaderStages(pipelineCI)), pipelineCI);
+}
+
+std::vector<VkShaderStageFlagBits> GraphicsAPI_Vulkan::GetShaderStages(const PipelineCreateInfo &pipelineCI) {
+    std::vector<VkShaderStageFlagBits> shaderStages;
+    shaderStages.reserve(pipelineCI.shaders.size());
+    for (void *shader : pipelineCI.shaders) {
+        shaderStages.push_back(static_cast<VkShaderStageFlagBits>(1 << (uint32_t)shaderResources[(VkShaderModule)shader].type));
+    }
+    return shaderStages;
+}
+
+GraphicsAPI_Vulkan::BuiltPipeline GraphicsAPI_Vulkan::BuildPipeline(const PipelineCreateInfo &pipelineCI, const std::vector<VkShaderStageFlagBits> &shaderStages) {
     // RenderPass
     std::vector<VkAttachmentDescription> attachmentDescriptions{};
     std::vector<VkAttachmentReference> colorAttachmentReferences{};
@@ -832,6 +894,21 @@ void *GraphicsAPI_Vulkan::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
     renderPassCI.pSubpasses = &subpassDescription;
     renderPassCI.dependencyCount = 1;
     renderPassCI.pDependencies = &subpassDependency;
+    // With a view mask, the subpass is drawn once to each masked layer of the attachments, with gl_ViewIndex set to the layer.
+    VkRenderPassMultiviewCreateInfoKHR renderPassMultiviewCI{VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO_KHR};
+    if (pipelineCI.viewMask) {
+        if (!multiviewSupported) {
+            std::cout << "ERROR: Vulkan: VK_KHR_multiview is not supported, so the pipeline's viewMask is ignored." << std::endl;
+            DEBUG_BREAK;
+        } else {
+            renderPassMultiviewCI.subpassCount = 1;
+            renderPassMultiviewCI.pViewMasks = &pipelineCI.viewMask;
+            // The views are rendered from nearby viewpoints, so the implementation may render them concurrently.
+            renderPassMultiviewCI.correlationMaskCount = 1;
+            renderPassMultiviewCI.pCorrelationMasks = &pipelineCI.viewMask;
+            renderPassCI.pNext = &renderPassMultiviewCI;
+        }
+    }
     VULKAN_CHECK(vkCreateRenderPass(device, &renderPassCI, nullptr, &renderPass), "Failed to create RenderPass.");
 
     // Pipeline Layout and DescriptorSetLayout
@@ -869,13 +946,13 @@ void *GraphicsAPI_Vulkan::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
     // ShaderStages
     std::vector<VkPipelineShaderStageCreateInfo> vkShaderStages;
     vkShaderStages.reserve(pipelineCI.shaders.size());
-    for (auto &shader : pipelineCI.shaders) {
-        VkShaderModule shaderModule = (VkShaderModule)shader;
+    for (size_t i = 0; i < pipelineCI.shaders.size(); i++) {
+        VkShaderModule shaderModule = (VkShaderModule)pipelineCI.shaders[i];
         VkPipelineShaderStageCreateInfo shaderStageCI;
         shaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         shaderStageCI.pNext = nullptr;
         shaderStageCI.flags = 0;
-        shaderStageCI.stage = static_cast<VkShaderStageFlagBits>(1 << (uint32_t)shaderResources[shaderModule].type);
+        shaderStageCI.stage = shaderStages[i];
         shaderStageCI.module = shaderModule;
         shaderStageCI.pName = "main";
         shaderStageCI.pSpecializationInfo = nullptr;
@@ -1047,40 +1124,167 @@ void *GraphicsAPI_Vulkan::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
     GPCI.basePipelineHandle = VK_NULL_HANDLE;
     GPCI.basePipelineIndex = -1;
 
-    VULKAN_CHECK(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &GPCI, nullptr, &pipeline), "Failed to create Graphics Pipeline.");
-    pipelineResources[pipeline] = {pipelineLayout, descSetLayout, renderPass, pipelineCI};
+    VULKAN_CHECK(vkCreateGraphicsPipelines(device, pipelineCache, 1, &GPCI, nullptr, &pipeline), "Failed to create Graphics Pipeline.");
+
+    return {pipeline, pipelineLayout, descSetLayout, renderPass, renderPassCI.pNext != nullptr};
+}
+
+void *GraphicsAPI_Vulkan::AddPipeline(const BuiltPipeline &builtPipeline, const PipelineCreateInfo &pipelineCI) {
+    if (builtPipeline.multiview) {
+        multiviewRenderPasses.insert(builtPipeline.renderPass);
+    }
+    pipelineResources[builtPipeline.pipeline] = {builtPipeline.pipelineLayout, builtPipeline.descSetLayout, builtPipeline.renderPass, pipelineCI};
+    return (void *)builtPipeline.pipeline;
+}
+
+void *GraphicsAPI_Vulkan::StartPipelineBuild(const PipelineCreateInfo &pipelineCI) {
+    // The shader stages are looked up now, as shaderResources may change during the build. BuildPipeline() only creates
+    // Vulkan objects, which is safe on any thread, and vkCreateGraphicsPipelines() synchronizes its use of pipelineCache.
+    PipelineBuild *build = new PipelineBuild{pipelineCI, {}};
+    const std::vector<VkShaderStageFlagBits> shaderStages = GetShaderStages(pipelineCI);
+    build->result = std::async(std::launch::async, [this, build, shaderStages]() { return BuildPipeline(build->pipelineCI, shaderStages); });
+    return build;
+}
+
+bool GraphicsAPI_Vulkan::FinishPipelineBuild(void *build, bool wait, void *&pipeline) {
+    PipelineBuild *pipelineBuild = reinterpret_cast<PipelineBuild *>(build);
+    if (!wait && pipelineBuild->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    const BuiltPipeline builtPipeline = pipelineBuild->result.get();
+    pipeline = builtPipeline.pipeline ? AddPipeline(builtPipeline, pipelineBuild->pipelineCI) : nullptr;
+    delete pipelineBuild;
+    return true;
+}
+
+// Written in front of the VkPipelineCache data. Drivers validate their own header too, but some handle data from
+// another driver version poorly, so it is checked here against the current device before being passed on.
+struct PipelineCacheFileHeader {
+    uint32_t magic;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+static const uint32_t pipelineCacheFileMagic = 0x43505658;  // "XVPC"
+
+static PipelineCacheFileHeader GetPipelineCacheFileHeader(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+    PipelineCacheFileHeader header{};
+    header.magic = pipelineCacheFileMagic;
+    header.vendorID = physicalDeviceProperties.vendorID;
+    header.deviceID = physicalDeviceProperties.deviceID;
+    header.driverVersion = physicalDeviceProperties.driverVersion;
+    memcpy(header.pipelineCacheUUID, physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
+
+void GraphicsAPI_Vulkan::LoadPipelineCache(const std::string &filepath) {
+    FileView fileData(filepath);
+    if (fileData.GetSize() < sizeof(PipelineCacheFileHeader)) {
+        return;
+    }
+
+    PipelineCacheFileHeader header;
+    memcpy(&header, fileData.GetData(), sizeof(header));
+    const PipelineCacheFileHeader expectedHeader = GetPipelineCacheFileHeader(physicalDevice);
+    const char *data = fileData.GetData() + sizeof(header);
+    const size_t dataSize = fileData.GetSize() - sizeof(header);
+    if (header.magic != expectedHeader.magic || header.vendorID != expectedHeader.vendorID || header.deviceID != expectedHeader.deviceID
+        || header.driverVersion != expectedHeader.driverVersion || memcmp(header.pipelineCacheUUID, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        std::cout << "Ignoring pipeline cache " << filepath.c_str() << ". It was written for a different device or driver." << std::endl;
+        return;
+    }
+    if (header.dataSize != dataSize || header.dataHash != HashBytes(data, dataSize)) {
+        std::cout << "Ignoring pipeline cache " << filepath.c_str() << ". The file is corrupt." << std::endl;
+        return;
+    }
+
+    CreatePipelineCache(std::vector<char>(data, data + dataSize));
+}
+
+void GraphicsAPI_Vulkan::SavePipelineCache(const std::string &filepath) {
+    size_t dataSize = 0;
+    VULKAN_CHECK(vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr), "Failed to get PipelineCache data size.");
+
+    PipelineCacheFileHeader header = GetPipelineCacheFileHeader(physicalDevice);
+    std::vector<char> fileData(sizeof(header) + dataSize);
+    char *data = fileData.data() + sizeof(header);
+    VULKAN_CHECK(vkGetPipelineCacheData(device, pipelineCache, &dataSize, data), "Failed to get PipelineCache data.");
+
+    header.dataSize = dataSize;
+    header.dataHash = HashBytes(data, dataSize);
+    memcpy(fileData.data(), &header, sizeof(header));
+    fileData.resize(sizeof(header) + dataSize);
+    WriteBinaryFile(filepath, fileData);
+}
+
+void GraphicsAPI_Vulkan::CreatePipelineCache(const std::vector<char> &initialData) {
+    if (pipelineCache) {
+        vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    }
 
-    return (void *)pipeline;
+    VkPipelineCacheCreateInfo pipelineCacheCI;
+    pipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheCI.pNext = nullptr;
+    pipelineCacheCI.flags = 0;
+    pipelineCacheCI.initialDataSize = initialData.size();
+    pipelineCacheCI.pInitialData = initialData.data();
+    VULKAN_CHECK(vkCreatePipelineCache(device, &pipelineCacheCI, nullptr, &pipelineCache), "Failed to create PipelineCache.");
 }
 
 void GraphicsAPI_Vulkan::DestroyPipeline(void *&pipeline) {
+    InvalidateBoundState();
     VkPipeline vkPipeline = (VkPipeline)pipeline;
     VkPipelineLayout pipelineLayout = std::get<0>(pipelineResources[vkPipeline]);
     VkDescriptorSetLayout descSetLayout = std::get<1>(pipelineResources[vkPipeline]);
     VkRenderPass renderPass = std::get<2>(pipelineResources[vkPipeline]);
+    EvictFramebuffers(renderPass, VK_NULL_HANDLE);
+    multiviewRenderPasses.erase(renderPass);
     vkDestroyRenderPass(device, renderPass, nullptr);
     vkDestroyDescriptorSetLayout(device, descSetLayout, nullptr);
     vkDestroyPipeline(device, vkPipeline, nullptr);
     pipelineResources.erase(vkPipeline);
+    ClearDescriptorSetCaches();  // Cached descriptor sets may refer to this pipeline's set layout.
     pipeline = nullptr;
 }
 
 void GraphicsAPI_Vulkan::BeginRendering() {
-    VULKAN_CHECK(vkWaitForFences(device, 1, &fence, true, UINT64_MAX), "Failed to wait for Fence");
-    VULKAN_CHECK(vkResetFences(device, 1, &fence), "Failed to reset Fence.")
-
-    // VULKAN_CHECK(vkResetDescriptorPool(device, descriptorPool, VkDescriptorPoolResetFlags(0)), "Failed to rest DescriptorPool")
-    for (const auto &descSet : cmdBufferDescriptorSets[cmdBuffer]) {
-        VULKAN_CHECK(vkFreeDescriptorSets(device, descriptorPool, 1, &descSet), "Failed to free DescriptorSet.");
+    // Only wait for the submission made the last time this frame was used. The other frames can still be executing.
+    frameIndex = (frameIndex + 1) % frames.size();
+    Frame &frame = frames[frameIndex];
+    // Wait on the frame's own fence, even if a later fence has already shown that its submission completed, as only a
+    // signalled fence may be reset. Fences are created signalled, so this doesn't wait the first time each frame is used.
+    VULKAN_CHECK(vkWaitForFences(device, 1, &frame.fence, true, UINT64_MAX), "Failed to wait for Fence");
+    completedSubmissionCount = std::max(completedSubmissionCount, frame.submissionIndex);
+    VULKAN_CHECK(vkResetFences(device, 1, &frame.fence), "Failed to reset Fence.")
+    BeginTransientUniforms(frameIndex);
+    InvalidateBoundState();
+
+    // The frame's previous submission has completed, so everything recorded for it can be released at once.
+    ResetRecording(frame.primary);
+    for (size_t i = 0; i < frame.commandListCount; i++) {
+        ResetRecording(frame.commandLists[i]);
     }
-    cmdBufferDescriptorSets.erase(cmdBuffer);
-
-    for (const VkFramebuffer &framebuffer : cmdBufferFramebuffers[cmdBuffer]) {
-        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    frame.commandListCount = 0;
+    renderPassBegin.renderPass = VK_NULL_HANDLE;
+    currentViewports.clear();
+    currentScissors.clear();
+
+    for (auto it = framebuffersToDestroy.begin(); it != framebuffersToDestroy.end();) {
+        if (it->first <= completedSubmissionCount) {
+            vkDestroyFramebuffer(device, it->second, nullptr);
+            it = framebuffersToDestroy.erase(it);
+        } else {
+            it++;
+        }
     }
-    cmdBufferFramebuffers.erase(cmdBuffer);
 
-    VULKAN_CHECK(vkResetCommandBuffer(cmdBuffer, VkCommandBufferResetFlagBits(0)), "Failed to reset CommandBuffer.");
+    cmdBuffer = frame.primary.cmdBuffer;
 
     VkCommandBufferBeginInfo beginInfo;
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1088,6 +1292,7 @@ void GraphicsAPI_Vulkan::BeginRendering() {
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     beginInfo.pInheritanceInfo = nullptr;
     VULKAN_CHECK(vkBeginCommandBuffer(cmdBuffer, &beginInfo), "Failed to begin CommandBuffer.");
+    ResetTimestampQueries();
 
     if (currentDesktopSwapchainImage) {
         VkImageMemoryBarrier barrier;
@@ -1108,6 +1313,12 @@ void GraphicsAPI_Vulkan::BeginRendering() {
     }
 }
 
+size_t GraphicsAPI_Vulkan::GetUniformBufferOffsetAlignment() {
+    VkPhysicalDeviceProperties physicalDeviceProperties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+    return static_cast<size_t>(physicalDeviceProperties.limits.minUniformBufferOffsetAlignment);
+}
+
 void GraphicsAPI_Vulkan::EndRendering() {
     if (inRenderPass) {
         vkCmdEndRenderPass(cmdBuffer);
@@ -1134,35 +1345,176 @@ void GraphicsAPI_Vulkan::EndRendering() {
 
     VULKAN_CHECK(vkEndCommandBuffer(cmdBuffer), "Failed to end CommandBuffer.");
 
-    VkPipelineStageFlags waitDstStageMask = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    // Submit the uploads recorded since the last frame, so that this frame reads the new data. On the graphics queue, they
+    // are ordered before the frame by submission order. On the transfer queue, the frame waits on the upload semaphore.
+    FlushUploads();
+
+    VkSemaphore waitSemaphores[2];
+    VkPipelineStageFlags waitDstStageMasks[2];
+    uint64_t waitValues[2];
+    uint32_t waitSemaphoreCount = 0;
+    if (acquireSemaphore) {
+        waitSemaphores[waitSemaphoreCount] = acquireSemaphore;
+        waitDstStageMasks[waitSemaphoreCount] = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        waitValues[waitSemaphoreCount] = 0;  // Ignored for binary semaphores.
+        waitSemaphoreCount++;
+    }
+    const bool waitForUploads = uploadQueue != queue && uploadCount > frameWaitedUploadCount;
+    if (waitForUploads) {
+        waitSemaphores[waitSemaphoreCount] = uploadSemaphore;
+        waitDstStageMasks[waitSemaphoreCount] = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        waitValues[waitSemaphoreCount] = uploadCount;
+        waitSemaphoreCount++;
+        frameWaitedUploadCount = uploadCount;
+    }
+    VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+    timelineSubmitInfo.pNext = nullptr;
+    timelineSubmitInfo.waitSemaphoreValueCount = waitSemaphoreCount;
+    timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+    timelineSubmitInfo.signalSemaphoreValueCount = 0;
+    timelineSubmitInfo.pSignalSemaphoreValues = nullptr;
 
     VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.pNext = nullptr;
-    submitInfo.waitSemaphoreCount = acquireSemaphore ? 1 : 0;
-    submitInfo.pWaitSemaphores = acquireSemaphore ? &acquireSemaphore : nullptr;
-    submitInfo.pWaitDstStageMask = acquireSemaphore ? &waitDstStageMask : nullptr;
+    submitInfo.pNext = waitForUploads ? &timelineSubmitInfo : nullptr;
+    submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+    submitInfo.pWaitSemaphores = waitSemaphoreCount ? waitSemaphores : nullptr;
+    submitInfo.pWaitDstStageMask = waitSemaphoreCount ? waitDstStageMasks : nullptr;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmdBuffer;
     submitInfo.signalSemaphoreCount = submitSemaphore ? 1 : 0;
     submitInfo.pSignalSemaphores = submitSemaphore ? &submitSemaphore : nullptr;
 
-    VULKAN_CHECK(vkQueueSubmit(queue, 1, &submitInfo, fence), "Failed to submit to Queue.");
+    Frame &frame = frames[frameIndex];
+    VULKAN_CHECK(vkQueueSubmit(queue, 1, &submitInfo, frame.fence), "Failed to submit to Queue.");
+    frame.submissionIndex = ++submissionCount;
 }
 
 void GraphicsAPI_Vulkan::SetBufferData(void *buffer, size_t offset, size_t size, void *data) {
+    if (!data) {
+        return;
+    }
+
     VkBuffer vkBuffer = (VkBuffer)buffer;
-    VkDeviceMemory memory = bufferResources[vkBuffer].first;
-    void *mappedData = nullptr;
-    VULKAN_CHECK(vkMapMemory(device, memory, offset, size, 0, &mappedData), "Can not map Buffer.");
-    if (mappedData && data) {
-        memcpy(mappedData, data, size);
+    bool streaming = false;
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        streaming = bufferResources[vkBuffer].second.streaming;
+    }
+    if (streaming) {
+        // Streaming buffers are rewritten every frame, so write a copy that no frame is reading rather than wait for the GPU.
+        vkBuffer = GetWritableBufferCopy(vkBuffer, offset, size);
+    } else {
+        // Static buffers are updated in place, so wait if a submitted frame may still be reading from it.
+        auto it = bufferSubmissionIndices.find(vkBuffer);
+        if (it != bufferSubmissionIndices.end() && it->second <= submissionCount) {
+            WaitForSubmission(it->second);
+        }
+    }
+
+    uint8_t *mappedData = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        mappedData = (uint8_t *)GetMappedData(vkBuffer);
+    }
+    if (mappedData) {
+        memcpy(mappedData + offset, data, size);
         // Because the VkDeviceMemory use a heap with properties (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
         // We don't need to use vkFlushMappedMemoryRanges() or vkInvalidateMappedMemoryRanges()
+    } else {
+        // Device-local memory can't be mapped, so copy the data in through the staging ring.
+        StageBufferData(vkBuffer, static_cast<VkDeviceSize>(offset), static_cast<VkDeviceSize>(size), data);
     }
-    vkUnmapMemory(device, memory);
 };
 
+void GraphicsAPI_Vulkan::SetTransientUniformData(void *buffer, size_t offset, size_t size, const void *data, bool /*discard*/) {
+    // BeginRendering() has waited for the frame that last used the page, so it's written in place. Transient uniforms
+    // are allocated on the threads recording command lists, so this mustn't look at bufferSubmissionIndices.
+    memcpy((uint8_t *)GetBufferMappedData(buffer) + offset, data, size);
+}
+
+void *GraphicsAPI_Vulkan::GetBufferMappedData(void *buffer) {
+    std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+    auto copiesIt = bufferCopies.find((VkBuffer)buffer);
+    return GetMappedData(copiesIt != bufferCopies.end() ? copiesIt->second.copies[copiesIt->second.current] : (VkBuffer)buffer);
+}
+
+void *GraphicsAPI_Vulkan::GetMappedData(VkBuffer buffer) {
+    const MemoryAllocation &allocation = bufferResources[buffer].first;
+    if (!allocation.block || !allocation.block->mappedData) {
+        return nullptr;
+    }
+    return (uint8_t *)allocation.block->mappedData + allocation.offset;
+}
+
+bool GraphicsAPI_Vulkan::IsBufferInUse(VkBuffer buffer) {
+    auto it = bufferSubmissionIndices.find(buffer);
+    return it != bufferSubmissionIndices.end() && !IsSubmissionComplete(it->second);
+}
+
+VkBuffer GraphicsAPI_Vulkan::GetBufferCopy(VkBuffer buffer) {
+    std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+    auto copiesIt = bufferCopies.find(buffer);
+    return copiesIt != bufferCopies.end() ? copiesIt->second.copies[copiesIt->second.current] : buffer;
+}
+
+VkBuffer GraphicsAPI_Vulkan::GetWritableBufferCopy(VkBuffer buffer, size_t offset, size_t size) {
+    std::vector<VkBuffer> copies{buffer};
+    size_t current = 0;
+    BufferCreateInfo bufferCI;
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        auto copiesIt = bufferCopies.find(buffer);
+        if (copiesIt != bufferCopies.end()) {
+            copies = copiesIt->second.copies;
+            current = copiesIt->second.current;
+        }
+        bufferCI = bufferResources[buffer].second;
+    }
+    if (!IsBufferInUse(copies[current])) {
+        return copies[current];
+    }
+
+    // Move on to the next copy that no frame reads, or create one.
+    size_t next = copies.size();
+    for (size_t i = 1; i < copies.size(); i++) {
+        const size_t index = (current + i) % copies.size();
+        if (!IsBufferInUse(copies[index])) {
+            next = index;
+            break;
+        }
+    }
+    if (next == copies.size()) {
+        if (copies.size() < frames.size() + 1) {
+            BufferCreateInfo copyCI = bufferCI;
+            copyCI.data = nullptr;
+            copies.push_back((VkBuffer)CreateBuffer(copyCI));
+        } else {
+            // Every copy is in use, so wait for the oldest. If the frame being recorded reads it, the buffer was rewritten
+            // more often in one frame than it has copies, and it's overwritten as before. Such data belongs in
+            // AllocateTransientUniform().
+            next = (current + 1) % copies.size();
+            const uint64_t submissionIndex = bufferSubmissionIndices[copies[next]];
+            if (submissionIndex <= submissionCount) {
+                WaitForSubmission(submissionIndex);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        if (offset != 0 || size < bufferCI.size) {
+            memcpy(GetMappedData(copies[next]), GetMappedData(copies[current]), bufferCI.size);
+        }
+        BufferCopies &bufferCopy = bufferCopies[buffer];
+        bufferCopy.copies = copies;
+        bufferCopy.current = next;
+    }
+    // The redundant state filter may still have the buffer as bound, but commands recorded from now on must bind the new copy.
+    InvalidateBoundState();
+    return copies[next];
+}
+
 void GraphicsAPI_Vulkan::ClearColor(void *imageView, float r, float g, float b, float a) {
     const ImageViewCreateInfo &imageViewCI = imageViewResources[(VkImageView)imageView];
 
@@ -1252,6 +1604,7 @@ void GraphicsAPI_Vulkan::ClearDepth(void *imageView, float d) {
 void GraphicsAPI_Vulkan::SetRenderAttachments(void **colorViews, size_t colorViewCount, void *depthStencilView, uint32_t width, uint32_t height, void *pipeline) {
     if (inRenderPass) {
         vkCmdEndRenderPass(cmdBuffer);
+        inRenderPass = false;
     }
 
     VkRenderPass renderPass = std::get<2>(pipelineResources[(VkPipeline)pipeline]);
@@ -1264,32 +1617,53 @@ void GraphicsAPI_Vulkan::SetRenderAttachments(void **colorViews, size_t colorVie
         vkImageViews.push_back((VkImageView)depthStencilView);
     }
 
+    // Reuse the framebuffer for this render pass, extent and attachments if there is one.
+    std::vector<uint64_t> framebufferKey;
+    framebufferKey.reserve(2 + vkImageViews.size());
+    framebufferKey.push_back((uint64_t)renderPass);
+    framebufferKey.push_back(((uint64_t)width << 32) | (uint64_t)height);
+    for (const VkImageView &imageView : vkImageViews) {
+        framebufferKey.push_back((uint64_t)imageView);
+    }
+
     VkFramebuffer framebuffer{};
-    VkFramebufferCreateInfo framebufferCI;
-    framebufferCI.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-    framebufferCI.pNext = nullptr;
-    framebufferCI.flags = 0;
-    framebufferCI.renderPass = renderPass;
-    framebufferCI.attachmentCount = static_cast<uint32_t>(vkImageViews.size());
-    framebufferCI.pAttachments = vkImageViews.data();
-    framebufferCI.width = width;
-    framebufferCI.height = height;
-    framebufferCI.layers = 1;
-    VULKAN_CHECK(vkCreateFramebuffer(device, &framebufferCI, nullptr, &framebuffer), "Failed to create Framebuffer");
-    cmdBufferFramebuffers[cmdBuffer].push_back(framebuffer);
-
-    VkRenderPassBeginInfo renderPassBegin;
+    auto it = framebufferCache.find(framebufferKey);
+    if (it != framebufferCache.end()) {
+        framebuffer = it->second->second;
+        framebufferLRU.splice(framebufferLRU.begin(), framebufferLRU, it->second);
+    } else {
+        VkFramebufferCreateInfo framebufferCI;
+        framebufferCI.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferCI.pNext = nullptr;
+        framebufferCI.flags = 0;
+        framebufferCI.renderPass = renderPass;
+        framebufferCI.attachmentCount = static_cast<uint32_t>(vkImageViews.size());
+        framebufferCI.pAttachments = vkImageViews.data();
+        framebufferCI.width = width;
+        framebufferCI.height = height;
+        framebufferCI.layers = 1;
+        VULKAN_CHECK(vkCreateFramebuffer(device, &framebufferCI, nullptr, &framebuffer), "Failed to create Framebuffer");
+
+        framebufferLRU.push_front({framebufferKey, framebuffer});
+        framebufferCache[framebufferKey] = framebufferLRU.begin();
+        if (framebufferLRU.size() > maxCachedFramebuffers) {
+            // The least recently used framebuffer may still be referenced by a recorded command buffer, so defer its destruction.
+            framebuffersToDestroy.push_back({submissionCount + 1, framebufferLRU.back().second});
+            framebufferCache.erase(framebufferLRU.back().first);
+            framebufferLRU.pop_back();
+        }
+    }
+
+    // The attachments are loaded and stored, so beginning the render pass later, or more than once, doesn't change the result.
     renderPassBegin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassBegin.pNext = nullptr;
     renderPassBegin.renderPass = renderPass;
     renderPassBegin.framebuffer = framebuffer;
     renderPassBegin.renderArea.offset = {0, 0};
-    renderPassBegin.renderArea.extent.width = framebufferCI.width;
-    renderPassBegin.renderArea.extent.height = framebufferCI.height;
+    renderPassBegin.renderArea.extent.width = width;
+    renderPassBegin.renderArea.extent.height = height;
     renderPassBegin.clearValueCount = 0;
     renderPassBegin.pClearValues = nullptr;
-    vkCmdBeginRenderPass(cmdBuffer, &renderPassBegin, VK_SUBPASS_CONTENTS_INLINE);
-    inRenderPass = true;
 }
 
 void GraphicsAPI_Vulkan::SetViewports(Viewport *viewports, size_t count) {
@@ -1300,7 +1674,10 @@ void GraphicsAPI_Vulkan::SetViewports(Viewport *viewports, size_t count) {
         vkViewports.push_back({viewport.x, viewport.y, viewport.width, viewport.height, viewport.minDepth, viewport.maxDepth});
     }
 
-    vkCmdSetViewport(cmdBuffer, 0, static_cast<uint32_t>(vkViewports.size()), vkViewports.data());
+    vkCmdSetViewport(GetRecording().cmdBuffer, 0, static_cast<uint32_t>(vkViewports.size()), vkViewports.data());
+    if (!threadCommandList) {
+        currentViewports = vkViewports;
+    }
 }
 void GraphicsAPI_Vulkan::SetScissors(Rect2D *scissors, size_t count) {
     std::vector<VkRect2D> vkRect2D;
@@ -1310,14 +1687,23 @@ void GraphicsAPI_Vulkan::SetScissors(Rect2D *scissors, size_t count) {
         vkRect2D.push_back({{scissor.offset.x, scissor.offset.y}, {scissor.extent.width, scissor.extent.height}});
     }
 
-    vkCmdSetScissor(cmdBuffer, 0, static_cast<uint32_t>(vkRect2D.size()), vkRect2D.data());
+    vkCmdSetScissor(GetRecording().cmdBuffer, 0, static_cast<uint32_t>(vkRect2D.size()), vkRect2D.data());
+    if (!threadCommandList) {
+        currentScissors = vkRect2D;
+    }
 }
 void GraphicsAPI_Vulkan::SetPipeline(void *pipeline) {
-    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipeline)pipeline);
-    setPipeline = (VkPipeline)pipeline;
+    if (!FilterSetPipeline(pipeline)) {
+        return;
+    }
+
+    Recording &recording = GetRecording();
+    vkCmdBindPipeline(recording.cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipeline)pipeline);
+    recording.setPipeline = (VkPipeline)pipeline;
 }
 
 void GraphicsAPI_Vulkan::SetDescriptor(const DescriptorInfo &descriptorInfo) {
+    std::vector<std::tuple<VkWriteDescriptorSet, VkDescriptorBufferInfo, VkDescriptorImageInfo>> &writeDescSets = GetRecording().writeDescSets;
     VkWriteDescriptorSet writeDescSet;
     writeDescSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     writeDescSet.pNext = nullptr;
@@ -1333,11 +1719,11 @@ void GraphicsAPI_Vulkan::SetDescriptor(const DescriptorInfo &descriptorInfo) {
 
     if (descriptorInfo.type == DescriptorInfo::Type::BUFFER) {
         VkDescriptorBufferInfo &descBufferInfo = std::get<1>(writeDescSets.back());
-        VkBuffer buffer = (VkBuffer)descriptorInfo.resource;
-        const BufferCreateInfo &bufferCI = bufferResources[buffer].second;
+        VkBuffer buffer = GetBufferCopy((VkBuffer)descriptorInfo.resource);
         descBufferInfo.buffer = buffer;
         descBufferInfo.offset = descriptorInfo.bufferOffset;
         descBufferInfo.range = descriptorInfo.bufferSize;
+        TrackBufferUse(buffer);
     } else if (descriptorInfo.type == DescriptorInfo::Type::IMAGE) {
         VkDescriptorImageInfo &descImageInfo = std::get<2>(writeDescSets.back());
         VkImageView imageView = (VkImageView)descriptorInfo.resource;
@@ -1358,65 +1744,866 @@ void GraphicsAPI_Vulkan::SetDescriptor(const DescriptorInfo &descriptorInfo) {
 }
 
 void GraphicsAPI_Vulkan::UpdateDescriptors() {
-    VkPipelineLayout pipelineLayout = std::get<0>(pipelineResources[(VkPipeline)setPipeline]);
-    VkDescriptorSetLayout descSetLayout = std::get<1>(pipelineResources[(VkPipeline)setPipeline]);
-    PipelineCreateInfo pipelinCI = std::get<3>(pipelineResources[(VkPipeline)setPipeline]);
+    Recording &recording = GetRecording();
+    std::vector<std::tuple<VkWriteDescriptorSet, VkDescriptorBufferInfo, VkDescriptorImageInfo>> &writeDescSets = recording.writeDescSets;
+    // Command lists call this concurrently, so only look the pipeline up with find().
+    auto pipelineIt = pipelineResources.find(recording.setPipeline);
+    if (pipelineIt == pipelineResources.end()) {
+        std::cout << "ERROR: UpdateDescriptors() called without a pipeline set." << std::endl;
+        DEBUG_BREAK;
+        return;
+    }
+    VkPipelineLayout pipelineLayout = std::get<0>(pipelineIt->second);
+    VkDescriptorSetLayout descSetLayout = std::get<1>(pipelineIt->second);
+
+    // Build a key from the set layout and the bound resources. If an identical set has already been written since the last reset, reuse it.
+    std::vector<uint64_t> descSetKey;
+    descSetKey.reserve(1 + 7 * writeDescSets.size());
+    descSetKey.push_back((uint64_t)descSetLayout);
+    for (const auto &writeDescSet : writeDescSets) {
+        const VkWriteDescriptorSet &vkWriteDescSet = std::get<0>(writeDescSet);
+        const VkDescriptorBufferInfo &vkDescBufferInfo = std::get<1>(writeDescSet);
+        const VkDescriptorImageInfo &vkDescImageInfo = std::get<2>(writeDescSet);
+        descSetKey.push_back(((uint64_t)vkWriteDescSet.dstBinding << 32) | (uint64_t)vkWriteDescSet.descriptorType);
+        descSetKey.push_back((uint64_t)vkDescBufferInfo.buffer);
+        descSetKey.push_back((uint64_t)vkDescBufferInfo.offset);
+        descSetKey.push_back((uint64_t)vkDescBufferInfo.range);
+        descSetKey.push_back((uint64_t)vkDescImageInfo.imageView);
+        descSetKey.push_back((uint64_t)vkDescImageInfo.sampler);
+        descSetKey.push_back((uint64_t)vkDescImageInfo.imageLayout);
+    }
 
+    std::unordered_map<std::vector<uint64_t>, VkDescriptorSet, KeyHash> &descriptorSetCache = recording.descriptorSetCache;
     VkDescriptorSet descSet{};
-    VkDescriptorSetAllocateInfo descSetAI;
-    descSetAI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    descSetAI.pNext = nullptr;
-    descSetAI.descriptorPool = descriptorPool;
-    descSetAI.descriptorSetCount = 1;
-    descSetAI.pSetLayouts = &descSetLayout;
-    VULKAN_CHECK(vkAllocateDescriptorSets(device, &descSetAI, &descSet), "Failed to allocate DescriptorSet.");
-
-    std::vector<VkWriteDescriptorSet> vkWriteDescSets;
-    for (auto &writeDescSet : writeDescSets) {
-        VkWriteDescriptorSet &vkWriteDescSet = std::get<0>(writeDescSet);
-        VkDescriptorBufferInfo &vkDescBufferInfo = std::get<1>(writeDescSet);
-        VkDescriptorImageInfo &vkDescImageInfo = std::get<2>(writeDescSet);
-
-        vkWriteDescSet.dstSet = descSet;
-        if (vkDescBufferInfo.buffer) {
-            vkWriteDescSet.pBufferInfo = &vkDescBufferInfo;
-        } else if (vkDescImageInfo.imageView || vkDescImageInfo.sampler) {
-            vkWriteDescSet.pImageInfo = &vkDescImageInfo;
-        } else {
-            continue;
+    auto it = descriptorSetCache.find(descSetKey);
+    if (it != descriptorSetCache.end()) {
+        descSet = it->second;
+    } else {
+        descSet = AllocateDescriptorSet(recording, descSetLayout);
+
+        std::vector<VkWriteDescriptorSet> vkWriteDescSets;
+        for (auto &writeDescSet : writeDescSets) {
+            VkWriteDescriptorSet &vkWriteDescSet = std::get<0>(writeDescSet);
+            VkDescriptorBufferInfo &vkDescBufferInfo = std::get<1>(writeDescSet);
+            VkDescriptorImageInfo &vkDescImageInfo = std::get<2>(writeDescSet);
+
+            vkWriteDescSet.dstSet = descSet;
+            if (vkDescBufferInfo.buffer) {
+                vkWriteDescSet.pBufferInfo = &vkDescBufferInfo;
+            } else if (vkDescImageInfo.imageView || vkDescImageInfo.sampler) {
+                vkWriteDescSet.pImageInfo = &vkDescImageInfo;
+            } else {
+                continue;
+            }
+            vkWriteDescSets.push_back(vkWriteDescSet);
         }
-        vkWriteDescSets.push_back(vkWriteDescSet);
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(vkWriteDescSets.size()), vkWriteDescSets.data(), 0, nullptr);
+        descriptorSetCache[descSetKey] = descSet;
     }
-    vkUpdateDescriptorSets(device, static_cast<uint32_t>(vkWriteDescSets.size()), vkWriteDescSets.data(), 0, nullptr);
     writeDescSets.clear();
 
-    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 0, nullptr);
-    cmdBufferDescriptorSets[cmdBuffer].push_back({descSet});
+    vkCmdBindDescriptorSets(recording.cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 0, nullptr);
 }
 
 void GraphicsAPI_Vulkan::SetVertexBuffers(void **vertexBuffers, size_t count) {
+    if (!FilterSetVertexBuffers(vertexBuffers, count)) {
+        return;
+    }
+
     std::vector<VkBuffer> vkBuffers;
     std::vector<VkDeviceSize> offsets;
     for (size_t i = 0; i < count; i++) {
-        vkBuffers.push_back((VkBuffer)vertexBuffers[i]);
+        vkBuffers.push_back(GetBufferCopy((VkBuffer)vertexBuffers[i]));
         offsets.push_back(0);
+        TrackBufferUse(vkBuffers.back());
     }
 
-    vkCmdBindVertexBuffers(cmdBuffer, 0, static_cast<uint32_t>(vkBuffers.size()), vkBuffers.data(), offsets.data());
+    vkCmdBindVertexBuffers(GetRecording().cmdBuffer, 0, static_cast<uint32_t>(vkBuffers.size()), vkBuffers.data(), offsets.data());
 }
 
 void GraphicsAPI_Vulkan::SetIndexBuffer(void *indexBuffer) {
-    const BufferCreateInfo &bufferCI = bufferResources[(VkBuffer)indexBuffer].second;
-    VkIndexType type = bufferCI.stride == 4 ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
-    vkCmdBindIndexBuffer(cmdBuffer, (VkBuffer)indexBuffer, 0, type);
+    if (!FilterSetIndexBuffer(indexBuffer)) {
+        return;
+    }
+
+    VkIndexType type = VK_INDEX_TYPE_UINT16;
+    {
+        std::lock_guard<std::mutex> lock(bufferResourcesMutex);
+        type = bufferResources[(VkBuffer)indexBuffer].second.stride == 4 ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+    }
+    VkBuffer buffer = GetBufferCopy((VkBuffer)indexBuffer);
+    TrackBufferUse(buffer);
+    vkCmdBindIndexBuffer(GetRecording().cmdBuffer, buffer, 0, type);
 }
 
 void GraphicsAPI_Vulkan::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) {
-    vkCmdDrawIndexed(cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    if (!threadCommandList) {
+        BeginRenderPass(VK_SUBPASS_CONTENTS_INLINE);
+    }
+    vkCmdDrawIndexed(GetRecording().cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 }
 
 void GraphicsAPI_Vulkan::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
-    vkCmdDraw(cmdBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+    if (!threadCommandList) {
+        BeginRenderPass(VK_SUBPASS_CONTENTS_INLINE);
+    }
+    vkCmdDraw(GetRecording().cmdBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+void *GraphicsAPI_Vulkan::BeginCommandList() {
+    if (!renderPassBegin.renderPass) {
+        std::cout << "ERROR: BeginCommandList() called without render attachments. Call SetRenderAttachments() first." << std::endl;
+        DEBUG_BREAK;
+        return nullptr;
+    }
+
+    Recording *commandList = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(commandListMutex);
+        Frame &frame = frames[frameIndex];
+        if (frame.commandListCount == frame.commandLists.size()) {
+            frame.commandLists.emplace_back();
+            CreateRecording(frame.commandLists.back(), VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+        }
+        commandList = &frame.commandLists[frame.commandListCount++];
+    }
+
+    VkCommandBufferInheritanceInfo inheritanceInfo;
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.pNext = nullptr;
+    inheritanceInfo.renderPass = renderPassBegin.renderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = renderPassBegin.framebuffer;
+    inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+    inheritanceInfo.queryFlags = VkQueryControlFlags(0);
+    inheritanceInfo.pipelineStatistics = VkQueryPipelineStatisticFlags(0);
+
+    VkCommandBufferBeginInfo beginInfo;
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext = nullptr;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    VULKAN_CHECK(vkBeginCommandBuffer(commandList->cmdBuffer, &beginInfo), "Failed to begin CommandBuffer.");
+
+    // Secondary command buffers don't inherit dynamic state, so start with the rendering thread's.
+    if (!currentViewports.empty()) {
+        vkCmdSetViewport(commandList->cmdBuffer, 0, static_cast<uint32_t>(currentViewports.size()), currentViewports.data());
+    }
+    if (!currentScissors.empty()) {
+        vkCmdSetScissor(commandList->cmdBuffer, 0, static_cast<uint32_t>(currentScissors.size()), currentScissors.data());
+    }
+
+    commandList->recordingState = {};
+    threadCommandList = commandList;
+    SetThreadRecordingState(&commandList->recordingState);
+    return (void *)commandList;
+}
+
+void GraphicsAPI_Vulkan::EndCommandList(void *commandList) {
+    Recording *recording = (Recording *)commandList;
+    if (!recording || recording != threadCommandList) {
+        std::cout << "ERROR: EndCommandList() called without a matching BeginCommandList() on this thread." << std::endl;
+        DEBUG_BREAK;
+        return;
+    }
+    VULKAN_CHECK(vkEndCommandBuffer(recording->cmdBuffer), "Failed to end CommandBuffer.");
+    threadCommandList = nullptr;
+    SetThreadRecordingState(nullptr);
+}
+
+void GraphicsAPI_Vulkan::ExecuteCommandLists(void *const *commandLists, size_t count) {
+    std::vector<VkCommandBuffer> cmdBuffers;
+    cmdBuffers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        Recording *commandList = (Recording *)commandLists[i];
+        if (!commandList) {
+            continue;
+        }
+        cmdBuffers.push_back(commandList->cmdBuffer);
+        for (const VkBuffer &buffer : commandList->boundBuffers) {
+            bufferSubmissionIndices[buffer] = submissionCount + 1;
+        }
+        commandList->boundBuffers.clear();
+        AddStateBindStatistics(commandList->recordingState.stateBindStatistics);
+    }
+    if (cmdBuffers.empty()) {
+        return;
+    }
+
+    BeginRenderPass(VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(cmdBuffer, static_cast<uint32_t>(cmdBuffers.size()), cmdBuffers.data());
+    // Nothing else can be recorded in this render pass, so end it. The next draw begins it again.
+    vkCmdEndRenderPass(cmdBuffer);
+    inRenderPass = false;
+    // The state of the primary command buffer is undefined after vkCmdExecuteCommands().
+    InvalidateBoundState();
+    frames[frameIndex].primary.setPipeline = VK_NULL_HANDLE;
+    if (!currentViewports.empty()) {
+        vkCmdSetViewport(cmdBuffer, 0, static_cast<uint32_t>(currentViewports.size()), currentViewports.data());
+    }
+    if (!currentScissors.empty()) {
+        vkCmdSetScissor(cmdBuffer, 0, static_cast<uint32_t>(currentScissors.size()), currentScissors.data());
+    }
+}
+
+void GraphicsAPI_Vulkan::CreateFrames(uint32_t framesInFlight) {
+    frames.resize(std::max(1u, std::min(framesInFlight, 3u)));
+    for (Frame &frame : frames) {
+        CreateRecording(frame.primary, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+        VkFenceCreateInfo fenceCI{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+        fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceCI.pNext = nullptr;
+        fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        VULKAN_CHECK(vkCreateFence(device, &fenceCI, nullptr, &frame.fence), "Failed to create Fence.")
+    }
+    frameIndex = frames.size() - 1;
+    cmdBuffer = frames[frameIndex].primary.cmdBuffer;
+}
+
+void GraphicsAPI_Vulkan::CreateRecording(Recording &recording, VkCommandBufferLevel level) {
+    // Each recording has its own pool, so that all of its command buffer's memory is released with vkResetCommandPool().
+    VkCommandPoolCreateInfo cmdPoolCI;
+    cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    cmdPoolCI.pNext = nullptr;
+    cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    cmdPoolCI.queueFamilyIndex = queueFamilyIndex;
+    VULKAN_CHECK(vkCreateCommandPool(device, &cmdPoolCI, nullptr, &recording.cmdPool), "Failed to create CommandPool.");
+
+    VkCommandBufferAllocateInfo allocateInfo;
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.commandPool = recording.cmdPool;
+    allocateInfo.level = level;
+    allocateInfo.commandBufferCount = 1;
+    VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocateInfo, &recording.cmdBuffer), "Failed to allocate CommandBuffers.");
+
+    recording.descriptorPools.push_back(CreateDescriptorPool());
+}
+
+void GraphicsAPI_Vulkan::ResetRecording(Recording &recording) {
+    for (size_t i = 0; i <= recording.descriptorPoolIndex && i < recording.descriptorPools.size(); i++) {
+        VULKAN_CHECK(vkResetDescriptorPool(device, recording.descriptorPools[i], VkDescriptorPoolResetFlags(0)), "Failed to reset DescriptorPool.")
+    }
+    recording.descriptorPoolIndex = 0;
+    recording.descriptorSetCache.clear();
+    VULKAN_CHECK(vkResetCommandPool(device, recording.cmdPool, VkCommandPoolResetFlags(0)), "Failed to reset CommandPool.");
+    recording.setPipeline = VK_NULL_HANDLE;
+    recording.writeDescSets.clear();
+    recording.boundBuffers.clear();
+}
+
+void GraphicsAPI_Vulkan::DestroyRecording(Recording &recording) {
+    for (VkDescriptorPool &descPool : recording.descriptorPools) {
+        vkDestroyDescriptorPool(device, descPool, nullptr);
+    }
+    vkFreeCommandBuffers(device, recording.cmdPool, 1, &recording.cmdBuffer);
+    vkDestroyCommandPool(device, recording.cmdPool, nullptr);
+}
+
+GraphicsAPI_Vulkan::Recording &GraphicsAPI_Vulkan::GetRecording() {
+    return threadCommandList ? *threadCommandList : frames[frameIndex].primary;
+}
+
+void GraphicsAPI_Vulkan::TrackBufferUse(VkBuffer buffer) {
+    if (threadCommandList) {
+        threadCommandList->boundBuffers.push_back(buffer);
+    } else {
+        bufferSubmissionIndices[buffer] = submissionCount + 1;
+    }
+}
+
+void GraphicsAPI_Vulkan::BeginRenderPass(VkSubpassContents contents) {
+    if (inRenderPass && renderPassContents == contents) {
+        return;
+    }
+    if (!renderPassBegin.renderPass) {
+        std::cout << "ERROR: No render attachments are set. Call SetRenderAttachments() first." << std::endl;
+        DEBUG_BREAK;
+        return;
+    }
+    if (inRenderPass) {
+        vkCmdEndRenderPass(cmdBuffer);
+    }
+    vkCmdBeginRenderPass(cmdBuffer, &renderPassBegin, contents);
+    inRenderPass = true;
+    renderPassContents = contents;
+}
+
+void GraphicsAPI_Vulkan::WaitForSubmission(uint64_t submissionIndex) {
+    if (submissionIndex <= completedSubmissionCount) {
+        return;
+    }
+
+    // A fence signalled by vkQueueSubmit() also covers every earlier submission to the queue, so wait on the
+    // earliest pending submission at or after the requested one.
+    Frame *waitFrame = nullptr;
+    for (Frame &frame : frames) {
+        if (frame.submissionIndex >= submissionIndex && frame.submissionIndex > completedSubmissionCount && (!waitFrame || frame.submissionIndex < waitFrame->submissionIndex)) {
+            waitFrame = &frame;
+        }
+    }
+    if (!waitFrame) {
+        return;
+    }
+
+    VULKAN_CHECK(vkWaitForFences(device, 1, &waitFrame->fence, true, UINT64_MAX), "Failed to wait for Fence");
+    completedSubmissionCount = waitFrame->submissionIndex;
+}
+
+bool GraphicsAPI_Vulkan::IsSubmissionComplete(uint64_t submissionIndex) {
+    if (submissionIndex <= completedSubmissionCount) {
+        return true;
+    }
+    if (submissionIndex > submissionCount) {
+        return false;
+    }
+
+    // As WaitForSubmission(), but only polls the fence.
+    Frame *waitFrame = nullptr;
+    for (Frame &frame : frames) {
+        if (frame.submissionIndex >= submissionIndex && frame.submissionIndex > completedSubmissionCount && (!waitFrame || frame.submissionIndex < waitFrame->submissionIndex)) {
+            waitFrame = &frame;
+        }
+    }
+    if (!waitFrame || vkGetFenceStatus(device, waitFrame->fence) != VK_SUCCESS) {
+        return false;
+    }
+    completedSubmissionCount = waitFrame->submissionIndex;
+    return true;
+}
+
+bool GraphicsAPI_Vulkan::WriteTimestamp(uint64_t &timestamp) {
+    if (!timestampQueryPool) {
+        if (!timestampsSupported) {
+            return false;
+        }
+        uint32_t queueFamilyPropertiesCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyPropertiesCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, queueFamilyProperties.data());
+        VkPhysicalDeviceProperties physicalDeviceProperties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+        const uint32_t validBits = queueFamilyIndex < queueFamilyPropertiesCount ? queueFamilyProperties[queueFamilyIndex].timestampValidBits : 0;
+        if (validBits == 0 || physicalDeviceProperties.limits.timestampPeriod <= 0.0f) {
+            timestampsSupported = false;
+            return false;
+        }
+        timestampPeriod = static_cast<double>(physicalDeviceProperties.limits.timestampPeriod);
+        timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+        VkQueryPoolCreateInfo queryPoolCI{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+        queryPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCI.queryCount = maxTimestampQueries;
+        VULKAN_CHECK(vkCreateQueryPool(device, &queryPoolCI, nullptr, &timestampQueryPool), "Failed to create QueryPool.");
+        timestampQuerySubmissions.resize(maxTimestampQueries, 0);
+        for (uint32_t i = maxTimestampQueries; i > 0; i--) {
+            timestampQueriesToReset.push_back(i - 1);
+        }
+    }
+    // In a multiview render pass, a timestamp writes one query for each view. Instead, end the render pass, which the next
+    // draw begins again. Its attachments are loaded and stored, so this only costs the extra render pass.
+    if (inRenderPass && multiviewRenderPasses.count(renderPassBegin.renderPass)) {
+        vkCmdEndRenderPass(cmdBuffer);
+        inRenderPass = false;
+    }
+    if (freeTimestampQueries.empty() && !inRenderPass) {
+        ResetTimestampQueries();
+    }
+    if (freeTimestampQueries.empty()) {
+        return false;
+    }
+
+    const uint32_t query = freeTimestampQueries.back();
+    freeTimestampQueries.pop_back();
+    // Written once all earlier commands have completed, so that a scope measures the work recorded inside it.
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, query);
+    timestampQuerySubmissions[query] = submissionCount + 1;  // Submitted by the next EndRendering().
+    timestamp = query;
+    return true;
+}
+
+bool GraphicsAPI_Vulkan::ReadTimestamp(uint64_t timestamp, uint64_t &nanoseconds) {
+    const uint32_t query = static_cast<uint32_t>(timestamp);
+    // Until the submission has completed, the query may still hold the result from its previous use.
+    if (!IsSubmissionComplete(timestampQuerySubmissions[query])) {
+        return false;
+    }
+    uint64_t ticks = 0;
+    if (vkGetQueryPoolResults(device, timestampQueryPool, query, 1, sizeof(ticks), &ticks, sizeof(ticks), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return false;
+    }
+    nanoseconds = static_cast<uint64_t>(static_cast<double>(ticks & timestampMask) * timestampPeriod);
+    return true;
+}
+
+void GraphicsAPI_Vulkan::ReleaseTimestamp(uint64_t timestamp) {
+    timestampQueriesToReset.push_back(static_cast<uint32_t>(timestamp));
+}
+
+void GraphicsAPI_Vulkan::ResetTimestampQueries() {
+    for (const uint32_t &query : timestampQueriesToReset) {
+        vkCmdResetQueryPool(cmdBuffer, timestampQueryPool, query, 1);
+        freeTimestampQueries.push_back(query);
+    }
+    timestampQueriesToReset.clear();
+}
+
+void GraphicsAPI_Vulkan::ClearDescriptorSetCaches() {
+    for (Frame &frame : frames) {
+        frame.primary.descriptorSetCache.clear();
+        for (Recording &commandList : frame.commandLists) {
+            commandList.descriptorSetCache.clear();
+        }
+    }
+}
+
+GraphicsAPI_Vulkan::MemoryAllocation GraphicsAPI_Vulkan::AllocateMemory(const VkMemoryRequirements &memoryRequirements, VkMemoryPropertyFlags properties) {
+    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties{};
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
+    uint32_t memoryTypeIndex = 0;
+    MemoryTypeFromProperties(physicalDeviceMemoryProperties, memoryRequirements.memoryTypeBits, properties, &memoryTypeIndex);
+
+    MemoryAllocation allocation{};
+    for (MemoryBlock &block : memoryBlocks) {
+        if (block.memoryTypeIndex == memoryTypeIndex && SubAllocateMemory(block, memoryRequirements, allocation)) {
+            return allocation;
+        }
+    }
+
+    // No existing block has room, so allocate a new one.
+    MemoryBlock block{};
+    block.memoryTypeIndex = memoryTypeIndex;
+    block.size = std::max(memoryBlockSize, memoryRequirements.size);
+
+    VkMemoryAllocateInfo allocateInfo;
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.allocationSize = block.size;
+    allocateInfo.memoryTypeIndex = memoryTypeIndex;
+    VULKAN_CHECK(vkAllocateMemory(device, &allocateInfo, nullptr, &block.memory), "Failed to allocate Memory.");
+
+    if (BitwiseCheck(physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags, VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))) {
+        VULKAN_CHECK(vkMapMemory(device, block.memory, 0, VK_WHOLE_SIZE, 0, &block.mappedData), "Can not map Memory.");
+    }
+    block.freeRanges[0] = block.size;
+
+    memoryBlocks.push_back(block);
+    SubAllocateMemory(memoryBlocks.back(), memoryRequirements, allocation);
+    return allocation;
+}
+
+bool GraphicsAPI_Vulkan::SubAllocateMemory(MemoryBlock &block, const VkMemoryRequirements &memoryRequirements, MemoryAllocation &allocation) {
+    // First fit: take the lowest free range that can hold the size after aligning its offset.
+    for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); it++) {
+        VkDeviceSize rangeOffset = it->first;
+        VkDeviceSize rangeEnd = it->first + it->second;
+        VkDeviceSize offset = Align<VkDeviceSize>(rangeOffset, memoryRequirements.alignment);
+        if (offset + memoryRequirements.size > rangeEnd) {
+            continue;
+        }
+
+        // Return the alignment padding and the remainder of the range to the free list.
+        block.freeRanges.erase(it);
+        if (offset > rangeOffset) {
+            block.freeRanges[rangeOffset] = offset - rangeOffset;
+        }
+        if (offset + memoryRequirements.size < rangeEnd) {
+            block.freeRanges[offset + memoryRequirements.size] = rangeEnd - (offset + memoryRequirements.size);
+        }
+        block.allocationCount++;
+
+        allocation.block = &block;
+        allocation.offset = offset;
+        allocation.size = memoryRequirements.size;
+        return true;
+    }
+    return false;
+}
+
+void GraphicsAPI_Vulkan::FreeMemory(const MemoryAllocation &allocation) {
+    MemoryBlock &block = *allocation.block;
+
+    // Merge the range with the free ranges either side of it.
+    auto it = block.freeRanges.insert({allocation.offset, allocation.size}).first;
+    auto next = std::next(it);
+    if (next != block.freeRanges.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        block.freeRanges.erase(next);
+    }
+    if (it != block.freeRanges.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == it->first) {
+            prev->second += it->second;
+            block.freeRanges.erase(it);
+        }
+    }
+    block.allocationCount--;
+
+    if (block.allocationCount > 0) {
+        return;
+    }
+    size_t sameTypeBlockCount = 0;
+    for (const MemoryBlock &otherBlock : memoryBlocks) {
+        sameTypeBlockCount += otherBlock.memoryTypeIndex == block.memoryTypeIndex ? 1 : 0;
+    }
+    if (sameTypeBlockCount > 1 || block.size > memoryBlockSize) {
+        if (block.mappedData) {
+            vkUnmapMemory(device, block.memory);
+        }
+        vkFreeMemory(device, block.memory, nullptr);
+        memoryBlocks.remove_if([&block](const MemoryBlock &otherBlock) { return &otherBlock == &block; });
+    }
+}
+
+GraphicsAPI_Vulkan::MemoryStatistics GraphicsAPI_Vulkan::GetMemoryStatistics() const {
+    MemoryStatistics statistics{};
+    for (const MemoryBlock &block : memoryBlocks) {
+        statistics.blockCount++;
+        statistics.allocationCount += block.allocationCount;
+        statistics.blockBytes += block.size;
+        statistics.allocationBytes += block.size;
+        for (const auto &freeRange : block.freeRanges) {
+            statistics.allocationBytes -= freeRange.second;
+            statistics.freeRangeCount++;
+            statistics.largestFreeRange = std::max(statistics.largestFreeRange, freeRange.second);
+        }
+    }
+    return statistics;
+}
+
+void GraphicsAPI_Vulkan::CreateUploadResources(const std::vector<VkQueueFamilyProperties> &queueFamilyProperties, bool timelineSemaphoreEnabled) {
+    // Integrated GPUs have no separate video memory, so their static buffers are written in place if a memory type is both
+    // device local and host visible.
+    VkPhysicalDeviceProperties physicalDeviceProperties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties{};
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
+    const VkMemoryPropertyFlags unifiedMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    const bool integrated = physicalDeviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU || physicalDeviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+    uint32_t memoryTypeIndex = 0;
+    if (integrated && MemoryTypeFromProperties(physicalDeviceMemoryProperties, ~0u, unifiedMemoryProperties, &memoryTypeIndex)) {
+        staticBufferMemoryProperties = unifiedMemoryProperties;
+    }
+
+    uploadQueueFamilyIndex = queueFamilyIndex;
+    uploadQueue = queue;
+    if (!timelineSemaphoreEnabled) {
+        return;
+    }
+    vkGetSemaphoreCounterValueKHR = (PFN_vkGetSemaphoreCounterValueKHR)vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR");
+    vkWaitSemaphoresKHR = (PFN_vkWaitSemaphoresKHR)vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR");
+    if (!vkGetSemaphoreCounterValueKHR || !vkWaitSemaphoresKHR) {
+        return;
+    }
+
+    VkSemaphoreTypeCreateInfoKHR semaphoreTypeCI{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+    semaphoreTypeCI.pNext = nullptr;
+    semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    semaphoreTypeCI.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreCI{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    semaphoreCI.pNext = &semaphoreTypeCI;
+    semaphoreCI.flags = 0;
+    VULKAN_CHECK(vkCreateSemaphore(device, &semaphoreCI, nullptr, &uploadSemaphore), "Failed to create Semaphore.");
+
+    // A transfer-only family is usually backed by the GPU's copy engines, which run alongside rendering. Every queue of every
+    // family was created with the device.
+    for (size_t i = 0; i < queueFamilyProperties.size(); i++) {
+        const VkQueueFlags queueFlags = queueFamilyProperties[i].queueFlags;
+        if (BitwiseCheck(queueFlags, VkQueueFlags(VK_QUEUE_TRANSFER_BIT)) && !(queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) && queueFamilyProperties[i].queueCount > 0) {
+            uploadQueueFamilyIndex = static_cast<uint32_t>(i);
+            vkGetDeviceQueue(device, uploadQueueFamilyIndex, 0, &uploadQueue);
+            break;
+        }
+    }
+}
+
+void GraphicsAPI_Vulkan::StageBufferData(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void *data) {
+    if (!stagingBuffer) {
+        VkBufferCreateInfo vkBufferCI;
+        vkBufferCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        vkBufferCI.pNext = nullptr;
+        vkBufferCI.flags = 0;
+        vkBufferCI.size = stagingBufferSize;
+        vkBufferCI.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        vkBufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        vkBufferCI.queueFamilyIndexCount = 0;
+        vkBufferCI.pQueueFamilyIndices = nullptr;
+        VULKAN_CHECK(vkCreateBuffer(device, &vkBufferCI, nullptr, &stagingBuffer), "Failed to create Buffer.");
+
+        VkMemoryRequirements memoryRequirements{};
+        vkGetBufferMemoryRequirements(device, stagingBuffer, &memoryRequirements);
+        stagingAllocation = AllocateMemory(memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        VULKAN_CHECK(vkBindBufferMemory(device, stagingBuffer, stagingAllocation.block->memory, stagingAllocation.offset), "Failed to bind Memory to Buffer.");
+        stagingData = (uint8_t *)stagingAllocation.block->mappedData + stagingAllocation.offset;
+    }
+
+    // Large uploads are split, so that each part fits in the ring alongside the uploads still in flight.
+    const uint8_t *source = (const uint8_t *)data;
+    while (size > 0) {
+        const VkDeviceSize partSize = std::min(size, stagingBufferSize / 4);
+        const VkDeviceSize stagingOffset = AllocateStagingSpace(partSize);
+        memcpy(stagingData + stagingOffset, source, static_cast<size_t>(partSize));
+        RecordUploadCopy(buffer, {stagingOffset, offset, partSize});
+        source += partSize;
+        offset += partSize;
+        size -= partSize;
+    }
+}
+
+VkDeviceSize GraphicsAPI_Vulkan::AllocateStagingSpace(VkDeviceSize size) {
+    size = Align<VkDeviceSize>(size, 16);
+    while (true) {
+        ReclaimUploads();
+        // The data in use runs from the oldest unfinished batch's stagingBegin up to stagingHead, possibly wrapping around.
+        const bool empty = pendingUploads.empty() && currentUpload.copyCount == 0;
+        const VkDeviceSize tail = !pendingUploads.empty() ? pendingUploads.front().stagingBegin : currentUpload.stagingBegin;
+        VkDeviceSize offset = stagingBufferSize;
+        if (empty) {
+            offset = 0;
+        } else if (stagingHead > tail) {
+            if (stagingBufferSize - stagingHead >= size) {
+                offset = stagingHead;
+            } else if (tail >= size) {
+                offset = 0;
+            }
+        } else if (stagingHead < tail && tail - stagingHead >= size) {
+            offset = stagingHead;
+        }
+
+        if (offset != stagingBufferSize) {
+            if (currentUpload.copyCount == 0) {
+                currentUpload.stagingBegin = offset;
+            }
+            stagingHead = offset + size;
+            return offset;
+        }
+
+        // The ring is full. Submit what has been recorded, then wait for the oldest batch to free its space.
+        if (currentUpload.copyCount > 0) {
+            FlushUploads();
+        } else {
+            WaitForUploads(pendingUploads.front().uploadIndex);
+        }
+    }
+}
+
+void GraphicsAPI_Vulkan::RecordUploadCopy(VkBuffer buffer, const VkBufferCopy &region) {
+    if (!currentUpload.cmdPool) {
+        if (!freeUploads.empty()) {
+            currentUpload = freeUploads.back();
+            freeUploads.pop_back();
+        } else {
+            VkCommandPoolCreateInfo cmdPoolCI;
+            cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            cmdPoolCI.pNext = nullptr;
+            cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            cmdPoolCI.queueFamilyIndex = uploadQueueFamilyIndex;
+            VULKAN_CHECK(vkCreateCommandPool(device, &cmdPoolCI, nullptr, &currentUpload.cmdPool), "Failed to create CommandPool.");
+
+            VkCommandBufferAllocateInfo allocateInfo;
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.pNext = nullptr;
+            allocateInfo.commandPool = currentUpload.cmdPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocateInfo, &currentUpload.cmdBuffer), "Failed to allocate CommandBuffers.");
+
+            if (!uploadSemaphore) {
+                VkFenceCreateInfo fenceCI{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+                fenceCI.pNext = nullptr;
+                fenceCI.flags = 0;
+                VULKAN_CHECK(vkCreateFence(device, &fenceCI, nullptr, &currentUpload.fence), "Failed to create Fence.")
+            }
+        }
+    }
+
+    if (currentUpload.copyCount == 0) {
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = nullptr;
+        VULKAN_CHECK(vkBeginCommandBuffer(currentUpload.cmdBuffer, &beginInfo), "Failed to begin CommandBuffer.");
+    }
+
+    // A second write to the same buffer in this batch must not race the first.
+    uint64_t &bufferUploadIndex = bufferUploadIndices[buffer];
+    if (bufferUploadIndex == uploadCount + 1) {
+        VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        barrier.pNext = nullptr;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(currentUpload.cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VkDependencyFlags(0), 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    bufferUploadIndex = uploadCount + 1;
+
+    vkCmdCopyBuffer(currentUpload.cmdBuffer, stagingBuffer, buffer, 1, &region);
+    currentUpload.copyCount++;
+}
+
+void GraphicsAPI_Vulkan::FlushUploads() {
+    if (currentUpload.copyCount == 0) {
+        return;
+    }
+
+    // Make the copies visible to later batches on the upload queue and, on the graphics queue, to the frames that read them.
+    // The transfer queue can't name the vertex and fragment stages, so there the frame's semaphore wait does that instead.
+    const bool graphicsQueue = uploadQueue == queue;
+    VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    barrier.pNext = nullptr;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | (graphicsQueue ? VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT : 0);
+    const VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT | (graphicsQueue ? VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : 0);
+    vkCmdPipelineBarrier(currentUpload.cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, VkDependencyFlags(0), 1, &barrier, 0, nullptr, 0, nullptr);
+    VULKAN_CHECK(vkEndCommandBuffer(currentUpload.cmdBuffer), "Failed to end CommandBuffer.");
+
+    currentUpload.uploadIndex = ++uploadCount;
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+    timelineSubmitInfo.pNext = nullptr;
+    timelineSubmitInfo.waitSemaphoreValueCount = 0;
+    timelineSubmitInfo.pWaitSemaphoreValues = nullptr;
+    timelineSubmitInfo.signalSemaphoreValueCount = 1;
+    timelineSubmitInfo.pSignalSemaphoreValues = &currentUpload.uploadIndex;
+
+    VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.pNext = uploadSemaphore ? &timelineSubmitInfo : nullptr;
+    submitInfo.waitSemaphoreCount = 0;
+    submitInfo.pWaitSemaphores = nullptr;
+    submitInfo.pWaitDstStageMask = nullptr;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &currentUpload.cmdBuffer;
+    submitInfo.signalSemaphoreCount = uploadSemaphore ? 1 : 0;
+    submitInfo.pSignalSemaphores = uploadSemaphore ? &uploadSemaphore : nullptr;
+    VULKAN_CHECK(vkQueueSubmit(uploadQueue, 1, &submitInfo, currentUpload.fence), "Failed to submit to Queue.");
+
+    pendingUploads.push_back(currentUpload);
+    currentUpload = UploadBatch();
+}
+
+void GraphicsAPI_Vulkan::WaitForUploads(uint64_t uploadIndex) {
+    if (uploadIndex > uploadCount) {
+        FlushUploads();
+    }
+    while (!pendingUploads.empty() && pendingUploads.front().uploadIndex <= uploadIndex) {
+        const UploadBatch &batch = pendingUploads.front();
+        if (uploadSemaphore) {
+            VkSemaphoreWaitInfoKHR waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+            waitInfo.pNext = nullptr;
+            waitInfo.flags = 0;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &uploadSemaphore;
+            waitInfo.pValues = &batch.uploadIndex;
+            VULKAN_CHECK(vkWaitSemaphoresKHR(device, &waitInfo, UINT64_MAX), "Failed to wait for Semaphore.");
+        } else {
+            VULKAN_CHECK(vkWaitForFences(device, 1, &batch.fence, true, UINT64_MAX), "Failed to wait for Fence");
+        }
+        ReclaimUploads();
+    }
+}
+
+void GraphicsAPI_Vulkan::ReclaimUploads() {
+    while (!pendingUploads.empty() && IsUploadComplete(pendingUploads.front())) {
+        UploadBatch batch = pendingUploads.front();
+        pendingUploads.pop_front();
+        completedUploadCount = batch.uploadIndex;
+
+        VULKAN_CHECK(vkResetCommandPool(device, batch.cmdPool, VkCommandPoolResetFlags(0)), "Failed to reset CommandPool.");
+        if (batch.fence) {
+            VULKAN_CHECK(vkResetFences(device, 1, &batch.fence), "Failed to reset Fence.")
+        }
+        batch.uploadIndex = 0;
+        batch.stagingBegin = 0;
+        batch.copyCount = 0;
+        freeUploads.push_back(batch);
+    }
+}
+
+bool GraphicsAPI_Vulkan::IsUploadComplete(const UploadBatch &batch) {
+    if (batch.uploadIndex <= completedUploadCount) {
+        return true;
+    }
+    if (uploadSemaphore) {
+        uint64_t value = 0;
+        VULKAN_CHECK(vkGetSemaphoreCounterValueKHR(device, uploadSemaphore, &value), "Failed to get Semaphore counter value.");
+        return value >= batch.uploadIndex;
+    }
+    return vkGetFenceStatus(device, batch.fence) == VK_SUCCESS;
+}
+
+void GraphicsAPI_Vulkan::DestroyUploadBatch(UploadBatch &batch) {
+    if (batch.cmdPool) {
+        vkFreeCommandBuffers(device, batch.cmdPool, 1, &batch.cmdBuffer);
+        vkDestroyCommandPool(device, batch.cmdPool, nullptr);
+    }
+    if (batch.fence) {
+        vkDestroyFence(device, batch.fence, nullptr);
+    }
+    batch = UploadBatch();
+}
+
+void GraphicsAPI_Vulkan::EvictFramebuffers(VkRenderPass renderPass, VkImageView imageView) {
+    for (auto it = framebufferLRU.begin(); it != framebufferLRU.end();) {
+        const std::vector<uint64_t> &framebufferKey = it->first;
+        bool usesRenderPass = renderPass != VK_NULL_HANDLE && framebufferKey[0] == (uint64_t)renderPass;
+        bool usesImageView = imageView != VK_NULL_HANDLE && std::find(framebufferKey.begin() + 2, framebufferKey.end(), (uint64_t)imageView) != framebufferKey.end();
+        if (usesRenderPass || usesImageView) {
+            // Destroyed once the current submission has completed, as it or an earlier one may still reference it.
+            framebuffersToDestroy.push_back({submissionCount + 1, it->second});
+            framebufferCache.erase(framebufferKey);
+            it = framebufferLRU.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+VkDescriptorPool GraphicsAPI_Vulkan::CreateDescriptorPool() {
+    uint32_t maxSets = 1024;
+    std::vector<VkDescriptorPoolSize> poolSizes{
+        {VK_DESCRIPTOR_TYPE_SAMPLER, 16 * maxSets},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 16 * maxSets},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16 * maxSets},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 * maxSets},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16 * maxSets}};
+
+    // No VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT: sets are never freed individually, only by vkResetDescriptorPool().
+    VkDescriptorPoolCreateInfo descPoolCI;
+    descPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descPoolCI.pNext = nullptr;
+    descPoolCI.flags = VkDescriptorPoolCreateFlags(0);
+    descPoolCI.maxSets = maxSets;
+    descPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    descPoolCI.pPoolSizes = poolSizes.data();
+    VkDescriptorPool descPool{};
+    VULKAN_CHECK(vkCreateDescriptorPool(device, &descPoolCI, nullptr, &descPool), "Failed to create DescriptorPool");
+    return descPool;
+}
+
+VkDescriptorSet GraphicsAPI_Vulkan::AllocateDescriptorSet(Recording &recording, VkDescriptorSetLayout descSetLayout) {
+    std::vector<VkDescriptorPool> &descriptorPools = recording.descriptorPools;
+    size_t &descriptorPoolIndex = recording.descriptorPoolIndex;
+    VkDescriptorSet descSet{};
+    VkDescriptorSetAllocateInfo descSetAI;
+    descSetAI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descSetAI.pNext = nullptr;
+    descSetAI.descriptorPool = descriptorPools[descriptorPoolIndex];
+    descSetAI.descriptorSetCount = 1;
+    descSetAI.pSetLayouts = &descSetLayout;
+    VkResult result = vkAllocateDescriptorSets(device, &descSetAI, &descSet);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        // The current pool is full. Move on to the next one, creating it if needed.
+        descriptorPoolIndex++;
+        if (descriptorPoolIndex == descriptorPools.size()) {
+            descriptorPools.push_back(CreateDescriptorPool());
+        }
+        descSetAI.descriptorPool = descriptorPools[descriptorPoolIndex];
+        result = vkAllocateDescriptorSets(device, &descSetAI, &descSet);
+    }
+    VULKAN_CHECK(result, "Failed to allocate DescriptorSet.");
+    return descSet;
 }
 
 // XR_DOCS_TAG_BEGIN_GraphicsAPI_Vulkan_LoadPFN_XrFunctions
@@ -11,7 +11,8 @@
 class GraphicsAPI_Vulkan : public GraphicsAPI {
 public:
     GraphicsAPI_Vulkan();
-    GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId systemId);
+    // framesInFlight is the number of frames that can be recorded on the CPU while earlier ones are still executing on the GPU (1-3).
+    GraphicsAPI_Vulkan(XrInstance m_xrInstance, XrSystemId systemId, uint32_t framesInFlight = defaultFramesInFlight);
     ~GraphicsAPI_Vulkan();
 
     virtual void* CreateDesktopSwapchain(const SwapchainCreateInfo& swapchainCI) override;
@@ -58,10 +59,14 @@ public:
     virtual void* CreatePipeline(const PipelineCreateInfo& pipelineCI) override;
     virtual void DestroyPipeline(void*& pipeline) override;
 
+    virtual void LoadPipelineCache(const std::string& filepath) override;
+    virtual void SavePipelineCache(const std::string& filepath) override;
+
     virtual void BeginRendering() override;
     virtual void EndRendering() override;
 
     virtual void SetBufferData(void* buffer, size_t offset, size_t size, void* data) override;
+    virtual void* GetBufferMappedData(void* buffer) override;
 
     virtual void ClearColor(void* imageView, float r, float g, float b, float a) override;
     virtual void ClearDepth(void* imageView, float d) override;
@@ -78,6 +83,26 @@ public:
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0) override;
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) override;
 
+    // Multiview needs VK_KHR_multiview, which is enabled when the device has it.
+    virtual bool SupportsMultiview() override { return multiviewSupported; }
+
+    // Command lists are secondary command buffers that continue the render pass of the current render attachments.
+    virtual bool SupportsCommandLists() override { return true; }
+    virtual void* BeginCommandList() override;
+    virtual void EndCommandList(void* commandList) override;
+    virtual void ExecuteCommandLists(void* const* commandLists, size_t count) override;
+
+    // Usage of the device memory blocks that buffers are sub-allocated from.
+    struct MemoryStatistics {
+        size_t blockCount;
+        size_t allocationCount;
+        VkDeviceSize blockBytes;       // Total size of the blocks allocated with vkAllocateMemory().
+        VkDeviceSize allocationBytes;  // Bytes handed out to buffers.
+        size_t freeRangeCount;         // Many small free ranges relative to largestFreeRange indicates fragmentation.
+        VkDeviceSize largestFreeRange;
+    };
+    MemoryStatistics GetMemoryStatistics() const;
+
 private:
     void LoadPFN_XrFunctions(XrInstance m_xrInstance);
     std::vector<std::string> GetInstanceExtensionsForOpenXR(XrInstance m_xrInstance, XrSystemId systemId);
@@ -86,6 +111,105 @@ private:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() override;
     virtual const std::vector<int64_t> GetSupportedDepthSwapchainFormats() override;
 
+    virtual size_t GetUniformBufferOffsetAlignment() override;
+    virtual void SetTransientUniformData(void* buffer, size_t offset, size_t size, const void* data, bool discard) override;
+
+    virtual bool WriteTimestamp(uint64_t& timestamp) override;
+    virtual bool ReadTimestamp(uint64_t timestamp, uint64_t& nanoseconds) override;
+    virtual void ReleaseTimestamp(uint64_t timestamp) override;
+    // Records resets for the released timestamp queries, so that they can be written again. Must be outside a render pass.
+    void ResetTimestampQueries();
+
+    // CreatePipeline() in two steps, so that CreatePipelineAsync() can build pipelines on another thread. BuildPipeline() only
+    // creates the Vulkan objects, and AddPipeline() records them in pipelineResources on the rendering thread.
+    struct BuiltPipeline {
+        VkPipeline pipeline;
+        VkPipelineLayout pipelineLayout;
+        VkDescriptorSetLayout descSetLayout;
+        VkRenderPass renderPass;
+        bool multiview;
+    };
+    std::vector<VkShaderStageFlagBits> GetShaderStages(const PipelineCreateInfo& pipelineCI);
+    BuiltPipeline BuildPipeline(const PipelineCreateInfo& pipelineCI, const std::vector<VkShaderStageFlagBits>& shaderStages);
+    void* AddPipeline(const BuiltPipeline& builtPipeline, const PipelineCreateInfo& pipelineCI);
+    virtual void* StartPipelineBuild(const PipelineCreateInfo& pipelineCI) override;
+    virtual bool FinishPipelineBuild(void* build, bool wait, void*& pipeline) override;
+    struct PipelineBuild {
+        PipelineCreateInfo pipelineCI;
+        std::future<BuiltPipeline> result;
+    };
+
+    void CreateFrames(uint32_t framesInFlight);
+    struct Recording;
+    void CreateRecording(Recording& recording, VkCommandBufferLevel level);
+    // Releases everything recorded since the last reset. The recording's last submission must have completed.
+    void ResetRecording(Recording& recording);
+    void DestroyRecording(Recording& recording);
+    // The command list the calling thread is recording, or the current frame's primary recording.
+    Recording& GetRecording();
+    // Records that the buffer is used by the current frame, so that it isn't overwritten or freed while the GPU reads it.
+    void TrackBufferUse(VkBuffer buffer);
+    // Returns whether a submitted frame, or the frame being recorded, binds the buffer.
+    bool IsBufferInUse(VkBuffer buffer);
+    // The copy of a streaming buffer that commands bind in its place. See bufferCopies.
+    VkBuffer GetBufferCopy(VkBuffer buffer);
+    // Makes a copy of the streaming buffer that no frame binds the current one, and returns it. The rest of the contents
+    // are carried over from the previous copy, unless size bytes at offset are all of them.
+    VkBuffer GetWritableBufferCopy(VkBuffer buffer, size_t offset, size_t size);
+    // The start of the buffer's mapping, or nullptr if it isn't host visible. bufferResourcesMutex must be held.
+    void* GetMappedData(VkBuffer buffer);
+    // Begins the render pass set by SetRenderAttachments() in the primary command buffer, or ends and begins it again if it
+    // was begun with different contents.
+    void BeginRenderPass(VkSubpassContents contents);
+    // Blocks until the submission with this index, and therefore every earlier one, has completed on the GPU.
+    void WaitForSubmission(uint64_t submissionIndex);
+    // Returns whether the submission with this index has completed, without waiting.
+    bool IsSubmissionComplete(uint64_t submissionIndex);
+    void ClearDescriptorSetCaches();
+    // Replaces pipelineCache with a new cache seeded with initialData, which may be empty.
+    void CreatePipelineCache(const std::vector<char>& initialData);
+
+    // A large VkDeviceMemory that buffers are sub-allocated from. Host visible blocks stay mapped for their whole lifetime.
+    struct MemoryBlock {
+        VkDeviceMemory memory;
+        uint32_t memoryTypeIndex;
+        VkDeviceSize size;
+        void* mappedData;
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;  // Offset to size, ordered so that neighbouring ranges can be merged.
+        size_t allocationCount;
+    };
+    struct MemoryAllocation {
+        MemoryBlock* block;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+    MemoryAllocation AllocateMemory(const VkMemoryRequirements& memoryRequirements, VkMemoryPropertyFlags properties);
+    bool SubAllocateMemory(MemoryBlock& block, const VkMemoryRequirements& memoryRequirements, MemoryAllocation& allocation);
+    void FreeMemory(const MemoryAllocation& allocation);
+
+    // Static buffers live in device-local memory, which the CPU can't map on discrete GPUs. Their data is copied into
+    // stagingBuffer, a persistently mapped ring, and the copies are recorded into an upload batch that is submitted before the
+    // next frame, or earlier if the ring fills up.
+    void CreateUploadResources(const std::vector<VkQueueFamilyProperties>& queueFamilyProperties, bool timelineSemaphoreEnabled);
+    void StageBufferData(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data);
+    // Returns the offset of size bytes in the staging ring, waiting for earlier uploads to complete if it is full.
+    VkDeviceSize AllocateStagingSpace(VkDeviceSize size);
+    void RecordUploadCopy(VkBuffer buffer, const VkBufferCopy& region);
+    void FlushUploads();
+    // Blocks until the upload batch with this index, and every earlier one, has completed. Flushes it first if needed.
+    void WaitForUploads(uint64_t uploadIndex);
+    // Recycles the upload batches that have completed, so that their staging space can be reused.
+    void ReclaimUploads();
+    struct UploadBatch;
+    bool IsUploadComplete(const UploadBatch& batch);
+    void DestroyUploadBatch(UploadBatch& batch);
+
+    VkDescriptorPool CreateDescriptorPool();
+    VkDescriptorSet AllocateDescriptorSet(Recording& recording, VkDescriptorSetLayout descSetLayout);
+
+    // Removes any cached framebuffers created with renderPass or using imageView. Pass VK_NULL_HANDLE to ignore either.
+    void EvictFramebuffers(VkRenderPass renderPass, VkImageView imageView);
+
 private:
     VkInstance instance{};
     VkPhysicalDevice physicalDevice{};
@@ -93,11 +217,6 @@ private:
     uint32_t queueFamilyIndex = 0xFFFFFFFF;
     uint32_t queueIndex = 0xFFFFFFFF;
     VkQueue queue{};
-    VkFence fence{};
-
-    VkCommandPool cmdPool{};
-    VkCommandBuffer cmdBuffer{};
-    VkDescriptorPool descriptorPool;
 
     std::vector<const char*> activeInstanceLayers{};
     std::vector<const char*> activeInstanceExtensions{};
@@ -122,17 +241,137 @@ private:
     std::unordered_map<VkImage, std::pair<VkDeviceMemory, ImageCreateInfo>> imageResources;
     std::unordered_map<VkImageView, ImageViewCreateInfo> imageViewResources;
     
-    std::unordered_map<VkBuffer, std::pair<VkDeviceMemory, BufferCreateInfo>> bufferResources;
+    // Blocks are only freed when empty, except for the last block of each memory type which is kept for reuse.
+    // Allocations larger than memoryBlockSize get a block of their own.
+    std::list<MemoryBlock> memoryBlocks;
+    const VkDeviceSize memoryBlockSize = 16 * 1024 * 1024;
+    std::unordered_map<VkBuffer, std::pair<MemoryAllocation, BufferCreateInfo>> bufferResources;
+    // Command lists look up buffers while a transient uniform page may be created on another thread.
+    std::mutex bufferResourcesMutex;
 
     std::unordered_map<VkShaderModule, ShaderCreateInfo> shaderResources;
     std::unordered_map<VkPipeline, std::tuple<VkPipelineLayout, VkDescriptorSetLayout, VkRenderPass, PipelineCreateInfo>> pipelineResources;
 
-    std::unordered_map<VkCommandBuffer, std::vector<VkFramebuffer>> cmdBufferFramebuffers;
+    // A command buffer and the state kept while recording it. Each recording has its own command and descriptor pools,
+    // so that threads recording different command lists never share a pool.
+    struct Recording {
+        VkCommandPool cmdPool{};
+        VkCommandBuffer cmdBuffer{};
+        // Descriptor sets are linearly allocated from these pools and reset all at once when the frame is reused.
+        // An additional pool is created when the current one is exhausted.
+        std::vector<VkDescriptorPool> descriptorPools;
+        size_t descriptorPoolIndex = 0;
+        // Descriptor sets allocated since the last reset, keyed by the set layout and the bound resources.
+        std::unordered_map<std::vector<uint64_t>, VkDescriptorSet, KeyHash> descriptorSetCache;
+        VkPipeline setPipeline = VK_NULL_HANDLE;
+        std::vector<std::tuple<VkWriteDescriptorSet, VkDescriptorBufferInfo, VkDescriptorImageInfo>> writeDescSets;
+        // Buffers bound by a command list, added to bufferSubmissionIndices by ExecuteCommandLists() on the rendering thread.
+        std::vector<VkBuffer> boundBuffers;
+        RecordingState recordingState;  // Only used by command lists. The primary recording uses the base class's.
+    };
+
+    // Everything needed to record and submit one frame. BeginRendering() moves on to the next frame, and only waits
+    // if that frame's previous submission is still executing on the GPU.
+    struct Frame {
+        VkFence fence{};
+        uint64_t submissionIndex = 0;
+        Recording primary;
+        // The command lists handed out since BeginRendering() are the first commandListCount. The rest are kept for reuse.
+        // A deque, so that adding one doesn't move those being recorded on other threads.
+        std::deque<Recording> commandLists;
+        size_t commandListCount = 0;
+    };
+    static const uint32_t defaultFramesInFlight = 2;
+    std::vector<Frame> frames;
+    size_t frameIndex = 0;
+    VkCommandBuffer cmdBuffer{};  // The current frame's primary command buffer.
+    std::mutex commandListMutex;  // Guards the current frame's commandLists.
+    static thread_local Recording* threadCommandList;
+
+    // Submissions are numbered from 1. Every submission up to completedSubmissionCount is known to have finished.
+    uint64_t submissionCount = 0;
+    uint64_t completedSubmissionCount = 0;
+    // The last submission that bound each buffer, so that SetBufferData() only waits when the buffer is still in use.
+    std::unordered_map<VkBuffer, uint64_t> bufferSubmissionIndices;
+    // SetBufferData() doesn't wait for the frames that read a streaming buffer. It writes another copy of the buffer instead,
+    // created on first use, and commands recorded from then on bind that copy in its place. A buffer has at most one copy
+    // per frame in flight, plus one for the frame being recorded. Guarded by bufferResourcesMutex.
+    struct BufferCopies {
+        std::vector<VkBuffer> copies;  // copies[0] is the buffer itself.
+        size_t current = 0;
+    };
+    std::unordered_map<VkBuffer, BufferCopies> bufferCopies;
+
+    // Framebuffers keyed by render pass, extent and attachment views. The list is ordered from most to least recently used,
+    // and the least recently used framebuffer is evicted once there are more than maxCachedFramebuffers.
+    typedef std::list<std::pair<std::vector<uint64_t>, VkFramebuffer>> FramebufferList;
+    FramebufferList framebufferLRU;
+    std::unordered_map<std::vector<uint64_t>, FramebufferList::iterator, KeyHash> framebufferCache;
+    const size_t maxCachedFramebuffers = 32;
+    // Evicted framebuffers, destroyed once the submission they were evicted during has completed.
+    std::vector<std::pair<uint64_t, VkFramebuffer>> framebuffersToDestroy;
+    // The render pass and framebuffer of the current render attachments. The render pass is begun by the first draw, or by
+    // ExecuteCommandLists(), as a render pass that executes command lists can't also record draws directly.
+    VkRenderPassBeginInfo renderPassBegin{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
     bool inRenderPass = false;
+    VkSubpassContents renderPassContents = VK_SUBPASS_CONTENTS_INLINE;
+    // The rendering thread's viewports and scissors, which command lists start with.
+    std::vector<VkViewport> currentViewports;
+    std::vector<VkRect2D> currentScissors;
+
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+    // Memory for static buffers: device-local, and also host visible on integrated GPUs, where it is written in place.
+    VkMemoryPropertyFlags staticBufferMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    // A transfer-only queue, used when the device has one and timeline semaphores are available to order frames after the
+    // uploads they read. Otherwise, uploads are submitted to the graphics queue.
+    uint32_t uploadQueueFamilyIndex = 0xFFFFFFFF;
+    VkQueue uploadQueue{};
+    // A timeline semaphore that each upload batch signals with its index. VK_NULL_HANDLE if unsupported, in which case each
+    // batch has a fence.
+    VkSemaphore uploadSemaphore = VK_NULL_HANDLE;
+    PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR = nullptr;
+    PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR = nullptr;
+
+    VkBuffer stagingBuffer = VK_NULL_HANDLE;  // Created on first use.
+    MemoryAllocation stagingAllocation{};
+    uint8_t* stagingData = nullptr;
+    const VkDeviceSize stagingBufferSize = 8 * 1024 * 1024;
+    VkDeviceSize stagingHead = 0;  // Where the next allocation starts, unless it must wrap around to 0.
+
+    struct UploadBatch {
+        VkCommandPool cmdPool{};
+        VkCommandBuffer cmdBuffer{};
+        VkFence fence{};  // Only without uploadSemaphore.
+        uint64_t uploadIndex = 0;
+        VkDeviceSize stagingBegin = 0;  // The batch's staging data runs from here to the next batch's stagingBegin.
+        size_t copyCount = 0;
+    };
+    UploadBatch currentUpload;               // Recorded since the last flush.
+    std::deque<UploadBatch> pendingUploads;  // Submitted, oldest first.
+    std::vector<UploadBatch> freeUploads;
+    // Upload batches are numbered from 1. Every batch up to completedUploadCount is known to have finished.
+    uint64_t uploadCount = 0;
+    uint64_t completedUploadCount = 0;
+    uint64_t frameWaitedUploadCount = 0;  // The last batch a frame submission waited for on the graphics queue.
+    // The last upload batch that copies into each buffer, so that DestroyBuffer() waits for it.
+    std::unordered_map<VkBuffer, uint64_t> bufferUploadIndices;
+
+    bool multiviewSupported = false;
+    // The render passes of pipelines with a viewMask.
+    std::unordered_set<VkRenderPass> multiviewRenderPasses;
 
-    VkPipeline setPipeline = VK_NULL_HANDLE;
-    std::unordered_map<VkCommandBuffer, std::vector<VkDescriptorSet>> cmdBufferDescriptorSets;
-    std::vector<std::tuple<VkWriteDescriptorSet, VkDescriptorBufferInfo, VkDescriptorImageInfo>> writeDescSets;
+    // Timestamp queries, created on first use. A query must be reset before each write, so released queries wait in
+    // timestampQueriesToReset until the next point outside a render pass, and are then moved to freeTimestampQueries.
+    VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
+    bool timestampsSupported = true;
+    double timestampPeriod = 1.0;  // Nanoseconds per tick.
+    uint64_t timestampMask = ~0ull;
+    std::vector<uint32_t> timestampQueriesToReset;
+    std::vector<uint32_t> freeTimestampQueries;
+    std::vector<uint64_t> timestampQuerySubmissions;  // The submission each query was last written in.
+    // Two per scope, so that the scopes the base class keeps pending can't use up the pool.
+    const uint32_t maxTimestampQueries = static_cast<uint32_t>(2 * maxPendingTimestampScopes);
 
 };
 #endif
\ No newline at end of file
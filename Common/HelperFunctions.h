@@ -8,12 +8,21 @@
 
 // C/C++ Headers
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // Debugbreak
@@ -46,6 +55,34 @@ T Align(T value, T alignment) {
     return (value + (alignment - 1)) & ~(alignment - 1);
 };
 
+// Mixes the hash of value into seed. Same as boost::hash_combine.
+template <typename T>
+inline void HashCombine(size_t &seed, const T &value) {
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// Hashes cache keys made up of API handles and values.
+struct KeyHash {
+    size_t operator()(const std::vector<uint64_t> &key) const {
+        size_t seed = key.size();
+        for (const uint64_t &value : key) {
+            HashCombine(seed, value);
+        }
+        return seed;
+    }
+};
+
+// 64-bit FNV-1a hash of a block of memory. Unlike std::hash, the result is the same across runs and builds,
+// so it can be used as a key in data written to disk.
+inline uint64_t HashBytes(const void *data, size_t size, uint64_t seed = 0xcbf29ce484222325ull) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++) {
+        seed ^= bytes[i];
+        seed *= 0x100000001b3ull;
+    }
+    return seed;
+}
+
 inline std::string GetEnv(const std::string &variable) {
     const char *value = std::getenv(variable.c_str());
     // It's invalid to assign nullptr to std::string
@@ -67,11 +104,14 @@ inline std::string ReadTextFile(const std::string &filepath) {
         std::cout << "Could not read file " << filepath.c_str() << ". File does not exist." << std::endl;
         return "";
     }
-    std::string line;
-    while (!stream.eof()) {
-        std::getline(stream, line);
-        output.append(line + "\n");
-    }
+    // Read the whole file at once, rather than appending it line by line.
+    stream.seekg(0, std::fstream::end);
+    output.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0, std::fstream::beg);
+    stream.read(&output[0], static_cast<std::streamsize>(output.size()));
+    // In text mode, line endings may be translated, so fewer characters than the file's size can be read. Drop the rest,
+    // as the string is passed on with its size rather than null terminated.
+    output.resize(static_cast<size_t>(stream.gcount()));
     stream.close();
     return output;
 }
@@ -90,6 +130,17 @@ inline std::vector<char> ReadBinaryFile(const std::string &filepath) {
     return output;
 }
 
+inline bool WriteBinaryFile(const std::string &filepath, const std::vector<char> &data) {
+    std::ofstream stream(filepath, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    if (!stream.is_open()) {
+        std::cout << "Could not write file " << filepath.c_str() << "." << std::endl;
+        return false;
+    }
+    stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    stream.close();
+    return !stream.fail();
+}
+
 #if defined(__ANDROID__)
 // XR_DOCS_TAG_BEGIN_ReadFiles_Android
 #include <android/asset_manager.h>
@@ -0,0 +1,203 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <JobSystem.h>
+
+// The JobSystem that the current thread is a worker of, if any, and the index of its queue.
+static thread_local const JobSystem *threadJobSystem = nullptr;
+static thread_local size_t threadQueueIndex = 0;
+
+JobSystem::TaskGraph::TaskId JobSystem::TaskGraph::AddTask(std::function<void()> function, std::initializer_list<TaskId> dependencies) {
+    const TaskId taskId = tasks.size();
+    tasks.emplace_back();
+    Task &task = tasks.back();
+    task.function = std::move(function);
+    for (TaskId dependency : dependencies) {
+        if (dependency >= taskId) {
+            std::cout << "ERROR: JobSystem::TaskGraph: Task " << taskId << " depends on task " << dependency << ", which has not been added yet." << std::endl;
+            DEBUG_BREAK;
+            continue;
+        }
+        tasks[dependency].dependents.push_back(taskId);
+        task.dependencyCount++;
+    }
+    return taskId;
+}
+
+JobSystem::JobSystem(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    queueCount = threadCount;
+    queues.reset(new Queue[queueCount]);
+    workers.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        exit = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::Run(TaskGraph &graph) {
+    if (graph.tasks.empty()) {
+        return;
+    }
+    graph.jobSystem = this;
+    graph.remainingTaskCount.store(graph.tasks.size(), std::memory_order_relaxed);
+    for (TaskGraph::Task &task : graph.tasks) {
+        task.remainingDependencyCount.store(task.dependencyCount, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < graph.tasks.size(); i++) {
+        if (graph.tasks[i].dependencyCount == 0) {
+            Push({&JobSystem::RunTask, &graph, i});
+        }
+    }
+    Wait(graph.remainingTaskCount);
+}
+
+void JobSystem::RunTask(void *context, size_t index) {
+    TaskGraph &graph = *reinterpret_cast<TaskGraph *>(context);
+    TaskGraph::Task &task = graph.tasks[index];
+    if (task.function) {
+        task.function();
+    }
+    for (TaskGraph::TaskId dependent : task.dependents) {
+        if (graph.tasks[dependent].remainingDependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            graph.jobSystem->Push({&JobSystem::RunTask, &graph, dependent});
+        }
+    }
+    // The graph may be destroyed as soon as the last task is counted, so this must be the last access to it.
+    graph.remainingTaskCount.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+namespace {
+struct ParallelForState {
+    const std::function<void(size_t, size_t)> *function;
+    size_t count;
+    size_t grainSize;
+    std::atomic<size_t> nextBegin{0};
+    std::atomic<size_t> remainingHelperCount{0};
+};
+
+void RunParallelForRanges(ParallelForState &state) {
+    for (size_t begin = state.nextBegin.fetch_add(state.grainSize); begin < state.count; begin = state.nextBegin.fetch_add(state.grainSize)) {
+        (*state.function)(begin, std::min(begin + state.grainSize, state.count));
+    }
+}
+}  // namespace
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)> &function) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t rangeCount = (count + grainSize - 1) / grainSize;
+    if (rangeCount == 1 || workers.empty()) {
+        for (size_t begin = 0; begin < count; begin += grainSize) {
+            function(begin, std::min(begin + grainSize, count));
+        }
+        return;
+    }
+
+    // Helpers and the calling thread take ranges from a shared counter, so that the ranges are balanced between however many
+    // threads turn up. The caller must wait for every helper to have run, even one that finds no range left, as they all
+    // reference the state on this stack.
+    ParallelForState state;
+    state.function = &function;
+    state.count = count;
+    state.grainSize = grainSize;
+    const size_t helperCount = std::min(rangeCount - 1, workers.size());
+    state.remainingHelperCount.store(helperCount, std::memory_order_relaxed);
+    for (size_t i = 0; i < helperCount; i++) {
+        Push({&JobSystem::RunParallelFor, &state, i});
+    }
+    RunParallelForRanges(state);
+    Wait(state.remainingHelperCount);
+}
+
+void JobSystem::RunParallelFor(void *context, size_t /*index*/) {
+    ParallelForState &state = *reinterpret_cast<ParallelForState *>(context);
+    RunParallelForRanges(state);
+    state.remainingHelperCount.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Push(const Job &job) {
+    Queue &queue = queues[threadJobSystem == this ? threadQueueIndex : 0];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    queuedJobCount.fetch_add(1);
+    // Taking the lock orders this with a worker that has just checked queuedJobCount and is about to sleep.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+bool JobSystem::TryPop(Job &job) {
+    const size_t ownQueueIndex = threadJobSystem == this ? threadQueueIndex : 0;
+    {
+        Queue &queue = queues[ownQueueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            queuedJobCount.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queueCount; i++) {
+        Queue &queue = queues[(ownQueueIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            queuedJobCount.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::RunOne() {
+    Job job;
+    if (!TryPop(job)) {
+        return false;
+    }
+    job.function(job.context, job.index);
+    return true;
+}
+
+void JobSystem::Wait(const std::atomic<size_t> &counter) {
+    while (counter.load(std::memory_order_acquire) != 0) {
+        if (!RunOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WorkerLoop(size_t queueIndex) {
+    threadJobSystem = this;
+    threadQueueIndex = queueIndex;
+    while (true) {
+        if (RunOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return exit || queuedJobCount.load() != 0; });
+        if (exit) {
+            break;
+        }
+    }
+}
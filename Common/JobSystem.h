@@ -0,0 +1,91 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+// A work-stealing thread pool. Each worker thread has its own queue of jobs: it takes the newest job from its own queue, and
+// when that is empty, steals the oldest job from another thread's queue. Threads outside the pool add their jobs to a shared
+// queue. A thread that waits for jobs, in Run() or ParallelFor(), runs queued jobs until they are done, so jobs may wait on
+// other jobs without deadlocking the pool.
+class JobSystem {
+public:
+    // A set of tasks with dependencies between them, such as the work of one frame. Build it once and Run() it each frame,
+    // or Clear() and rebuild it. A task starts once all of the tasks it depends on have finished.
+    class TaskGraph {
+    public:
+        typedef size_t TaskId;
+        // The dependencies must have been added before this task.
+        TaskId AddTask(std::function<void()> function, std::initializer_list<TaskId> dependencies = {});
+        size_t GetTaskCount() const { return tasks.size(); }
+        void Clear() { tasks.clear(); }
+
+    private:
+        friend class JobSystem;
+        struct Task {
+            std::function<void()> function;
+            std::vector<TaskId> dependents;
+            size_t dependencyCount = 0;
+            std::atomic<size_t> remainingDependencyCount{0};
+        };
+        // A deque, as a Task can't be moved while the pool may be reading it.
+        std::deque<Task> tasks;
+        std::atomic<size_t> remainingTaskCount{0};
+        JobSystem *jobSystem = nullptr;
+    };
+
+    // threadCount includes the thread that calls Run() and ParallelFor(), so 1 runs everything on that thread.
+    // 0 uses one thread per core.
+    explicit JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    size_t GetThreadCount() const { return workers.size() + 1; }
+
+    // Runs the graph's tasks on the pool and returns once they have all finished. The graph must not be changed meanwhile.
+    void Run(TaskGraph &graph);
+
+    // Calls function(begin, end) for consecutive ranges of at most grainSize indices that together cover [0, count), in any
+    // order and on any thread, and returns once they have all finished.
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)> &function);
+
+private:
+    // A queued job: function(context, index). POD, so that queueing a job never allocates memory for a closure.
+    struct Job {
+        void (*function)(void *context, size_t index);
+        void *context;
+        size_t index;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void Push(const Job &job);
+    bool TryPop(Job &job);
+    // Runs one queued job, if there is one, and returns whether it did.
+    bool RunOne();
+    // Runs queued jobs until counter reaches 0.
+    void Wait(const std::atomic<size_t> &counter);
+    void WorkerLoop(size_t queueIndex);
+
+    static void RunTask(void *context, size_t index);
+    static void RunParallelFor(void *context, size_t index);
+
+    std::vector<std::thread> workers;
+    // queues[0] is shared by the threads outside the pool, and queues[i] belongs to workers[i - 1].
+    std::unique_ptr<Queue[]> queues;
+    size_t queueCount = 0;
+
+    // Workers sleep while there are no queued jobs.
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queuedJobCount{0};
+    bool exit = false;
+};
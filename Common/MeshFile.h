@@ -0,0 +1,143 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FileView.h>
+
+#include <cmath>
+
+// A compact binary mesh (.xrmesh), written offline by the MeshConverter tool. The file is laid out so that its vertex and
+// index data can be passed straight from a FileView to GraphicsAPI::CreateBuffer():
+//   MeshFileHeader
+//   MeshVertex[vertexCount]                 at verticesOffset
+//   uint16_t or uint32_t[indexCount]        at indicesOffset, a triangle list
+//   MeshMeshlet[meshletCount]               at meshletsOffset
+// Each section starts on a 16-byte boundary. All values are little-endian.
+
+static const uint32_t meshFileMagic = 0x534D5258;  // "XRMS"
+static const uint32_t meshFileVersion = 1;
+
+struct MeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t vertexStride;  // sizeof(MeshVertex)
+    uint32_t indexCount;
+    uint32_t indexStride;  // 2 or 4
+    uint32_t meshletCount;
+    uint32_t reserved;
+    // A position decodes as center + position * halfExtent, in the units of the source mesh.
+    float center[3];
+    float halfExtent[3];
+    uint64_t verticesOffset;
+    uint64_t indicesOffset;
+    uint64_t meshletsOffset;
+};
+
+// An interleaved, quantized vertex: 12 bytes rather than the 24 of float positions and normals.
+struct MeshVertex {
+    int16_t position[4];  // Signed normalized within the mesh's bounds. w is always 1.0.
+    int8_t normal[4];     // Signed normalized unit vector. w is always 0.0.
+};
+
+// A run of at most meshletMaxTriangles triangles that use at most meshletMaxVertices vertices, with its bounds, so that
+// parts of a large mesh can be culled on their own.
+struct MeshMeshlet {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    // Bounds in the units of the source mesh.
+    float mins[3];
+    float maxs[3];
+};
+static const uint32_t meshletMaxVertices = 64;
+static const uint32_t meshletMaxTriangles = 124;
+
+inline int16_t EncodeSnorm16(float value) {
+    return static_cast<int16_t>(std::round(std::max(-1.0f, std::min(value, 1.0f)) * 32767.0f));
+}
+
+inline int8_t EncodeSnorm8(float value) {
+    return static_cast<int8_t>(std::round(std::max(-1.0f, std::min(value, 1.0f)) * 127.0f));
+}
+
+// Quantizes a position within the bounds given by center and halfExtent, and a unit normal.
+inline MeshVertex EncodeMeshVertex(const float position[3], const float normal[3], const float center[3], const float halfExtent[3]) {
+    MeshVertex vertex;
+    for (int i = 0; i < 3; i++) {
+        vertex.position[i] = EncodeSnorm16(halfExtent[i] > 0.0f ? (position[i] - center[i]) / halfExtent[i] : 0.0f);
+        vertex.normal[i] = EncodeSnorm8(normal[i]);
+    }
+    vertex.position[3] = 32767;
+    vertex.normal[3] = 0;
+    return vertex;
+}
+
+// Returns whether every index is less than vertexCount and every meshlet lies within the index data. The vertex and index
+// buffers are created straight from the file, so a mesh that fails this would read out of bounds on the GPU.
+inline bool CheckMeshIndices(const void *indices, uint32_t indexStride, uint32_t indexCount, uint32_t vertexCount, const MeshMeshlet *meshlets, uint32_t meshletCount) {
+    for (uint32_t i = 0; i < indexCount; i++) {
+        const uint32_t index = indexStride == 2 ? reinterpret_cast<const uint16_t *>(indices)[i] : reinterpret_cast<const uint32_t *>(indices)[i];
+        if (index >= vertexCount) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < meshletCount; i++) {
+        if (uint64_t(meshlets[i].firstIndex) + meshlets[i].indexCount > indexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A .xrmesh file, read in place from its FileView. The pointers are valid while the MeshFile lives.
+class MeshFile {
+public:
+    MeshFile() = default;
+    explicit MeshFile(FileView &&file)
+        : fileView(std::move(file)) {
+        if (!fileView.IsOpen()) {
+            return;
+        }
+        if (fileView.GetSize() < sizeof(MeshFileHeader)) {
+            std::cout << "ERROR: MeshFile: File is too small to be a mesh." << std::endl;
+            return;
+        }
+        memcpy(&header, fileView.GetData(), sizeof(header));
+        if (header.magic != meshFileMagic || header.version != meshFileVersion || header.vertexStride != sizeof(MeshVertex) || (header.indexStride != 2 && header.indexStride != 4)) {
+            std::cout << "ERROR: MeshFile: Not a mesh file, or written by a different version of MeshConverter." << std::endl;
+            return;
+        }
+        if (!SectionFits(header.verticesOffset, uint64_t(header.vertexCount) * header.vertexStride)
+            || !SectionFits(header.indicesOffset, uint64_t(header.indexCount) * header.indexStride)
+            || !SectionFits(header.meshletsOffset, uint64_t(header.meshletCount) * sizeof(MeshMeshlet))) {
+            std::cout << "ERROR: MeshFile: File is truncated." << std::endl;
+            return;
+        }
+        if (!CheckMeshIndices(GetIndices(), header.indexStride, header.indexCount, header.vertexCount, GetMeshlets(), header.meshletCount)) {
+            std::cout << "ERROR: MeshFile: An index is out of range of the vertices, or a meshlet of the indices." << std::endl;
+            return;
+        }
+        valid = true;
+    }
+
+    bool IsValid() const { return valid; }
+    const MeshFileHeader &GetHeader() const { return header; }
+
+    const MeshVertex *GetVertices() const { return reinterpret_cast<const MeshVertex *>(fileView.GetData() + header.verticesOffset); }
+    size_t GetVerticesSize() const { return size_t(header.vertexCount) * header.vertexStride; }
+    const void *GetIndices() const { return fileView.GetData() + header.indicesOffset; }
+    size_t GetIndicesSize() const { return size_t(header.indexCount) * header.indexStride; }
+    const MeshMeshlet *GetMeshlets() const { return reinterpret_cast<const MeshMeshlet *>(fileView.GetData() + header.meshletsOffset); }
+
+private:
+    bool SectionFits(uint64_t offset, uint64_t size) const {
+        return offset % 16 == 0 && offset <= fileView.GetSize() && size <= fileView.GetSize() - offset;
+    }
+
+    FileView fileView;
+    MeshFileHeader header = {};
+    bool valid = false;
+};
@@ -58,6 +58,7 @@ XrVector3f
 XrVector4f
 XrQuaternionf
 XrMatrix4x4f
+XrTransformArraysf
 
 inline static void XrVector3f_Set(XrVector3f* v, const float value);
 inline static void XrVector3f_Add(XrVector3f* result, const XrVector3f* a, const XrVector3f* b);
@@ -80,6 +81,10 @@ inline static void XrMatrix4x4f_CreateRotation(XrMatrix4x4f* result, const float
 inline static void XrMatrix4x4f_CreateScale(XrMatrix4x4f* result, const float x, const float y, const float z);
 inline static void XrMatrix4x4f_CreateTranslationRotationScale(XrMatrix4x4f* result, const XrVector3f* translation,
                                                                const XrQuaternionf* rotation, const XrVector3f* scale);
+inline static void XrMatrix4x4f_CreateTranslationRotationScale_Batch(XrMatrix4x4f* results, size_t resultStride,
+                                                                     const XrTransformArraysf* transforms, size_t count);
+inline static void XrMatrix4x4f_CreateModelViewProjection_Batch(XrMatrix4x4f* results, size_t resultStride, const XrMatrix4x4f* viewProjs,
+                                                                size_t viewCount, const XrTransformArraysf* transforms, size_t count);
 inline static void XrMatrix4x4f_CreateProjection(XrMatrix4x4f* result, const float tanAngleLeft, const float tanAngleRight,
                                                  const float tanAngleUp, float const tanAngleDown, const float nearZ,
                                                  const float farZ);
@@ -111,12 +116,45 @@ inline static void XrMatrix4x4f_TransformBounds(XrVector3f* resultMins, XrVector
                                                 const XrVector3f* mins, const XrVector3f* maxs);
 inline static bool XrMatrix4x4f_CullBounds(const XrMatrix4x4f* mvp, const XrVector3f* mins, const XrVector3f* maxs);
 
+SIMD
+====
+
+XrMatrix4x4f_Multiply, XrMatrix4x4f_CreateTranslationRotationScale, XrMatrix4x4f_InvertRigidBody and
+XrMatrix4x4f_TransformBounds use SSE or NEON when the compiler targets them. Define XR_LINEAR_NO_SIMD to
+always use the scalar code. The scalar versions stay available with a _Scalar suffix as the reference.
+The SIMD versions multiply and add in the same order as the scalar ones, without fused multiply-add, so
+they agree bit for bit unless the compiler contracts the scalar code into FMAs. The exception is
+XrMatrix4x4f_CreateTranslationRotationScale, which may differ in the sign of zero elements, and, given an
+infinite or NaN input, in the elements where the scalar version multiplies it by zero.
+Tests/LinearAlgebraTest.cpp checks this and times both versions.
+
+BATCHES
+=======
+
+The _Batch functions take their transforms as an XrTransformArraysf, which holds separate x, y, z (and w)
+arrays, and compute four transforms at a time in SIMD registers without shuffling them in and out of
+XrPosef-like structs. Results are written resultStride bytes apart, or packed if resultStride is 0, so
+they can be written straight into interleaved per-instance data or a mapped uniform buffer.
+XrMatrix4x4f_CreateModelViewProjection_Batch writes viewProjs[v] * model(i) to result v * count + i.
+They agree with XrMatrix4x4f_CreateTranslationRotationScale and XrMatrix4x4f_Multiply up to the sign of zeros.
+
 ================================================================================================
 */
 
 #include <assert.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+#if !defined(XR_LINEAR_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XR_LINEAR_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define XR_LINEAR_NEON
+#include <arm_neon.h>
+#endif
+#endif
 
 #define MATH_PI 3.14159265358979323846f
 
@@ -139,6 +177,13 @@ typedef struct XrMatrix4x4f {
     float m[16];
 } XrMatrix4x4f;
 
+// Structure-of-arrays transforms for the _Batch functions. Transform i is made of element i of each array.
+typedef struct XrTransformArraysf {
+    const float* translation[3];  // x, y, z
+    const float* rotation[4];     // Quaternion x, y, z, w
+    const float* scale[3];        // x, y, z
+} XrTransformArraysf;
+
 inline static float XrRcpSqrt(const float x) {
     const float SMALLEST_NON_DENORMAL = 1.1754943508222875e-038f;  // ( 1U << 23 )
     const float rcp = (x >= SMALLEST_NON_DENORMAL) ? 1.0f / sqrtf(x) : 1.0f;
@@ -245,7 +290,7 @@ inline static void XrQuaternionf_Multiply(XrQuaternionf* result, const XrQuatern
 }
 
 // Use left-multiplication to accumulate transformations.
-inline static void XrMatrix4x4f_Multiply(XrMatrix4x4f* result, const XrMatrix4x4f* a, const XrMatrix4x4f* b) {
+inline static void XrMatrix4x4f_Multiply_Scalar(XrMatrix4x4f* result, const XrMatrix4x4f* a, const XrMatrix4x4f* b) {
     result->m[0] = a->m[0] * b->m[0] + a->m[4] * b->m[1] + a->m[8] * b->m[2] + a->m[12] * b->m[3];
     result->m[1] = a->m[1] * b->m[0] + a->m[5] * b->m[1] + a->m[9] * b->m[2] + a->m[13] * b->m[3];
     result->m[2] = a->m[2] * b->m[0] + a->m[6] * b->m[1] + a->m[10] * b->m[2] + a->m[14] * b->m[3];
@@ -267,6 +312,46 @@ inline static void XrMatrix4x4f_Multiply(XrMatrix4x4f* result, const XrMatrix4x4
     result->m[15] = a->m[3] * b->m[12] + a->m[7] * b->m[13] + a->m[11] * b->m[14] + a->m[15] * b->m[15];
 }
 
+inline static void XrMatrix4x4f_Multiply(XrMatrix4x4f* result, const XrMatrix4x4f* a, const XrMatrix4x4f* b) {
+#if defined(XR_LINEAR_SSE)
+    // Each column of the result is the columns of 'a' weighted by the matching column of 'b'.
+    const __m128 a0 = _mm_loadu_ps(&a->m[0]);
+    const __m128 a1 = _mm_loadu_ps(&a->m[4]);
+    const __m128 a2 = _mm_loadu_ps(&a->m[8]);
+    const __m128 a3 = _mm_loadu_ps(&a->m[12]);
+    __m128 columns[4];
+    for (int i = 0; i < 4; i++) {
+        const __m128 x = _mm_mul_ps(a0, _mm_set1_ps(b->m[4 * i + 0]));
+        const __m128 y = _mm_mul_ps(a1, _mm_set1_ps(b->m[4 * i + 1]));
+        const __m128 z = _mm_mul_ps(a2, _mm_set1_ps(b->m[4 * i + 2]));
+        const __m128 w = _mm_mul_ps(a3, _mm_set1_ps(b->m[4 * i + 3]));
+        columns[i] = _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), w);
+    }
+    // Stored after all of 'b' has been read, so that 'result' may alias 'a' or 'b'.
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_ps(&result->m[4 * i], columns[i]);
+    }
+#elif defined(XR_LINEAR_NEON)
+    const float32x4_t a0 = vld1q_f32(&a->m[0]);
+    const float32x4_t a1 = vld1q_f32(&a->m[4]);
+    const float32x4_t a2 = vld1q_f32(&a->m[8]);
+    const float32x4_t a3 = vld1q_f32(&a->m[12]);
+    float32x4_t columns[4];
+    for (int i = 0; i < 4; i++) {
+        const float32x4_t x = vmulq_n_f32(a0, b->m[4 * i + 0]);
+        const float32x4_t y = vmulq_n_f32(a1, b->m[4 * i + 1]);
+        const float32x4_t z = vmulq_n_f32(a2, b->m[4 * i + 2]);
+        const float32x4_t w = vmulq_n_f32(a3, b->m[4 * i + 3]);
+        columns[i] = vaddq_f32(vaddq_f32(vaddq_f32(x, y), z), w);
+    }
+    for (int i = 0; i < 4; i++) {
+        vst1q_f32(&result->m[4 * i], columns[i]);
+    }
+#else
+    XrMatrix4x4f_Multiply_Scalar(result, a, b);
+#endif
+}
+
 // Creates the transpose of the given matrix.
 inline static void XrMatrix4x4f_Transpose(XrMatrix4x4f* result, const XrMatrix4x4f* src) {
     result->m[0] = src->m[0];
@@ -325,7 +410,7 @@ inline static void XrMatrix4x4f_Invert(XrMatrix4x4f* result, const XrMatrix4x4f*
 }
 
 // Calculates the inverse of a rigid body transform.
-inline static void XrMatrix4x4f_InvertRigidBody(XrMatrix4x4f* result, const XrMatrix4x4f* src) {
+inline static void XrMatrix4x4f_InvertRigidBody_Scalar(XrMatrix4x4f* result, const XrMatrix4x4f* src) {
     result->m[0] = src->m[0];
     result->m[1] = src->m[4];
     result->m[2] = src->m[8];
@@ -344,6 +429,43 @@ inline static void XrMatrix4x4f_InvertRigidBody(XrMatrix4x4f* result, const XrMa
     result->m[15] = 1.0f;
 }
 
+inline static void XrMatrix4x4f_InvertRigidBody(XrMatrix4x4f* result, const XrMatrix4x4f* src) {
+#if defined(XR_LINEAR_SSE)
+    // Transposing the columns (with an identity fourth column) gives the inverse rotation in t0, t1 and t2.
+    __m128 t0 = _mm_loadu_ps(&src->m[0]);
+    __m128 t1 = _mm_loadu_ps(&src->m[4]);
+    __m128 t2 = _mm_loadu_ps(&src->m[8]);
+    __m128 t3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    const float tx = src->m[12];
+    const float ty = src->m[13];
+    const float tz = src->m[14];
+    _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+    const __m128 translation = _mm_add_ps(_mm_add_ps(_mm_mul_ps(t0, _mm_set1_ps(tx)), _mm_mul_ps(t1, _mm_set1_ps(ty))), _mm_mul_ps(t2, _mm_set1_ps(tz)));
+    _mm_storeu_ps(&result->m[0], t0);
+    _mm_storeu_ps(&result->m[4], t1);
+    _mm_storeu_ps(&result->m[8], t2);
+    _mm_storeu_ps(&result->m[12], _mm_xor_ps(translation, _mm_set1_ps(-0.0f)));
+    result->m[15] = 1.0f;
+#elif defined(XR_LINEAR_NEON)
+    // vld4q de-interleaves the matrix into its rows, i.e. the columns of the transpose.
+    const float32x4x4_t rows = vld4q_f32(src->m);
+    const float tx = src->m[12];
+    const float ty = src->m[13];
+    const float tz = src->m[14];
+    const float32x4_t t0 = vsetq_lane_f32(0.0f, rows.val[0], 3);
+    const float32x4_t t1 = vsetq_lane_f32(0.0f, rows.val[1], 3);
+    const float32x4_t t2 = vsetq_lane_f32(0.0f, rows.val[2], 3);
+    const float32x4_t translation = vaddq_f32(vaddq_f32(vmulq_n_f32(t0, tx), vmulq_n_f32(t1, ty)), vmulq_n_f32(t2, tz));
+    vst1q_f32(&result->m[0], t0);
+    vst1q_f32(&result->m[4], t1);
+    vst1q_f32(&result->m[8], t2);
+    vst1q_f32(&result->m[12], vnegq_f32(translation));
+    result->m[15] = 1.0f;
+#else
+    XrMatrix4x4f_InvertRigidBody_Scalar(result, src);
+#endif
+}
+
 // Creates an identity matrix.
 inline static void XrMatrix4x4f_CreateIdentity(XrMatrix4x4f* result) {
     result->m[0] = 1.0f;
@@ -461,8 +583,8 @@ inline static void XrMatrix4x4f_CreateFromQuaternion(XrMatrix4x4f* result, const
 }
 
 // Creates a combined translation(rotation(scale(object))) matrix.
-inline static void XrMatrix4x4f_CreateTranslationRotationScale(XrMatrix4x4f* result, const XrVector3f* translation,
-                                                               const XrQuaternionf* rotation, const XrVector3f* scale) {
+inline static void XrMatrix4x4f_CreateTranslationRotationScale_Scalar(XrMatrix4x4f* result, const XrVector3f* translation,
+                                                                      const XrQuaternionf* rotation, const XrVector3f* scale) {
     XrMatrix4x4f scaleMatrix;
     XrMatrix4x4f_CreateScale(&scaleMatrix, scale->x, scale->y, scale->z);
 
@@ -473,8 +595,192 @@ inline static void XrMatrix4x4f_CreateTranslationRotationScale(XrMatrix4x4f* res
     XrMatrix4x4f_CreateTranslation(&translationMatrix, translation->x, translation->y, translation->z);
 
     XrMatrix4x4f combinedMatrix;
-    XrMatrix4x4f_Multiply(&combinedMatrix, &rotationMatrix, &scaleMatrix);
-    XrMatrix4x4f_Multiply(result, &translationMatrix, &combinedMatrix);
+    XrMatrix4x4f_Multiply_Scalar(&combinedMatrix, &rotationMatrix, &scaleMatrix);
+    XrMatrix4x4f_Multiply_Scalar(result, &translationMatrix, &combinedMatrix);
+}
+
+inline static void XrMatrix4x4f_CreateTranslationRotationScale(XrMatrix4x4f* result, const XrVector3f* translation,
+                                                               const XrQuaternionf* rotation, const XrVector3f* scale) {
+#if defined(XR_LINEAR_SSE) || defined(XR_LINEAR_NEON)
+    // Builds the product directly: the rotation columns scaled by 'scale', with 'translation' as the fourth column.
+    // This skips the two matrix multiplies by mostly zero matrices, whose only effect on the result is the sign of some zeros.
+    XrMatrix4x4f rotationMatrix;
+    XrMatrix4x4f_CreateFromQuaternion(&rotationMatrix, rotation);
+#if defined(XR_LINEAR_SSE)
+    _mm_storeu_ps(&result->m[0], _mm_mul_ps(_mm_loadu_ps(&rotationMatrix.m[0]), _mm_set1_ps(scale->x)));
+    _mm_storeu_ps(&result->m[4], _mm_mul_ps(_mm_loadu_ps(&rotationMatrix.m[4]), _mm_set1_ps(scale->y)));
+    _mm_storeu_ps(&result->m[8], _mm_mul_ps(_mm_loadu_ps(&rotationMatrix.m[8]), _mm_set1_ps(scale->z)));
+    _mm_storeu_ps(&result->m[12], _mm_set_ps(1.0f, translation->z, translation->y, translation->x));
+#else
+    vst1q_f32(&result->m[0], vmulq_n_f32(vld1q_f32(&rotationMatrix.m[0]), scale->x));
+    vst1q_f32(&result->m[4], vmulq_n_f32(vld1q_f32(&rotationMatrix.m[4]), scale->y));
+    vst1q_f32(&result->m[8], vmulq_n_f32(vld1q_f32(&rotationMatrix.m[8]), scale->z));
+    const float translationColumn[4] = {translation->x, translation->y, translation->z, 1.0f};
+    vst1q_f32(&result->m[12], vld1q_f32(translationColumn));
+#endif
+#else
+    XrMatrix4x4f_CreateTranslationRotationScale_Scalar(result, translation, rotation, scale);
+#endif
+}
+
+inline static XrMatrix4x4f* XrMatrix4x4f_BatchResult(XrMatrix4x4f* results, size_t resultStride, size_t index) {
+    return (XrMatrix4x4f*)((char*)results + index * (resultStride ? resultStride : sizeof(XrMatrix4x4f)));
+}
+
+// Builds the model matrix of a single transform from the batch.
+inline static void XrMatrix4x4f_CreateTranslationRotationScale_BatchElement(XrMatrix4x4f* result, const XrTransformArraysf* transforms,
+                                                                            size_t index) {
+    const XrVector3f translation = {transforms->translation[0][index], transforms->translation[1][index], transforms->translation[2][index]};
+    const XrQuaternionf rotation = {transforms->rotation[0][index], transforms->rotation[1][index], transforms->rotation[2][index],
+                                    transforms->rotation[3][index]};
+    const XrVector3f scale = {transforms->scale[0][index], transforms->scale[1][index], transforms->scale[2][index]};
+    XrMatrix4x4f_CreateTranslationRotationScale(result, &translation, &rotation, &scale);
+}
+
+#if defined(XR_LINEAR_SSE) || defined(XR_LINEAR_NEON)
+// Four floats, one from each of four transforms, so that a batch is processed four transforms at a time.
+#if defined(XR_LINEAR_SSE)
+typedef __m128 XrLinearFloat4;
+inline static XrLinearFloat4 XrLinearFloat4_Load(const float* p) { return _mm_loadu_ps(p); }
+inline static XrLinearFloat4 XrLinearFloat4_Set1(const float x) { return _mm_set1_ps(x); }
+inline static XrLinearFloat4 XrLinearFloat4_Add(XrLinearFloat4 a, XrLinearFloat4 b) { return _mm_add_ps(a, b); }
+inline static XrLinearFloat4 XrLinearFloat4_Sub(XrLinearFloat4 a, XrLinearFloat4 b) { return _mm_sub_ps(a, b); }
+inline static XrLinearFloat4 XrLinearFloat4_Mul(XrLinearFloat4 a, XrLinearFloat4 b) { return _mm_mul_ps(a, b); }
+inline static void XrLinearFloat4_Store(float* p, XrLinearFloat4 v) { _mm_storeu_ps(p, v); }
+inline static void XrLinearFloat4_Transpose(XrLinearFloat4* v) { _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]); }
+#else
+typedef float32x4_t XrLinearFloat4;
+inline static XrLinearFloat4 XrLinearFloat4_Load(const float* p) { return vld1q_f32(p); }
+inline static XrLinearFloat4 XrLinearFloat4_Set1(const float x) { return vdupq_n_f32(x); }
+inline static XrLinearFloat4 XrLinearFloat4_Add(XrLinearFloat4 a, XrLinearFloat4 b) { return vaddq_f32(a, b); }
+inline static XrLinearFloat4 XrLinearFloat4_Sub(XrLinearFloat4 a, XrLinearFloat4 b) { return vsubq_f32(a, b); }
+inline static XrLinearFloat4 XrLinearFloat4_Mul(XrLinearFloat4 a, XrLinearFloat4 b) { return vmulq_f32(a, b); }
+inline static void XrLinearFloat4_Store(float* p, XrLinearFloat4 v) { vst1q_f32(p, v); }
+inline static void XrLinearFloat4_Transpose(XrLinearFloat4* v) {
+    const float32x4x2_t v01 = vtrnq_f32(v[0], v[1]);
+    const float32x4x2_t v23 = vtrnq_f32(v[2], v[3]);
+    v[0] = vcombine_f32(vget_low_f32(v01.val[0]), vget_low_f32(v23.val[0]));
+    v[1] = vcombine_f32(vget_low_f32(v01.val[1]), vget_low_f32(v23.val[1]));
+    v[2] = vcombine_f32(vget_high_f32(v01.val[0]), vget_high_f32(v23.val[0]));
+    v[3] = vcombine_f32(vget_high_f32(v01.val[1]), vget_high_f32(v23.val[1]));
+}
+#endif
+
+// Computes the upper 3x4 of the model matrices of transforms index to index + 3, as XrMatrix4x4f_CreateFromQuaternion()
+// does, with the rotation columns scaled and the translation as the fourth column. The fourth row is always 0, 0, 0, 1.
+inline static void XrLinearFloat4_CreateTranslationRotationScale(XrLinearFloat4* m, const XrTransformArraysf* transforms, size_t index) {
+    const XrLinearFloat4 x = XrLinearFloat4_Load(&transforms->rotation[0][index]);
+    const XrLinearFloat4 y = XrLinearFloat4_Load(&transforms->rotation[1][index]);
+    const XrLinearFloat4 z = XrLinearFloat4_Load(&transforms->rotation[2][index]);
+    const XrLinearFloat4 w = XrLinearFloat4_Load(&transforms->rotation[3][index]);
+
+    const XrLinearFloat4 x2 = XrLinearFloat4_Add(x, x);
+    const XrLinearFloat4 y2 = XrLinearFloat4_Add(y, y);
+    const XrLinearFloat4 z2 = XrLinearFloat4_Add(z, z);
+
+    const XrLinearFloat4 xx2 = XrLinearFloat4_Mul(x, x2);
+    const XrLinearFloat4 yy2 = XrLinearFloat4_Mul(y, y2);
+    const XrLinearFloat4 zz2 = XrLinearFloat4_Mul(z, z2);
+
+    const XrLinearFloat4 yz2 = XrLinearFloat4_Mul(y, z2);
+    const XrLinearFloat4 wx2 = XrLinearFloat4_Mul(w, x2);
+    const XrLinearFloat4 xy2 = XrLinearFloat4_Mul(x, y2);
+    const XrLinearFloat4 wz2 = XrLinearFloat4_Mul(w, z2);
+    const XrLinearFloat4 xz2 = XrLinearFloat4_Mul(x, z2);
+    const XrLinearFloat4 wy2 = XrLinearFloat4_Mul(w, y2);
+
+    const XrLinearFloat4 one = XrLinearFloat4_Set1(1.0f);
+    const XrLinearFloat4 sx = XrLinearFloat4_Load(&transforms->scale[0][index]);
+    const XrLinearFloat4 sy = XrLinearFloat4_Load(&transforms->scale[1][index]);
+    const XrLinearFloat4 sz = XrLinearFloat4_Load(&transforms->scale[2][index]);
+
+    m[0] = XrLinearFloat4_Mul(XrLinearFloat4_Sub(XrLinearFloat4_Sub(one, yy2), zz2), sx);
+    m[1] = XrLinearFloat4_Mul(XrLinearFloat4_Add(xy2, wz2), sx);
+    m[2] = XrLinearFloat4_Mul(XrLinearFloat4_Sub(xz2, wy2), sx);
+
+    m[3] = XrLinearFloat4_Mul(XrLinearFloat4_Sub(xy2, wz2), sy);
+    m[4] = XrLinearFloat4_Mul(XrLinearFloat4_Sub(XrLinearFloat4_Sub(one, xx2), zz2), sy);
+    m[5] = XrLinearFloat4_Mul(XrLinearFloat4_Add(yz2, wx2), sy);
+
+    m[6] = XrLinearFloat4_Mul(XrLinearFloat4_Add(xz2, wy2), sz);
+    m[7] = XrLinearFloat4_Mul(XrLinearFloat4_Sub(yz2, wx2), sz);
+    m[8] = XrLinearFloat4_Mul(XrLinearFloat4_Sub(XrLinearFloat4_Sub(one, xx2), yy2), sz);
+
+    m[9] = XrLinearFloat4_Load(&transforms->translation[0][index]);
+    m[10] = XrLinearFloat4_Load(&transforms->translation[1][index]);
+    m[11] = XrLinearFloat4_Load(&transforms->translation[2][index]);
+}
+
+// Transposes the columns of four matrices, held as one XrLinearFloat4 per element, and stores them as four XrMatrix4x4f.
+inline static void XrLinearFloat4_StoreMatrices(XrMatrix4x4f* results, size_t resultStride, size_t index, XrLinearFloat4* columns) {
+    for (int c = 0; c < 4; c++) {
+        XrLinearFloat4_Transpose(&columns[4 * c]);
+    }
+    for (int i = 0; i < 4; i++) {
+        XrMatrix4x4f* result = XrMatrix4x4f_BatchResult(results, resultStride, index + i);
+        for (int c = 0; c < 4; c++) {
+            XrLinearFloat4_Store(&result->m[4 * c], columns[4 * c + i]);
+        }
+    }
+}
+#endif
+
+// Creates the translation(rotation(scale(object))) matrices of a batch of transforms.
+inline static void XrMatrix4x4f_CreateTranslationRotationScale_Batch(XrMatrix4x4f* results, size_t resultStride,
+                                                                     const XrTransformArraysf* transforms, size_t count) {
+    size_t i = 0;
+#if defined(XR_LINEAR_SSE) || defined(XR_LINEAR_NEON)
+    const XrLinearFloat4 zero = XrLinearFloat4_Set1(0.0f);
+    const XrLinearFloat4 one = XrLinearFloat4_Set1(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        XrLinearFloat4 m[12];
+        XrLinearFloat4_CreateTranslationRotationScale(m, transforms, i);
+        XrLinearFloat4 columns[16] = {m[0], m[1], m[2], zero, m[3], m[4], m[5], zero, m[6], m[7], m[8], zero, m[9], m[10], m[11], one};
+        XrLinearFloat4_StoreMatrices(results, resultStride, i, columns);
+    }
+#endif
+    for (; i < count; i++) {
+        XrMatrix4x4f_CreateTranslationRotationScale_BatchElement(XrMatrix4x4f_BatchResult(results, resultStride, i), transforms, i);
+    }
+}
+
+// Creates viewProjs[v] * translation(rotation(scale(object))) for every view and transform of a batch. The result for view v
+// and transform i is at index v * count + i. Each model matrix is built once and multiplied by all the views.
+inline static void XrMatrix4x4f_CreateModelViewProjection_Batch(XrMatrix4x4f* results, size_t resultStride, const XrMatrix4x4f* viewProjs,
+                                                                size_t viewCount, const XrTransformArraysf* transforms, size_t count) {
+    size_t i = 0;
+#if defined(XR_LINEAR_SSE) || defined(XR_LINEAR_NEON)
+    for (; i + 4 <= count; i += 4) {
+        XrLinearFloat4 m[12];
+        XrLinearFloat4_CreateTranslationRotationScale(m, transforms, i);
+        for (size_t v = 0; v < viewCount; v++) {
+            // As XrMatrix4x4f_Multiply(), in the same order, but skipping the terms of the model's fourth row, which are zero
+            // in the first three columns and one in the last.
+            const float* a = viewProjs[v].m;
+            XrLinearFloat4 columns[16];
+            for (int c = 0; c < 4; c++) {
+                for (int r = 0; r < 4; r++) {
+                    const XrLinearFloat4 x = XrLinearFloat4_Mul(XrLinearFloat4_Set1(a[r]), m[3 * c + 0]);
+                    const XrLinearFloat4 y = XrLinearFloat4_Mul(XrLinearFloat4_Set1(a[4 + r]), m[3 * c + 1]);
+                    const XrLinearFloat4 z = XrLinearFloat4_Mul(XrLinearFloat4_Set1(a[8 + r]), m[3 * c + 2]);
+                    XrLinearFloat4 sum = XrLinearFloat4_Add(XrLinearFloat4_Add(x, y), z);
+                    if (c == 3) {
+                        sum = XrLinearFloat4_Add(sum, XrLinearFloat4_Set1(a[12 + r]));
+                    }
+                    columns[4 * c + r] = sum;
+                }
+            }
+            XrLinearFloat4_StoreMatrices(results, resultStride, v * count + i, columns);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        XrMatrix4x4f model;
+        XrMatrix4x4f_CreateTranslationRotationScale_BatchElement(&model, transforms, i);
+        for (size_t v = 0; v < viewCount; v++) {
+            XrMatrix4x4f_Multiply(XrMatrix4x4f_BatchResult(results, resultStride, v * count + i), &viewProjs[v], &model);
+        }
+    }
 }
 
 // Creates a projection matrix based on the specified dimensions.
@@ -710,8 +1016,8 @@ inline static void XrMatrix4x4f_TransformVector4f(XrVector4f* result, const XrMa
 }
 
 // Transforms the 'mins' and 'maxs' bounds with the given 'matrix'.
-inline static void XrMatrix4x4f_TransformBounds(XrVector3f* resultMins, XrVector3f* resultMaxs, const XrMatrix4x4f* matrix,
-                                                const XrVector3f* mins, const XrVector3f* maxs) {
+inline static void XrMatrix4x4f_TransformBounds_Scalar(XrVector3f* resultMins, XrVector3f* resultMaxs, const XrMatrix4x4f* matrix,
+                                                       const XrVector3f* mins, const XrVector3f* maxs) {
     assert(XrMatrix4x4f_IsAffine(matrix, 1e-4f));
 
     const XrVector3f center = {(mins->x + maxs->x) * 0.5f, (mins->y + maxs->y) * 0.5f, (mins->z + maxs->z) * 0.5f};
@@ -727,6 +1033,71 @@ inline static void XrMatrix4x4f_TransformBounds(XrVector3f* resultMins, XrVector
     XrVector3f_Add(resultMaxs, &newCenter, &newExtents);
 }
 
+inline static void XrMatrix4x4f_TransformBounds(XrVector3f* resultMins, XrVector3f* resultMaxs, const XrMatrix4x4f* matrix,
+                                                const XrVector3f* mins, const XrVector3f* maxs) {
+#if defined(XR_LINEAR_SSE)
+    assert(XrMatrix4x4f_IsAffine(matrix, 1e-4f));
+
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 vMins = _mm_set_ps(0.0f, mins->z, mins->y, mins->x);
+    const __m128 vMaxs = _mm_set_ps(0.0f, maxs->z, maxs->y, maxs->x);
+    const __m128 center = _mm_mul_ps(_mm_add_ps(vMins, vMaxs), half);
+    const __m128 extents = _mm_sub_ps(vMaxs, center);
+    const __m128 c0 = _mm_loadu_ps(&matrix->m[0]);
+    const __m128 c1 = _mm_loadu_ps(&matrix->m[4]);
+    const __m128 c2 = _mm_loadu_ps(&matrix->m[8]);
+    const __m128 c3 = _mm_loadu_ps(&matrix->m[12]);
+
+    const __m128 cx = _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 cy = _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 cz = _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 newCenter = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, cx), _mm_mul_ps(c1, cy)), _mm_mul_ps(c2, cz)), c3);
+
+    const __m128 ex = _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 ey = _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 ez = _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 newExtents = _mm_add_ps(_mm_add_ps(_mm_and_ps(_mm_mul_ps(ex, c0), absMask), _mm_and_ps(_mm_mul_ps(ey, c1), absMask)),
+                                         _mm_and_ps(_mm_mul_ps(ez, c2), absMask));
+
+    float newMins[4];
+    float newMaxs[4];
+    _mm_storeu_ps(newMins, _mm_sub_ps(newCenter, newExtents));
+    _mm_storeu_ps(newMaxs, _mm_add_ps(newCenter, newExtents));
+    resultMins->x = newMins[0];
+    resultMins->y = newMins[1];
+    resultMins->z = newMins[2];
+    resultMaxs->x = newMaxs[0];
+    resultMaxs->y = newMaxs[1];
+    resultMaxs->z = newMaxs[2];
+#elif defined(XR_LINEAR_NEON)
+    assert(XrMatrix4x4f_IsAffine(matrix, 1e-4f));
+
+    const XrVector3f center = {(mins->x + maxs->x) * 0.5f, (mins->y + maxs->y) * 0.5f, (mins->z + maxs->z) * 0.5f};
+    const XrVector3f extents = {maxs->x - center.x, maxs->y - center.y, maxs->z - center.z};
+    const float32x4_t c0 = vld1q_f32(&matrix->m[0]);
+    const float32x4_t c1 = vld1q_f32(&matrix->m[4]);
+    const float32x4_t c2 = vld1q_f32(&matrix->m[8]);
+    const float32x4_t c3 = vld1q_f32(&matrix->m[12]);
+    const float32x4_t newCenter = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(c0, center.x), vmulq_n_f32(c1, center.y)), vmulq_n_f32(c2, center.z)), c3);
+    const float32x4_t newExtents = vaddq_f32(vaddq_f32(vabsq_f32(vmulq_n_f32(c0, extents.x)), vabsq_f32(vmulq_n_f32(c1, extents.y))),
+                                             vabsq_f32(vmulq_n_f32(c2, extents.z)));
+
+    float newMins[4];
+    float newMaxs[4];
+    vst1q_f32(newMins, vsubq_f32(newCenter, newExtents));
+    vst1q_f32(newMaxs, vaddq_f32(newCenter, newExtents));
+    resultMins->x = newMins[0];
+    resultMins->y = newMins[1];
+    resultMins->z = newMins[2];
+    resultMaxs->x = newMaxs[0];
+    resultMaxs->y = newMaxs[1];
+    resultMaxs->z = newMaxs[2];
+#else
+    XrMatrix4x4f_TransformBounds_Scalar(resultMins, resultMaxs, matrix, mins, maxs);
+#endif
+}
+
 // Returns true if the 'mins' and 'maxs' bounds is completely off to one side of the projection matrix.
 inline static bool XrMatrix4x4f_CullBounds(const XrMatrix4x4f* mvp, const XrVector3f* mins, const XrVector3f* maxs) {
     if (maxs->x <= mins->x && maxs->y <= mins->y && maxs->z <= mins->z) {
@@ -0,0 +1,247 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+// Converts a Wavefront OBJ file, as exported by most CAD and modelling tools, into the binary mesh format in MeshFile.h:
+//   MeshConverter input.obj output.xrmesh
+// Faces are triangulated as fans. Vertices without normals get the area-weighted normal of their faces.
+
+#include <MeshFile.h>
+
+#include <cfloat>
+
+namespace {
+struct Float3 {
+    float x, y, z;
+};
+
+Float3 operator-(const Float3 &a, const Float3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+Float3 Cross(const Float3 &a, const Float3 &b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+Float3 Normalize(const Float3 &a) {
+    const float length = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+    return length > 0.0f ? Float3{a.x / length, a.y / length, a.z / length} : Float3{0.0f, 0.0f, 1.0f};
+}
+
+struct Mesh {
+    std::vector<Float3> positions;
+    std::vector<Float3> normals;
+    std::vector<uint32_t> indices;
+};
+
+// Resolves a 1-based or negative OBJ index against the number of elements read so far.
+bool ResolveIndex(long index, size_t count, uint32_t &result) {
+    const long resolved = index < 0 ? long(count) + index : index - 1;
+    if (resolved < 0 || size_t(resolved) >= count) {
+        return false;
+    }
+    result = uint32_t(resolved);
+    return true;
+}
+
+bool ReadObj(const std::string &filepath, Mesh &mesh) {
+    std::ifstream stream(filepath);
+    if (!stream.is_open()) {
+        std::cout << "ERROR: Could not read file " << filepath.c_str() << "." << std::endl;
+        return false;
+    }
+
+    std::vector<Float3> objPositions;
+    std::vector<Float3> objNormals;
+    // Each distinct position/normal pair becomes one vertex. Without a normal, the normal index is ~0u.
+    std::unordered_map<uint64_t, uint32_t> vertexIndices;
+    std::vector<uint32_t> vertexNormals;
+    bool missingNormals = false;
+
+    std::string line;
+    std::vector<uint32_t> face;
+    size_t lineNumber = 0;
+    while (std::getline(stream, line)) {
+        lineNumber++;
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "v") {
+            Float3 p = {};
+            tokens >> p.x >> p.y >> p.z;
+            objPositions.push_back(p);
+        } else if (keyword == "vn") {
+            Float3 n = {};
+            tokens >> n.x >> n.y >> n.z;
+            objNormals.push_back(Normalize(n));
+        } else if (keyword == "f") {
+            face.clear();
+            std::string corner;
+            while (tokens >> corner) {
+                // v, v/vt, v//vn or v/vt/vn. Texture coordinates are not used.
+                uint32_t position = 0;
+                uint32_t normal = ~0u;
+                const size_t firstSlash = corner.find('/');
+                const size_t lastSlash = corner.rfind('/');
+                if (!ResolveIndex(std::strtol(corner.c_str(), nullptr, 10), objPositions.size(), position)) {
+                    std::cout << "ERROR: " << filepath.c_str() << ":" << lineNumber << ": Invalid face." << std::endl;
+                    return false;
+                }
+                if (firstSlash != std::string::npos && lastSlash != firstSlash) {
+                    if (!ResolveIndex(std::strtol(corner.c_str() + lastSlash + 1, nullptr, 10), objNormals.size(), normal)) {
+                        std::cout << "ERROR: " << filepath.c_str() << ":" << lineNumber << ": Invalid normal index." << std::endl;
+                        return false;
+                    }
+                }
+                missingNormals |= normal == ~0u;
+
+                const uint64_t key = (uint64_t(position) << 32) | normal;
+                auto it = vertexIndices.find(key);
+                if (it == vertexIndices.end()) {
+                    it = vertexIndices.emplace(key, uint32_t(mesh.positions.size())).first;
+                    mesh.positions.push_back(objPositions[position]);
+                    vertexNormals.push_back(normal);
+                }
+                face.push_back(it->second);
+            }
+            for (size_t i = 2; i < face.size(); i++) {
+                mesh.indices.insert(mesh.indices.end(), {face[0], face[i - 1], face[i]});
+            }
+        }
+    }
+
+    mesh.normals.resize(mesh.positions.size(), {0.0f, 0.0f, 0.0f});
+    if (missingNormals) {
+        // The cross product's length is twice the triangle's area, so larger faces weigh more.
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const uint32_t *triangle = &mesh.indices[i];
+            const Float3 faceNormal = Cross(mesh.positions[triangle[1]] - mesh.positions[triangle[0]], mesh.positions[triangle[2]] - mesh.positions[triangle[0]]);
+            for (int j = 0; j < 3; j++) {
+                Float3 &normal = mesh.normals[triangle[j]];
+                normal = {normal.x + faceNormal.x, normal.y + faceNormal.y, normal.z + faceNormal.z};
+            }
+        }
+    }
+    for (size_t i = 0; i < mesh.positions.size(); i++) {
+        mesh.normals[i] = vertexNormals[i] != ~0u ? objNormals[vertexNormals[i]] : Normalize(mesh.normals[i]);
+    }
+    return true;
+}
+
+// Splits the triangle list, in order, into meshlets of at most meshletMaxVertices distinct vertices and meshletMaxTriangles
+// triangles.
+std::vector<MeshMeshlet> BuildMeshlets(const Mesh &mesh) {
+    std::vector<MeshMeshlet> meshlets;
+    std::vector<uint32_t> meshletVertices;
+    meshletVertices.reserve(meshletMaxVertices);
+    const auto addVertex = [&meshletVertices](uint32_t vertex) {
+        if (std::find(meshletVertices.begin(), meshletVertices.end(), vertex) == meshletVertices.end()) {
+            meshletVertices.push_back(vertex);
+        }
+    };
+
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const uint32_t *triangle = &mesh.indices[i];
+        size_t newVertexCount = 0;
+        for (int j = 0; j < 3; j++) {
+            newVertexCount += std::find(meshletVertices.begin(), meshletVertices.end(), triangle[j]) == meshletVertices.end() ? 1 : 0;
+        }
+        if (meshlets.empty() || meshletVertices.size() + newVertexCount > meshletMaxVertices || meshlets.back().indexCount / 3 == meshletMaxTriangles) {
+            meshlets.push_back({uint32_t(i), 0, {FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}});
+            meshletVertices.clear();
+        }
+        MeshMeshlet &meshlet = meshlets.back();
+        meshlet.indexCount += 3;
+        for (int j = 0; j < 3; j++) {
+            addVertex(triangle[j]);
+            const Float3 &p = mesh.positions[triangle[j]];
+            const float position[3] = {p.x, p.y, p.z};
+            for (int k = 0; k < 3; k++) {
+                meshlet.mins[k] = std::min(meshlet.mins[k], position[k]);
+                meshlet.maxs[k] = std::max(meshlet.maxs[k], position[k]);
+            }
+        }
+    }
+    return meshlets;
+}
+
+void AppendPadded(std::vector<char> &output, const void *data, size_t size) {
+    const char *bytes = reinterpret_cast<const char *>(data);
+    output.insert(output.end(), bytes, bytes + size);
+    output.resize(Align<size_t>(output.size(), 16));
+}
+
+bool WriteMeshFile(const std::string &filepath, const Mesh &mesh, const std::vector<MeshMeshlet> &meshlets) {
+    // MeshFile rejects a mesh that fails the same check when it's loaded.
+    if (!CheckMeshIndices(mesh.indices.data(), sizeof(uint32_t), uint32_t(mesh.indices.size()), uint32_t(mesh.positions.size()), meshlets.data(), uint32_t(meshlets.size()))) {
+        std::cout << "ERROR: " << filepath.c_str() << ": An index is out of range of the vertices, or a meshlet of the indices." << std::endl;
+        return false;
+    }
+
+    MeshFileHeader header = {};
+    header.magic = meshFileMagic;
+    header.version = meshFileVersion;
+    header.vertexCount = uint32_t(mesh.positions.size());
+    header.vertexStride = sizeof(MeshVertex);
+    header.indexCount = uint32_t(mesh.indices.size());
+    header.indexStride = mesh.positions.size() <= 0x10000 ? 2 : 4;
+    header.meshletCount = uint32_t(meshlets.size());
+
+    float mins[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float maxs[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (const Float3 &p : mesh.positions) {
+        const float position[3] = {p.x, p.y, p.z};
+        for (int k = 0; k < 3; k++) {
+            mins[k] = std::min(mins[k], position[k]);
+            maxs[k] = std::max(maxs[k], position[k]);
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        header.center[k] = mesh.positions.empty() ? 0.0f : 0.5f * (mins[k] + maxs[k]);
+        header.halfExtent[k] = mesh.positions.empty() ? 0.0f : 0.5f * (maxs[k] - mins[k]);
+    }
+
+    std::vector<MeshVertex> vertices(mesh.positions.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const float position[3] = {mesh.positions[i].x, mesh.positions[i].y, mesh.positions[i].z};
+        const float normal[3] = {mesh.normals[i].x, mesh.normals[i].y, mesh.normals[i].z};
+        vertices[i] = EncodeMeshVertex(position, normal, header.center, header.halfExtent);
+    }
+
+    std::vector<char> output(Align<size_t>(sizeof(header), 16));
+    header.verticesOffset = output.size();
+    AppendPadded(output, vertices.data(), vertices.size() * sizeof(MeshVertex));
+    header.indicesOffset = output.size();
+    if (header.indexStride == 2) {
+        std::vector<uint16_t> indices16(mesh.indices.begin(), mesh.indices.end());
+        AppendPadded(output, indices16.data(), indices16.size() * sizeof(uint16_t));
+    } else {
+        AppendPadded(output, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    }
+    header.meshletsOffset = output.size();
+    AppendPadded(output, meshlets.data(), meshlets.size() * sizeof(MeshMeshlet));
+    memcpy(output.data(), &header, sizeof(header));
+
+    return WriteBinaryFile(filepath, output);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cout << "Usage: MeshConverter input.obj output.xrmesh" << std::endl;
+        return 1;
+    }
+
+    Mesh mesh;
+    if (!ReadObj(argv[1], mesh)) {
+        return 1;
+    }
+    if (mesh.indices.empty()) {
+        std::cout << "ERROR: " << argv[1] << " has no faces." << std::endl;
+        return 1;
+    }
+
+    const std::vector<MeshMeshlet> meshlets = BuildMeshlets(mesh);
+    if (!WriteMeshFile(argv[2], mesh, meshlets)) {
+        return 1;
+    }
+    std::cout << "Wrote " << argv[2] << ": " << mesh.positions.size() << " vertices, " << mesh.indices.size() / 3 << " triangles, "
+              << meshlets.size() << " meshlets." << std::endl;
+    return 0;
+}
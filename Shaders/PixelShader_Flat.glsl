@@ -0,0 +1,12 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#version 450
+layout(location = 0) in flat uvec2 i_TexCoord;
+layout(location = 1) in vec3 i_Normal;
+layout(location = 2) in flat vec3 i_Color;
+layout(location = 0) out vec4 o_Color;
+void main() {
+    o_Color = vec4(i_Color.rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#version 450
+#extension GL_KHR_vulkan_glsl : enable
+struct CuboidInstance {
+    mat4 model;
+    vec4 color;
+};
+layout(std140, binding = 0) uniform CameraConstants {
+    mat4 viewProj;
+};
+// The cuboids are drawn with a quantized mesh: positions in [-1, 1] within its bounds, scaled to fit the 1x1x1 meter cube.
+layout(std140, binding = 1) uniform MeshConstants {
+    vec4 positionScale;
+};
+layout(std140, binding = 3) uniform Instances {
+    CuboidInstance instances[128];
+};
+layout(location = 0) in vec4 a_Positions;
+layout(location = 1) in vec4 a_Normal;
+layout(location = 0) out flat uvec2 o_TexCoord;
+layout(location = 1) out vec3 o_Normal;
+layout(location = 2) out flat vec3 o_Color;
+void main() {
+    CuboidInstance cuboid = instances[gl_InstanceIndex];
+    gl_Position = viewProj * cuboid.model * vec4(a_Positions.xyz * positionScale.xyz, 1.0);
+    int face = gl_VertexIndex / 6;
+    o_TexCoord = uvec2(face, 0);
+    o_Normal = (cuboid.model * vec4(a_Normal.xyz, 0.0)).xyz;
+    o_Color = cuboid.color.rgb;
+}
\ No newline at end of file
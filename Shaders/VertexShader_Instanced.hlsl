@@ -0,0 +1,49 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+struct CuboidInstance
+{
+    float4x4 model;
+    float4 color;
+};
+cbuffer CameraConstants : register(b0)
+{
+    float4x4 viewProj;
+};
+// The cuboids are drawn with a quantized mesh: positions in [-1, 1] within its bounds, scaled to fit the 1x1x1 meter cube.
+cbuffer MeshConstants : register(b1)
+{
+    float4 positionScale;
+};
+cbuffer Instances : register(b3)
+{
+    CuboidInstance instances[128];
+};
+
+struct VS_IN
+{
+    uint vertexId : SV_VertexId;
+    uint instanceId : SV_InstanceID;
+    float4 a_Positions : TEXCOORD0;
+    float4 a_Normal : TEXCOORD1;
+};
+struct VS_OUT
+{
+    float4 o_Position : SV_Position;
+    nointerpolation float2 o_TexCoord : TEXCOORD0;
+    float3 o_Normal : TEXCOORD1;
+    nointerpolation float3 o_Color : TEXCOORD2;
+};
+
+VS_OUT main(VS_IN IN)
+{
+    VS_OUT OUT;
+    CuboidInstance cuboid = instances[IN.instanceId];
+    OUT.o_Position = mul(viewProj, mul(cuboid.model, float4(IN.a_Positions.xyz * positionScale.xyz, 1.0)));
+    int face = IN.vertexId / 6;
+    OUT.o_TexCoord = float2(float(face), 0);
+    OUT.o_Normal = (mul(cuboid.model, float4(IN.a_Normal.xyz, 0.0))).xyz;
+    OUT.o_Color = cuboid.color.rgb;
+    return OUT;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#version 310 es
+struct CuboidInstance {
+    mat4 model;
+    vec4 colour;
+};
+layout(std140, binding = 0) uniform CameraConstants {
+    mat4 viewProj;
+};
+// The cuboids are drawn with a quantized mesh: positions in [-1, 1] within its bounds, scaled to fit the 1x1x1 meter cube.
+layout(std140, binding = 1) uniform MeshConstants {
+    vec4 positionScale;
+};
+layout(std140, binding = 3) uniform Instances {
+    CuboidInstance instances[128];
+};
+layout(location = 0) in highp vec4 a_Positions;
+layout(location = 1) in highp vec4 a_Normal;
+layout(location = 0) out flat uvec2 o_TexCoord;
+layout(location = 1) out highp vec3 o_Normal;
+layout(location = 2) out flat vec3 o_Colour;
+void main() {
+    CuboidInstance cuboid = instances[gl_InstanceID];
+    gl_Position = viewProj * cuboid.model * vec4(a_Positions.xyz * positionScale.xyz, 1.0);
+    int face = gl_VertexID / 6;
+    o_TexCoord = uvec2(face, 0);
+    o_Normal = (cuboid.model * vec4(a_Normal.xyz, 0.0)).xyz;
+    o_Colour = cuboid.colour.rgb;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+// Checks the nearest-rank percentiles, the missed frame count and the ring of records of FrameTiming. The CPU timings
+// depend on the machine, so the checks use the predicted display times, which the test sets itself.
+// Returns non-zero if any check fails.
+
+#include <FrameTiming.h>
+
+#include <random>
+
+static size_t checkCount = 0;
+static size_t failureCount = 0;
+
+static void Check(bool passed, const std::string &description) {
+    checkCount++;
+    if (!passed) {
+        std::cout << "ERROR: " << description << std::endl;
+        failureCount++;
+    }
+}
+
+static void CheckValue(double value, double expected, const std::string &description) {
+    std::ostringstream ostr;
+    ostr << description << " is " << value << ", expected " << expected;
+    Check(value == expected, ostr.str());
+}
+
+static const XrTime firstDisplayTime = 1000000000;
+static const XrDuration millisecond = 1000000;
+
+// Records one frame per predicted display time delta. The first frame has no previous one, so its delta is recorded as 0.
+static void RecordFrames(FrameTiming &timing, const std::vector<XrDuration> &deltas, XrDuration period) {
+    XrTime displayTime = firstDisplayTime;
+    timing.BeginFrame();
+    timing.SetDisplayTiming(displayTime, period);
+    timing.EndFrame();
+    for (XrDuration delta : deltas) {
+        displayTime += delta;
+        timing.BeginFrame();
+        timing.BeginStage(FrameTiming::Stage::WAIT_FRAME);
+        timing.EndStage(FrameTiming::Stage::WAIT_FRAME);
+        timing.SetDisplayTiming(displayTime, period);
+        timing.EndFrame();
+    }
+}
+
+static void TestPercentiles() {
+    // No frames.
+    {
+        FrameTiming timing(16);
+        const FrameTiming::Summary summary = timing.GetSummary();
+        CheckValue(static_cast<double>(summary.frameCount), 0.0, "Frame count of no frames");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p50, 0.0, "p50 of no frames");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p99, 0.0, "p99 of no frames");
+    }
+
+    // One frame: every percentile is its only value.
+    {
+        FrameTiming timing(16);
+        RecordFrames(timing, {}, 11 * millisecond);
+        const FrameTiming::Summary summary = timing.GetSummary();
+        CheckValue(static_cast<double>(summary.frameCount), 1.0, "Frame count of one frame");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p50, 0.0, "p50 of one frame");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p99, 0.0, "p99 of one frame");
+    }
+
+    // 0 ms for the first frame, then 1 to 100 ms in a random order: 101 values. The nearest rank of percentile P is
+    // ceil(P / 100 * 101), so p50 is the 51st value, 50 ms, p95 the 96th, 95 ms, and p99 the 100th, 99 ms.
+    {
+        std::vector<XrDuration> deltas;
+        for (XrDuration ms = 1; ms <= 100; ms++) {
+            deltas.push_back(ms * millisecond);
+        }
+        std::mt19937 random(1);
+        std::shuffle(deltas.begin(), deltas.end(), random);
+
+        FrameTiming timing(128);
+        RecordFrames(timing, deltas, 1000 * millisecond);
+        const FrameTiming::Summary summary = timing.GetSummary();
+        CheckValue(static_cast<double>(summary.frameCount), 101.0, "Frame count of 101 frames");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p50, 50.0, "p50 of 0 to 100 ms");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p95, 95.0, "p95 of 0 to 100 ms");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p99, 99.0, "p99 of 0 to 100 ms");
+    }
+
+    // Four values, 0, 10, 20 and 30 ms: p50 is the 2nd value, and p95 and p99 round up to the 4th.
+    {
+        FrameTiming timing(16);
+        RecordFrames(timing, {30 * millisecond, 10 * millisecond, 20 * millisecond}, 1000 * millisecond);
+        const FrameTiming::Summary summary = timing.GetSummary();
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p50, 10.0, "p50 of 0, 10, 20 and 30 ms");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p95, 30.0, "p95 of 0, 10, 20 and 30 ms");
+        CheckValue(summary.predictedDisplayTimeDeltaMs.p99, 30.0, "p99 of 0, 10, 20 and 30 ms");
+    }
+}
+
+// A frame is missed when its predicted display time moved on by more than one and a half display periods.
+static void TestMissedFrames() {
+    const XrDuration period = 10 * millisecond;
+    struct Case {
+        XrDuration delta;
+        bool missed;
+    };
+    const Case cases[] = {
+        {period, false},
+        {period * 3 / 2 - 1, false},
+        {period * 3 / 2, false},  // Exactly one and a half periods is not missed.
+        {period * 3 / 2 + 1, true},
+        {period * 2, true},
+        {period * 10, true},
+        {0, false},
+    };
+    for (const Case &c : cases) {
+        FrameTiming timing(16);
+        RecordFrames(timing, {c.delta}, period);
+        std::ostringstream ostr;
+        ostr << "Missed frame count for a delta of " << c.delta << " ns with a period of " << period << " ns";
+        CheckValue(static_cast<double>(timing.GetSummary().missedFrameCount), c.missed ? 1.0 : 0.0, ostr.str());
+    }
+
+    // Without a display period, no frame counts as missed.
+    {
+        FrameTiming timing(16);
+        RecordFrames(timing, {period * 10}, 0);
+        CheckValue(static_cast<double>(timing.GetSummary().missedFrameCount), 0.0, "Missed frame count without a display period");
+    }
+
+    // Several in a row, with the first frame, whose delta is 0, never missed.
+    {
+        FrameTiming timing(16);
+        RecordFrames(timing, {period, period * 2, period, period * 3, period * 3 / 2}, period);
+        CheckValue(static_cast<double>(timing.GetSummary().missedFrameCount), 2.0, "Missed frame count of a sequence");
+    }
+}
+
+// Only the most recent 'capacity' frames are kept, oldest first, and the summary covers only those.
+static void TestRing() {
+    const size_t capacity = 8;
+    FrameTiming timing(capacity);
+    std::vector<XrDuration> deltas;
+    for (size_t i = 0; i < 19; i++) {
+        deltas.push_back(i < 11 ? 100 * millisecond : 10 * millisecond);
+    }
+    RecordFrames(timing, deltas, 10 * millisecond);
+
+    const std::vector<FrameTiming::Record> records = timing.GetRecords();
+    CheckValue(static_cast<double>(records.size()), static_cast<double>(capacity), "Record count of a full ring");
+    for (size_t i = 0; i < records.size(); i++) {
+        CheckValue(static_cast<double>(records[i].frameIndex), static_cast<double>(20 - capacity + i), "Frame index of record " + std::to_string(i));
+    }
+    const FrameTiming::Summary summary = timing.GetSummary();
+    CheckValue(static_cast<double>(summary.frameCount), static_cast<double>(capacity), "Frame count of a full ring");
+    CheckValue(static_cast<double>(summary.missedFrameCount), 0.0, "Missed frame count after the missed frames left the ring");
+    CheckValue(summary.predictedDisplayTimeDeltaMs.p99, 10.0, "p99 after the long frames left the ring");
+}
+
+int main() {
+    TestPercentiles();
+    TestMissedFrames();
+    TestRing();
+    std::cout << "FrameTiming: " << checkCount - failureCount << " of " << checkCount << " checks passed." << std::endl;
+    return failureCount == 0 ? 0 : 1;
+}
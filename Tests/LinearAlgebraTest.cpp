@@ -0,0 +1,453 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+// Checks the SSE or NEON functions of xr_linear_algebra.h, including the _Batch functions, against their _Scalar
+// references, on random and edge inputs, and prints how long each version takes. Returns non-zero if any result differs.
+
+#include <GraphicsAPI.h>
+#include <xr_linear_algebra.h>
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+#if defined(XR_LINEAR_SSE)
+static const char *simdName = "SSE";
+#elif defined(XR_LINEAR_NEON)
+static const char *simdName = "NEON";
+#else
+static const char *simdName = "none";
+#endif
+
+static const float infinity = std::numeric_limits<float>::infinity();
+static const float notANumber = std::numeric_limits<float>::quiet_NaN();
+static const float denormal = std::numeric_limits<float>::denorm_min();
+static const float large = 1.0e30f;  // Its square overflows.
+
+static size_t checkCount = 0;
+static size_t failureCount = 0;
+
+// Equal bit for bit, or both NaN, whose payloads depend on the order of the operands. With ignoreZeroSign, 0.0f and -0.0f are equal too.
+static bool FloatsMatch(float a, float b, bool ignoreZeroSign) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    if (ignoreZeroSign && a == 0.0f && b == 0.0f) {
+        return true;
+    }
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static void Check(const char *name, size_t inputIndex, const float *simd, const float *scalar, size_t count, bool ignoreZeroSign) {
+    checkCount++;
+    for (size_t i = 0; i < count; i++) {
+        if (!FloatsMatch(simd[i], scalar[i], ignoreZeroSign)) {
+            if (failureCount < 20) {
+                std::cout << "ERROR: " << name << " of input " << inputIndex << ": element " << i << " is " << std::setprecision(9) << simd[i]
+                          << " but the scalar reference is " << scalar[i] << std::endl;
+            }
+            failureCount++;
+            return;
+        }
+    }
+}
+
+// Runs 'function' 'iterations' times and returns the average time in nanoseconds.
+template <typename Function>
+static double Time(size_t iterations, Function function) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        function(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+static void PrintTiming(const char *name, double simdNs, double scalarNs) {
+    std::cout << "  " << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << simdNs << " ns  " << std::setw(8) << scalarNs << " ns  x" << scalarNs / simdNs << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+static XrQuaternionf CreateRotation(std::mt19937 &random) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const XrQuaternionf rotation = {unit(random), unit(random), unit(random), unit(random)};
+    const float lengthRcp = 1.0f / sqrtf(rotation.x * rotation.x + rotation.y * rotation.y + rotation.z * rotation.z + rotation.w * rotation.w);
+    return {rotation.x * lengthRcp, rotation.y * lengthRcp, rotation.z * lengthRcp, rotation.w * lengthRcp};
+}
+
+static XrMatrix4x4f Fill(float value) {
+    XrMatrix4x4f matrix;
+    for (float &m : matrix.m) {
+        m = value;
+    }
+    return matrix;
+}
+
+static XrMatrix4x4f CreateTranslationRotationScale(std::mt19937 &random, float translationRange, float scaleRange) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const XrQuaternionf rotation = CreateRotation(random);
+    const XrVector3f translation = {unit(random) * translationRange, unit(random) * translationRange, unit(random) * translationRange};
+    const XrVector3f scale = {unit(random) * scaleRange, unit(random) * scaleRange, unit(random) * scaleRange};
+    XrMatrix4x4f matrix;
+    XrMatrix4x4f_CreateTranslationRotationScale_Scalar(&matrix, &translation, &rotation, &scale);
+    return matrix;
+}
+
+// General matrices: zeros of both signs, infinities, NaNs, denormals, values whose products overflow, and random ones.
+static std::vector<XrMatrix4x4f> CreateMatrices(std::mt19937 &random, size_t randomCount) {
+    std::vector<XrMatrix4x4f> matrices;
+    XrMatrix4x4f identity;
+    XrMatrix4x4f_CreateIdentity(&identity);
+    matrices.push_back(identity);
+    for (float value : {0.0f, -0.0f, 1.0f, -1.0f, infinity, -infinity, notANumber, denormal, -denormal, large, -large}) {
+        matrices.push_back(Fill(value));
+    }
+    XrMatrix4x4f mixed = identity;
+    mixed.m[1] = -0.0f;
+    mixed.m[6] = denormal;
+    mixed.m[9] = large;
+    mixed.m[12] = infinity;
+    mixed.m[14] = notANumber;
+    matrices.push_back(mixed);
+
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+    for (size_t i = 0; i < randomCount; i++) {
+        XrMatrix4x4f matrix;
+        for (float &m : matrix.m) {
+            m = distribution(random);
+        }
+        matrices.push_back(matrix);
+    }
+    return matrices;
+}
+
+// Affine matrices, as XrMatrix4x4f_TransformBounds() and XrMatrix4x4f_InvertRigidBody() expect.
+static std::vector<XrMatrix4x4f> CreateAffineMatrices(std::mt19937 &random, size_t randomCount) {
+    std::vector<XrMatrix4x4f> matrices;
+    for (float value : {0.0f, -0.0f, 1.0f, infinity, notANumber, denormal, large}) {
+        XrMatrix4x4f matrix;
+        XrMatrix4x4f_CreateIdentity(&matrix);
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 3; row++) {
+                matrix.m[4 * column + row] = (column + row) % 2 ? -value : value;
+            }
+        }
+        matrices.push_back(matrix);
+    }
+    for (size_t i = 0; i < randomCount; i++) {
+        matrices.push_back(CreateTranslationRotationScale(random, 10.0f, i % 2 ? 1.0f : 4.0f));
+    }
+    return matrices;
+}
+
+static void TestMultiply(std::mt19937 &random) {
+    const std::vector<XrMatrix4x4f> matrices = CreateMatrices(random, 64);
+    size_t inputIndex = 0;
+    for (const XrMatrix4x4f &a : matrices) {
+        for (const XrMatrix4x4f &b : matrices) {
+            XrMatrix4x4f simd;
+            XrMatrix4x4f scalar;
+            XrMatrix4x4f_Multiply(&simd, &a, &b);
+            XrMatrix4x4f_Multiply_Scalar(&scalar, &a, &b);
+            Check("XrMatrix4x4f_Multiply", inputIndex, simd.m, scalar.m, 16, false);
+            inputIndex++;
+        }
+    }
+}
+
+static void TestInvertRigidBody(std::mt19937 &random) {
+    std::vector<XrMatrix4x4f> matrices = CreateAffineMatrices(random, 0);
+    for (size_t i = 0; i < 256; i++) {
+        matrices.push_back(CreateTranslationRotationScale(random, i % 2 ? 1.0f : 1000.0f, 1.0f));
+    }
+    for (size_t inputIndex = 0; inputIndex < matrices.size(); inputIndex++) {
+        XrMatrix4x4f simd;
+        XrMatrix4x4f scalar;
+        XrMatrix4x4f_InvertRigidBody(&simd, &matrices[inputIndex]);
+        XrMatrix4x4f_InvertRigidBody_Scalar(&scalar, &matrices[inputIndex]);
+        Check("XrMatrix4x4f_InvertRigidBody", inputIndex, simd.m, scalar.m, 16, false);
+    }
+}
+
+static void TestCreateTranslationRotationScale(std::mt19937 &random) {
+    // Only finite inputs: the scalar version multiplies the rotation, translation and scale by the zeros of the other
+    // matrices, and an infinity or NaN times zero makes NaNs where the SIMD version does not.
+    std::vector<XrQuaternionf> rotations = {{0.0f, 0.0f, 0.0f, 1.0f},   {0.0f, 0.0f, 0.0f, -1.0f},        {1.0f, 0.0f, 0.0f, 0.0f},
+                                            {0.0f, -1.0f, 0.0f, 0.0f},  {-0.0f, -0.0f, -0.0f, 1.0f},      {0.0f, 0.0f, 0.0f, 0.0f},
+                                            {2.0f, -3.0f, 0.5f, 1.0f},  {denormal, -denormal, 0.0f, 1.0f}};
+    std::vector<XrVector3f> vectors = {{0.0f, 0.0f, 0.0f},   {-0.0f, -0.0f, -0.0f},         {1.0f, 1.0f, 1.0f},
+                                       {-1.0f, 2.0f, -3.0f}, {denormal, -denormal, large}, {-large, 0.5f, -0.0f}};
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (size_t i = 0; i < 16; i++) {
+        rotations.push_back(CreateRotation(random));
+        vectors.push_back({unit(random) * 10.0f, unit(random) * 10.0f, unit(random) * 10.0f});
+    }
+
+    size_t inputIndex = 0;
+    for (const XrQuaternionf &rotation : rotations) {
+        for (const XrVector3f &translation : vectors) {
+            for (const XrVector3f &scale : vectors) {
+                XrMatrix4x4f simd;
+                XrMatrix4x4f scalar;
+                XrMatrix4x4f_CreateTranslationRotationScale(&simd, &translation, &rotation, &scale);
+                XrMatrix4x4f_CreateTranslationRotationScale_Scalar(&scalar, &translation, &rotation, &scale);
+                // The SIMD version skips multiplications by zero, which only change the sign of zeros.
+                Check("XrMatrix4x4f_CreateTranslationRotationScale", inputIndex, simd.m, scalar.m, 16, true);
+                inputIndex++;
+            }
+        }
+    }
+}
+
+static void TestTransformBounds(std::mt19937 &random) {
+    const std::vector<XrMatrix4x4f> matrices = CreateAffineMatrices(random, 64);
+    // Ordinary, empty, inside out, signed zero and infinite bounds.
+    const std::vector<std::pair<XrVector3f, XrVector3f>> bounds = {
+        {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}},      {{1.0f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f}},
+        {{0.5f, 0.5f, 0.5f}, {-0.5f, -0.5f, -0.5f}},      {{-0.0f, -0.0f, -0.0f}, {0.0f, 0.0f, 0.0f}},
+        {{-large, -1.0f, denormal}, {large, 1.0f, 1.0f}}, {{-infinity, 0.0f, 0.0f}, {infinity, 1.0f, 1.0f}}};
+
+    size_t inputIndex = 0;
+    for (const XrMatrix4x4f &matrix : matrices) {
+        for (const std::pair<XrVector3f, XrVector3f> &bound : bounds) {
+            XrVector3f simd[2];
+            XrVector3f scalar[2];
+            XrMatrix4x4f_TransformBounds(&simd[0], &simd[1], &matrix, &bound.first, &bound.second);
+            XrMatrix4x4f_TransformBounds_Scalar(&scalar[0], &scalar[1], &matrix, &bound.first, &bound.second);
+            Check("XrMatrix4x4f_TransformBounds mins", inputIndex, &simd[0].x, &scalar[0].x, 3, false);
+            Check("XrMatrix4x4f_TransformBounds maxs", inputIndex, &simd[1].x, &scalar[1].x, 3, false);
+            inputIndex++;
+        }
+    }
+}
+
+// Transforms in the separate arrays that the _Batch functions take.
+struct TransformArrays {
+    std::vector<float> values[10];
+    XrTransformArraysf arrays;
+
+    void Resize(size_t count) {
+        for (std::vector<float> &v : values) {
+            v.resize(count);
+        }
+        arrays = {{values[0].data(), values[1].data(), values[2].data()},
+                  {values[3].data(), values[4].data(), values[5].data(), values[6].data()},
+                  {values[7].data(), values[8].data(), values[9].data()}};
+    }
+    void Set(size_t index, const XrVector3f &translation, const XrQuaternionf &rotation, const XrVector3f &scale) {
+        const float transform[10] = {translation.x, translation.y, translation.z, rotation.x, rotation.y, rotation.z, rotation.w, scale.x, scale.y, scale.z};
+        for (size_t i = 0; i < 10; i++) {
+            values[i][index] = transform[i];
+        }
+    }
+    void Get(size_t index, XrVector3f &translation, XrQuaternionf &rotation, XrVector3f &scale) const {
+        translation = {values[0][index], values[1][index], values[2][index]};
+        rotation = {values[3][index], values[4][index], values[5][index], values[6][index]};
+        scale = {values[7][index], values[8][index], values[9][index]};
+    }
+};
+
+// Finite transforms only, as for XrMatrix4x4f_CreateTranslationRotationScale(). The first ones are edge cases.
+static TransformArrays CreateTransformArrays(std::mt19937 &random, size_t count) {
+    const XrQuaternionf edgeRotations[] = {{0.0f, 0.0f, 0.0f, 1.0f}, {-0.0f, -0.0f, -0.0f, -1.0f}, {0.0f, 0.0f, 0.0f, 0.0f}, {denormal, 0.0f, -denormal, 1.0f}};
+    const XrVector3f edgeVectors[] = {{0.0f, 0.0f, 0.0f}, {-0.0f, -0.0f, -0.0f}, {denormal, -denormal, large}, {-large, 1.0f, -0.0f}};
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    TransformArrays transforms;
+    transforms.Resize(count);
+    for (size_t i = 0; i < count; i++) {
+        if (i < 4) {
+            transforms.Set(i, edgeVectors[i], edgeRotations[i], edgeVectors[3 - i]);
+        } else {
+            transforms.Set(i, {unit(random) * 10.0f, unit(random) * 10.0f, unit(random) * 10.0f}, CreateRotation(random),
+                           {unit(random) * 2.0f, unit(random) * 2.0f, unit(random) * 2.0f});
+        }
+    }
+    return transforms;
+}
+
+// Results are written into a buffer of floats filled with a marker, so that writes outside of the strided results are caught.
+static const float marker = 12345.0f;
+
+static const XrMatrix4x4f *GetResult(const std::vector<float> &buffer, size_t resultStride, size_t index) {
+    return reinterpret_cast<const XrMatrix4x4f *>(reinterpret_cast<const char *>(buffer.data()) + index * (resultStride ? resultStride : sizeof(XrMatrix4x4f)));
+}
+
+static void CheckMarkers(const char *name, size_t inputIndex, const std::vector<float> &buffer, size_t resultStride, size_t resultCount) {
+    const size_t stride = resultStride ? resultStride : sizeof(XrMatrix4x4f);
+    for (size_t i = 0; i < buffer.size(); i++) {
+        const size_t byteOffset = i * sizeof(float);
+        const bool written = byteOffset < resultCount * stride && byteOffset % stride < sizeof(XrMatrix4x4f);
+        if (!written && buffer[i] != marker) {
+            checkCount++;
+            failureCount++;
+            std::cout << "ERROR: " << name << " of input " << inputIndex << " wrote outside of its results, at float " << i << std::endl;
+            return;
+        }
+    }
+}
+
+// The batches are checked against XrMatrix4x4f_CreateTranslationRotationScale_Scalar() and XrMatrix4x4f_Multiply_Scalar(),
+// with counts that are not multiples of four, packed and strided results, and one and two views.
+static void TestBatches(std::mt19937 &random) {
+    const size_t counts[] = {0, 1, 3, 4, 5, 7, 8, 13, 64};
+    const size_t resultStrides[] = {0, sizeof(XrMatrix4x4f), sizeof(XrMatrix4x4f) + 4 * sizeof(float)};
+    const std::vector<XrMatrix4x4f> viewProjs = CreateMatrices(random, 2);
+
+    size_t inputIndex = 0;
+    for (size_t count : counts) {
+        const TransformArrays transforms = CreateTransformArrays(random, count);
+        std::vector<XrMatrix4x4f> models(count);
+        for (size_t i = 0; i < count; i++) {
+            XrVector3f translation;
+            XrQuaternionf rotation;
+            XrVector3f scale;
+            transforms.Get(i, translation, rotation, scale);
+            XrMatrix4x4f_CreateTranslationRotationScale_Scalar(&models[i], &translation, &rotation, &scale);
+        }
+
+        for (size_t resultStride : resultStrides) {
+            const size_t stride = resultStride ? resultStride : sizeof(XrMatrix4x4f);
+            std::vector<float> buffer((count + 1) * stride / sizeof(float), marker);
+            XrMatrix4x4f_CreateTranslationRotationScale_Batch(reinterpret_cast<XrMatrix4x4f *>(buffer.data()), resultStride, &transforms.arrays, count);
+            for (size_t i = 0; i < count; i++) {
+                Check("XrMatrix4x4f_CreateTranslationRotationScale_Batch", inputIndex, GetResult(buffer, resultStride, i)->m, models[i].m, 16, true);
+            }
+            CheckMarkers("XrMatrix4x4f_CreateTranslationRotationScale_Batch", inputIndex, buffer, resultStride, count);
+            inputIndex++;
+
+            // The identity, then the last two random matrices as a stereo pair. The edge matrices with infinities and NaNs are
+            // left out for the same reason as in TestCreateTranslationRotationScale().
+            for (size_t viewCount : {1, 2}) {
+                const XrMatrix4x4f *views = viewCount == 1 ? &viewProjs.front() : &viewProjs[viewProjs.size() - 2];
+                std::vector<float> mvpBuffer((viewCount * count + 1) * stride / sizeof(float), marker);
+                XrMatrix4x4f_CreateModelViewProjection_Batch(reinterpret_cast<XrMatrix4x4f *>(mvpBuffer.data()), resultStride, views, viewCount,
+                                                             &transforms.arrays, count);
+                for (size_t v = 0; v < viewCount; v++) {
+                    for (size_t i = 0; i < count; i++) {
+                        XrMatrix4x4f mvp;
+                        XrMatrix4x4f_Multiply_Scalar(&mvp, &views[v], &models[i]);
+                        Check("XrMatrix4x4f_CreateModelViewProjection_Batch", inputIndex, GetResult(mvpBuffer, resultStride, v * count + i)->m, mvp.m, 16, true);
+                    }
+                }
+                CheckMarkers("XrMatrix4x4f_CreateModelViewProjection_Batch", inputIndex, mvpBuffer, resultStride, viewCount * count);
+                inputIndex++;
+            }
+        }
+    }
+}
+
+// Times each function over a rotating set of inputs. The results are summed so that the calls cannot be optimized away.
+static void TimeFunctions(std::mt19937 &random) {
+    const size_t iterations = 1 << 20;
+    const size_t inputMask = 255;
+    std::vector<XrMatrix4x4f> matrices;
+    std::vector<XrQuaternionf> rotations;
+    std::vector<XrVector3f> vectors;
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (size_t i = 0; i <= inputMask; i++) {
+        matrices.push_back(CreateTranslationRotationScale(random, 10.0f, 2.0f));
+        rotations.push_back(CreateRotation(random));
+        vectors.push_back({unit(random), unit(random), unit(random)});
+    }
+    float sum = 0.0f;
+    XrMatrix4x4f result;
+    XrVector3f mins;
+    XrVector3f maxs;
+
+    std::cout << "Average time per call, SIMD (" << simdName << ") and scalar:" << std::endl;
+    PrintTiming("XrMatrix4x4f_Multiply",
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_Multiply(&result, &matrices[i & inputMask], &matrices[(i + 1) & inputMask]);
+                    sum += result.m[i & 15];
+                }),
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_Multiply_Scalar(&result, &matrices[i & inputMask], &matrices[(i + 1) & inputMask]);
+                    sum += result.m[i & 15];
+                }));
+    PrintTiming("XrMatrix4x4f_InvertRigidBody",
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_InvertRigidBody(&result, &matrices[i & inputMask]);
+                    sum += result.m[i & 15];
+                }),
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_InvertRigidBody_Scalar(&result, &matrices[i & inputMask]);
+                    sum += result.m[i & 15];
+                }));
+    PrintTiming("XrMatrix4x4f_CreateTranslationRotationScale",
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_CreateTranslationRotationScale(&result, &vectors[i & inputMask], &rotations[i & inputMask], &vectors[(i + 1) & inputMask]);
+                    sum += result.m[i & 15];
+                }),
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_CreateTranslationRotationScale_Scalar(&result, &vectors[i & inputMask], &rotations[i & inputMask], &vectors[(i + 1) & inputMask]);
+                    sum += result.m[i & 15];
+                }));
+    PrintTiming("XrMatrix4x4f_TransformBounds",
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_TransformBounds(&mins, &maxs, &matrices[i & inputMask], &vectors[i & inputMask], &vectors[(i + 1) & inputMask]);
+                    sum += mins.x + maxs.y;
+                }),
+                Time(iterations, [&](size_t i) {
+                    XrMatrix4x4f_TransformBounds_Scalar(&mins, &maxs, &matrices[i & inputMask], &vectors[i & inputMask], &vectors[(i + 1) & inputMask]);
+                    sum += mins.x + maxs.y;
+                }));
+
+    // A batch, per transform, against building the same matrices one at a time with the scalar functions.
+    const size_t batchCount = 1024;
+    const TransformArrays transforms = CreateTransformArrays(random, batchCount);
+    std::vector<XrMatrix4x4f> results(2 * batchCount);
+    const size_t batchIterations = iterations / batchCount;
+    PrintTiming("XrMatrix4x4f_CreateTranslationRotationScale_Batch",
+                Time(batchIterations, [&](size_t i) {
+                    XrMatrix4x4f_CreateTranslationRotationScale_Batch(results.data(), 0, &transforms.arrays, batchCount);
+                    sum += results[i & (batchCount - 1)].m[i & 15];
+                }) / batchCount,
+                Time(batchIterations, [&](size_t i) {
+                    for (size_t t = 0; t < batchCount; t++) {
+                        XrVector3f translation;
+                        XrQuaternionf rotation;
+                        XrVector3f scale;
+                        transforms.Get(t, translation, rotation, scale);
+                        XrMatrix4x4f_CreateTranslationRotationScale_Scalar(&results[t], &translation, &rotation, &scale);
+                    }
+                    sum += results[i & (batchCount - 1)].m[i & 15];
+                }) / batchCount);
+    PrintTiming("XrMatrix4x4f_CreateModelViewProjection_Batch (2 views)",
+                Time(batchIterations, [&](size_t i) {
+                    XrMatrix4x4f_CreateModelViewProjection_Batch(results.data(), 0, matrices.data(), 2, &transforms.arrays, batchCount);
+                    sum += results[i & (2 * batchCount - 1)].m[i & 15];
+                }) / batchCount,
+                Time(batchIterations, [&](size_t i) {
+                    for (size_t t = 0; t < batchCount; t++) {
+                        XrVector3f translation;
+                        XrQuaternionf rotation;
+                        XrVector3f scale;
+                        transforms.Get(t, translation, rotation, scale);
+                        XrMatrix4x4f model;
+                        XrMatrix4x4f_CreateTranslationRotationScale_Scalar(&model, &translation, &rotation, &scale);
+                        XrMatrix4x4f_Multiply_Scalar(&results[t], &matrices[0], &model);
+                        XrMatrix4x4f_Multiply_Scalar(&results[batchCount + t], &matrices[1], &model);
+                    }
+                    sum += results[i & (2 * batchCount - 1)].m[i & 15];
+                }) / batchCount);
+    std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+int main() {
+    std::mt19937 random(1);
+
+    TestMultiply(random);
+    TestInvertRigidBody(random);
+    TestCreateTranslationRotationScale(random);
+    TestTransformBounds(random);
+    TestBatches(random);
+    std::cout << "SIMD (" << simdName << ") against scalar: " << checkCount - failureCount << " of " << checkCount << " checks passed." << std::endl;
+
+    TimeFunctions(random);
+    return failureCount == 0 ? 0 : 1;
+}
@@ -48,10 +48,13 @@ rem OPENGL
 tar -a -cf build\common_archs\Common_OpenGL.zip ^
     Common/GraphicsAPI.cpp ^
     Common/GraphicsAPI_OpenGL.cpp ^
+    Common/GraphicsAPI_OpenGL_Common.cpp ^
     Common/OpenXRDebugUtils.cpp ^
     Common/DebugOutput.h ^
+    Common/FileView.h ^
     Common/GraphicsAPI.h ^
     Common/GraphicsAPI_OpenGL.h ^
+    Common/GraphicsAPI_OpenGL_Common.h ^
     Common/HelperFunctions.h ^
     Common/OpenXRDebugUtils.h ^
     Common/OpenXRHelper.h
@@ -63,10 +66,13 @@ rem OPENGL_ES
 :OPENGL_ES
 tar -a -cf build\common_archs\Common_OpenGL_ES.zip ^
     Common/GraphicsAPI.cpp ^
+    Common/GraphicsAPI_OpenGL_Common.cpp ^
     Common/GraphicsAPI_OpenGL_ES.cpp ^
     Common/OpenXRDebugUtils.cpp ^
     Common/DebugOutput.h ^
+    Common/FileView.h ^
     Common/GraphicsAPI.h ^
+    Common/GraphicsAPI_OpenGL_Common.h ^
     Common/GraphicsAPI_OpenGL_ES.h ^
     Common/HelperFunctions.h ^
     Common/OpenXRDebugUtils.h ^
@@ -82,6 +88,7 @@ tar -a -cf build\common_archs\Common_Vulkan.zip ^
     Common/GraphicsAPI_Vulkan.cpp ^
     Common/OpenXRDebugUtils.cpp ^
     Common/DebugOutput.h ^
+    Common/FileView.h ^
     Common/GraphicsAPI.h ^
     Common/GraphicsAPI_Vulkan.h ^
     Common/HelperFunctions.h ^
@@ -98,14 +105,17 @@ tar -a -cf build\common_archs\Common.zip ^
     Common/GraphicsAPI_D3D11.cpp ^
     Common/GraphicsAPI_D3D12.cpp ^
     Common/GraphicsAPI_OpenGL.cpp ^
+    Common/GraphicsAPI_OpenGL_Common.cpp ^
     Common/GraphicsAPI_OpenGL_ES.cpp ^
     Common/GraphicsAPI_Vulkan.cpp ^
     Common/OpenXRDebugUtils.cpp ^
     Common/DebugOutput.h ^
+    Common/FileView.h ^
     Common/GraphicsAPI.h ^
     Common/GraphicsAPI_D3D11.h ^
     Common/GraphicsAPI_D3D12.h ^
     Common/GraphicsAPI_OpenGL.h ^
+    Common/GraphicsAPI_OpenGL_Common.h ^
     Common/GraphicsAPI_OpenGL_ES.h ^
     Common/GraphicsAPI_Vulkan.h ^
     Common/HelperFunctions.h ^
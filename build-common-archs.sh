@@ -39,10 +39,13 @@ do
         zip -r build/common_archs/Common_OpenGL.zip \
             Common/GraphicsAPI.cpp \
             Common/GraphicsAPI_OpenGL.cpp \
+            Common/GraphicsAPI_OpenGL_Common.cpp \
             Common/OpenXRDebugUtils.cpp \
             Common/DebugOutput.h \
+            Common/FileView.h \
             Common/GraphicsAPI.h \
             Common/GraphicsAPI_OpenGL.h \
+            Common/GraphicsAPI_OpenGL_Common.h \
             Common/HelperFunctions.h \
             Common/OpenXRDebugUtils.h \
             Common/OpenXRHelper.h
@@ -52,10 +55,13 @@ do
         echo "$api"
         zip -r build/common_archs/Common_OpenGL_ES.zip \
             Common/GraphicsAPI.cpp \
+            Common/GraphicsAPI_OpenGL_Common.cpp \
             Common/GraphicsAPI_OpenGL_ES.cpp \
             Common/OpenXRDebugUtils.cpp \
             Common/DebugOutput.h \
+            Common/FileView.h \
             Common/GraphicsAPI.h \
+            Common/GraphicsAPI_OpenGL_Common.h \
             Common/GraphicsAPI_OpenGL_ES.h \
             Common/HelperFunctions.h \
             Common/OpenXRDebugUtils.h \
@@ -69,6 +75,7 @@ do
             Common/GraphicsAPI_Vulkan.cpp \
             Common/OpenXRDebugUtils.cpp \
             Common/DebugOutput.h \
+            Common/FileView.h \
             Common/GraphicsAPI.h \
             Common/GraphicsAPI_Vulkan.h \
             Common/HelperFunctions.h \
@@ -84,14 +91,17 @@ zip -r build/common_archs/Common.zip \
     Common/GraphicsAPI_D3D11.cpp \
     Common/GraphicsAPI_D3D12.cpp \
     Common/GraphicsAPI_OpenGL.cpp \
+    Common/GraphicsAPI_OpenGL_Common.cpp \
     Common/GraphicsAPI_OpenGL_ES.cpp \
     Common/GraphicsAPI_Vulkan.cpp \
     Common/OpenXRDebugUtils.cpp \
     Common/DebugOutput.h \
+    Common/FileView.h \
     Common/GraphicsAPI.h \
     Common/GraphicsAPI_D3D11.h \
     Common/GraphicsAPI_D3D12.h \
     Common/GraphicsAPI_OpenGL.h \
+    Common/GraphicsAPI_OpenGL_Common.h \
     Common/GraphicsAPI_OpenGL_ES.h \
     Common/GraphicsAPI_Vulkan.h \
     Common/HelperFunctions.h \